@@ -0,0 +1,583 @@
+/*
+ * File: concurrentqueue.h
+ * -----------------------
+ * This file exports the <code>SPSCQueue</code> and <code>MPMCQueue</code>
+ * classes, bounded queues that threads can share without a lock.
+ */
+
+#ifndef _concurrentqueue_h
+#define _concurrentqueue_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "vector.h"
+
+extern void error(std::string msg);
+
+/*
+ * The queue classes share these declarations, which are part of the
+ * implementation and should not be used by clients.
+ */
+
+namespace internal {
+
+const int CACHE_LINE_SIZE = 64; /* Alignment that keeps the indices apart */
+
+inline size_t ringCapacity(int capacity, const char* prefix);
+
+}
+
+/*
+ * Class: SPSCQueue<ValueType>
+ * ---------------------------
+ * This class is a bounded first-in/first-out queue for exactly one
+ * producer thread, which calls the enqueue methods, and one consumer
+ * thread, which calls the dequeue methods and <code>peek</code>.  Neither
+ * thread ever waits for a lock: each side writes only its own index and
+ * publishes it with a single atomic store.
+ */
+
+template <typename ValueType>
+class SPSCQueue {
+public:
+    /*
+     * Constructor: SPSCQueue
+     * Usage: SPSCQueue<ValueType> queue(capacity);
+     * --------------------------------------------
+     * Initializes a new empty queue that can hold at least
+     * <code>capacity</code> values.  The capacity is rounded up to a
+     * power of two.
+     */
+
+    explicit SPSCQueue(int capacity);
+
+    /*
+     * Destructor: ~SPSCQueue
+     * ----------------------
+     * Frees the storage of the queue.  No other thread may be using the
+     * queue at this point.
+     */
+
+    virtual ~SPSCQueue();
+
+    /*
+     * Method: capacity
+     * Usage: int n = queue.capacity();
+     * --------------------------------
+     * Returns the number of values the queue can hold.
+     */
+
+    int capacity() const;
+
+    /*
+     * Methods: size, isEmpty
+     * Usage: int n = queue.size();
+     * ----------------------------
+     * Return the number of values in the queue, or whether there are
+     * none.  When the other thread is active, the answer may be out of
+     * date by the time the caller sees it.
+     */
+
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * Methods: enqueue, tryEnqueue
+     * Usage: queue.enqueue(value);
+     *        if (queue.tryEnqueue(value)) ...
+     * ---------------------------------------
+     * Adds <code>value</code> to the end of the queue.  If the queue is
+     * full, <code>enqueue</code> yields the processor until there is room,
+     * while <code>tryEnqueue</code> returns <code>false</code> and leaves
+     * <code>value</code> unchanged.  These methods may be called only from
+     * the producer thread.
+     */
+
+    void enqueue(ValueType value);
+    bool tryEnqueue(const ValueType& value);
+    bool tryEnqueue(ValueType&& value);
+
+    /*
+     * Method: enqueueN
+     * Usage: int n = queue.enqueueN(first, last);
+     * -------------------------------------------
+     * Adds as many values from the start of the range as there is room
+     * for, and returns how many were added.  The whole batch becomes
+     * visible to the consumer at once.
+     */
+
+    template <typename IteratorType>
+    int enqueueN(IteratorType first, IteratorType last);
+
+    /*
+     * Methods: dequeue, tryDequeue
+     * Usage: ValueType first = queue.dequeue();
+     *        if (queue.tryDequeue(value)) ...
+     * ---------------------------------------
+     * Remove the first value in the queue.  If the queue is empty,
+     * <code>dequeue</code> yields the processor until a value arrives,
+     * while <code>tryDequeue</code> returns <code>false</code>.  These
+     * methods may be called only from the consumer thread.
+     */
+
+    ValueType dequeue();
+    bool tryDequeue(ValueType& value);
+
+    /*
+     * Method: dequeueN
+     * Usage: int n = queue.dequeueN(values, n);
+     * -----------------------------------------
+     * Removes up to <code>n</code> values from the queue, appends them to
+     * <code>values</code>, and returns how many were removed.
+     */
+
+    int dequeueN(Vector<ValueType>& values, int n);
+
+    /*
+     * Method: peek
+     * Usage: ValueType first = queue.peek();
+     * --------------------------------------
+     * Returns the first value in the queue, without removing it.  It is
+     * an error to call <code>peek</code> on an empty queue.  This method
+     * may be called only from the consumer thread.
+     */
+
+    ValueType peek() const;
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: SPSCQueue data structure
+     * ----------------------------------------------
+     * The queue is a ring buffer whose size is a power of two.  The head
+     * and tail are counters that only increase; the slot for a counter is
+     * found by masking it, and tail - head is always the number of values
+     * in the queue.  The producer writes a slot and then publishes it with
+     * a release store to tail; the consumer acquires tail before reading
+     * the slot, and publishes the slot's release back to the producer the
+     * same way through head.  Each side also keeps a private copy of the
+     * other side's index and reloads it only when the copy says the queue
+     * is full or empty, so in the common case neither side touches the
+     * other's cache line at all.
+     */
+
+private:
+    /* Instance variables */
+
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<size_t> tail; /* Written by the producer */
+    size_t cachedHead;                                           /* Producer's copy of head */
+
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<size_t> head; /* Written by the consumer */
+    size_t cachedTail;                                           /* Consumer's copy of tail */
+
+    alignas(internal::CACHE_LINE_SIZE) ValueType* buffer;        /* Ring of slots           */
+    size_t mask;                                                 /* Capacity minus one      */
+
+    /* Private methods */
+
+    size_t roomFor(size_t t, size_t n);
+    size_t available(size_t h, size_t n);
+
+public:
+    /*
+     * Copying support
+     * ---------------
+     * Threads share a queue through a reference or pointer, so a
+     * concurrent queue cannot be copied or moved.
+     */
+
+    SPSCQueue(const SPSCQueue& src) = delete;
+    SPSCQueue& operator=(const SPSCQueue& src) = delete;
+};
+
+/*
+ * Class: MPMCQueue<ValueType>
+ * ---------------------------
+ * This class is a bounded first-in/first-out queue that any number of
+ * threads may enqueue into and dequeue from at the same time.  It
+ * exports the same methods as <code>SPSCQueue</code>, except for
+ * <code>peek</code>, whose answer would be meaningless while other
+ * consumers are running.  Threads that contend for the same end of the
+ * queue retry a compare-and-swap instead of waiting for a lock, so a
+ * thread that is descheduled never blocks the others.
+ */
+
+template <typename ValueType>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(int capacity);
+    virtual ~MPMCQueue();
+
+    int capacity() const;
+    int size() const;
+    bool isEmpty() const;
+
+    void enqueue(ValueType value);
+    bool tryEnqueue(const ValueType& value);
+    bool tryEnqueue(ValueType&& value);
+
+    template <typename IteratorType>
+    int enqueueN(IteratorType first, IteratorType last);
+
+    ValueType dequeue();
+    bool tryDequeue(ValueType& value);
+    int dequeueN(Vector<ValueType>& values, int n);
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: MPMCQueue data structure
+     * ----------------------------------------------
+     * The queue is Dmitry Vyukov's bounded MPMC ring.  Every cell carries
+     * a sequence number that says whose turn it is: a cell at position
+     * pos is ready for the producer that claims pos when its sequence is
+     * pos, and ready for the consumer that claims pos when its sequence is
+     * pos + 1.  A thread claims a position by advancing the shared counter
+     * with a compare-and-swap, works on the cell without any further
+     * synchronization, and then hands the cell on by storing the next
+     * sequence number with release semantics.  The batch methods claim
+     * one position at a time, since a block of cells may be at different
+     * stages for different threads.
+     */
+
+private:
+    /* Type used for each cell */
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        ValueType value;
+    };
+
+    /* Instance variables */
+
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos; /* Next position to fill  */
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<size_t> dequeuePos; /* Next position to empty */
+    alignas(internal::CACHE_LINE_SIZE) Cell* cells;                    /* Ring of cells          */
+    size_t mask;                                                       /* Capacity minus one     */
+
+    /* Private methods */
+
+    template <typename V>
+    bool push(V&& value);
+
+public:
+    MPMCQueue(const MPMCQueue& src) = delete;
+    MPMCQueue& operator=(const MPMCQueue& src) = delete;
+};
+
+/*
+ * Implementation notes: ringCapacity
+ * ----------------------------------
+ * Returns the smallest power of two that is at least the requested
+ * capacity and at least 2, reporting an error that begins with the name
+ * of the queue class for a capacity that is not positive or too large
+ * to round up.
+ */
+
+inline size_t internal::ringCapacity(int capacity, const char* prefix) {
+    if (capacity <= 0 || capacity > (1 << 30))
+        error(std::string(prefix) + ": Capacity must be between 1 and 2^30");
+    size_t size = 2;
+    while (size < size_t(capacity)) {
+        size *= 2;
+    }
+    return size;
+}
+
+template <typename ValueType>
+SPSCQueue<ValueType>::SPSCQueue(int capacity)
+    : tail(0), cachedHead(0), head(0), cachedTail(0) {
+    size_t size = internal::ringCapacity(capacity, "SPSCQueue");
+    buffer = new ValueType[size];
+    mask = size - 1;
+}
+
+template <typename ValueType>
+SPSCQueue<ValueType>::~SPSCQueue() {
+    delete[] buffer;
+}
+
+template <typename ValueType>
+int SPSCQueue<ValueType>::capacity() const {
+    return int(mask + 1);
+}
+
+template <typename ValueType>
+int SPSCQueue<ValueType>::size() const {
+    size_t h = head.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_acquire);
+    size_t n = t - h;
+    return int((n > mask + 1) ? mask + 1 : n);
+}
+
+template <typename ValueType>
+bool SPSCQueue<ValueType>::isEmpty() const {
+    return size() == 0;
+}
+
+/*
+ * Implementation notes: roomFor, available
+ * ----------------------------------------
+ * These methods return how many of n slots the producer may fill, or
+ * the consumer may empty, starting at its own index.  They reload the
+ * other thread's index only if the cached copy does not already allow
+ * all n.
+ */
+
+template <typename ValueType>
+size_t SPSCQueue<ValueType>::roomFor(size_t t, size_t n) {
+    size_t size = mask + 1;
+    if (size - (t - cachedHead) < n)
+        cachedHead = head.load(std::memory_order_acquire);
+    size_t room = size - (t - cachedHead);
+    return (room < n) ? room : n;
+}
+
+template <typename ValueType>
+size_t SPSCQueue<ValueType>::available(size_t h, size_t n) {
+    if (cachedTail - h < n)
+        cachedTail = tail.load(std::memory_order_acquire);
+    size_t ready = cachedTail - h;
+    return (ready < n) ? ready : n;
+}
+
+template <typename ValueType>
+void SPSCQueue<ValueType>::enqueue(ValueType value) {
+    while (!tryEnqueue(std::move(value))) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename ValueType>
+bool SPSCQueue<ValueType>::tryEnqueue(const ValueType& value) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (roomFor(t, 1) == 0)
+        return false;
+    buffer[t & mask] = value;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename ValueType>
+bool SPSCQueue<ValueType>::tryEnqueue(ValueType&& value) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (roomFor(t, 1) == 0)
+        return false;
+    buffer[t & mask] = std::move(value);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename ValueType>
+template <typename IteratorType>
+int SPSCQueue<ValueType>::enqueueN(IteratorType first, IteratorType last) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t room = roomFor(t, mask + 1);
+    size_t n = 0;
+    for (; n < room && first != last; ++first) {
+        buffer[(t + n++) & mask] = *first;
+    }
+    tail.store(t + n, std::memory_order_release);
+    return int(n);
+}
+
+template <typename ValueType>
+ValueType SPSCQueue<ValueType>::dequeue() {
+    ValueType value;
+    while (!tryDequeue(value)) {
+        std::this_thread::yield();
+    }
+    return value;
+}
+
+template <typename ValueType>
+bool SPSCQueue<ValueType>::tryDequeue(ValueType& value) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (available(h, 1) == 0)
+        return false;
+    value = std::move(buffer[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename ValueType>
+int SPSCQueue<ValueType>::dequeueN(Vector<ValueType>& values, int n) {
+    if (n <= 0)
+        return 0;
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t ready = available(h, size_t(n));
+    values.reserve(values.size() + int(ready));
+    for (size_t i = 0; i < ready; i++) {
+        values.add(std::move(buffer[(h + i) & mask]));
+    }
+    head.store(h + ready, std::memory_order_release);
+    return int(ready);
+}
+
+template <typename ValueType>
+ValueType SPSCQueue<ValueType>::peek() const {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (tail.load(std::memory_order_acquire) == h)
+        error("peek: Attempting to peek at an empty queue");
+    return buffer[h & mask];
+}
+
+template <typename ValueType>
+MPMCQueue<ValueType>::MPMCQueue(int capacity) : enqueuePos(0), dequeuePos(0) {
+    size_t size = internal::ringCapacity(capacity, "MPMCQueue");
+    cells = new Cell[size];
+    for (size_t i = 0; i < size; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = size - 1;
+}
+
+template <typename ValueType>
+MPMCQueue<ValueType>::~MPMCQueue() {
+    delete[] cells;
+}
+
+template <typename ValueType>
+int MPMCQueue<ValueType>::capacity() const {
+    return int(mask + 1);
+}
+
+template <typename ValueType>
+int MPMCQueue<ValueType>::size() const {
+    size_t d = dequeuePos.load(std::memory_order_acquire);
+    size_t e = enqueuePos.load(std::memory_order_acquire);
+    size_t n = e - d;
+    return int((n > mask + 1) ? mask + 1 : n);
+}
+
+template <typename ValueType>
+bool MPMCQueue<ValueType>::isEmpty() const {
+    return size() == 0;
+}
+
+/*
+ * Implementation notes: push
+ * --------------------------
+ * A sequence number equal to pos means the cell is free for this lap,
+ * one that is smaller means the consumer of the previous lap has not
+ * finished with it, so the queue is full, and one that is larger means
+ * another producer already claimed pos, so the position is reloaded.
+ * The value is only moved from once the claim succeeds.
+ */
+
+template <typename ValueType>
+template <typename V>
+bool MPMCQueue<ValueType>::push(V&& value) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = std::forward<V>(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename ValueType>
+void MPMCQueue<ValueType>::enqueue(ValueType value) {
+    while (!push(std::move(value))) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename ValueType>
+bool MPMCQueue<ValueType>::tryEnqueue(const ValueType& value) {
+    return push(value);
+}
+
+template <typename ValueType>
+bool MPMCQueue<ValueType>::tryEnqueue(ValueType&& value) {
+    return push(std::move(value));
+}
+
+template <typename ValueType>
+template <typename IteratorType>
+int MPMCQueue<ValueType>::enqueueN(IteratorType first, IteratorType last) {
+    int n = 0;
+    for (; first != last && push(*first); ++first) {
+        n++;
+    }
+    return n;
+}
+
+template <typename ValueType>
+ValueType MPMCQueue<ValueType>::dequeue() {
+    ValueType value;
+    while (!tryDequeue(value)) {
+        std::this_thread::yield();
+    }
+    return value;
+}
+
+/*
+ * Implementation notes: tryDequeue
+ * --------------------------------
+ * This method mirrors push: a cell at position pos holds a value for
+ * this lap when its sequence number is pos + 1.  Releasing the cell sets
+ * its sequence to the position it will have on the producers' next lap.
+ */
+
+template <typename ValueType>
+bool MPMCQueue<ValueType>::tryDequeue(ValueType& value) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    value = std::move(cell->value);
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename ValueType>
+int MPMCQueue<ValueType>::dequeueN(Vector<ValueType>& values, int n) {
+    int count = 0;
+    ValueType value;
+    while (count < n && tryDequeue(value)) {
+        values.add(std::move(value));
+        count++;
+    }
+    return count;
+}
+
+#endif  // _concurrentqueue_h
@@ -19,6 +19,7 @@
 
 #include <set>
 #include <string>
+#include <string_view>
 
 #include "set.h"
 #include "stack.h"
@@ -116,9 +117,11 @@ public:
      * ----------------------------------
      * Returns <code>true</code> if <code>word</code> is contained in the
      * lexicon.  In the <code>DawgLexicon</code> class, the case of letters is
-     * ignored, so "Zoo" is the same as "ZOO" or "zoo".
+     * ignored, so "Zoo" is the same as "ZOO" or "zoo".  The word may be
+     * passed as a <code>string</code>, a <code>string_view</code>, or a
+     * C string.
      */
-    bool contains(const std::string& word) const;
+    bool contains(std::string_view word) const;
 
     /*
      * Method: containsPrefix
@@ -128,7 +131,7 @@ public:
      * Like <code>containsWord</code>, this method ignores the case of letters
      * so that "MO" is a prefix of "monkey" or "Monday".
      */
-    bool containsPrefix(const std::string& prefix) const;
+    bool containsPrefix(std::string_view prefix) const;
 
     /*
      * Method: equals
@@ -276,6 +279,15 @@ public:
     DawgLexicon(const DawgLexicon& src);
     DawgLexicon& operator=(const DawgLexicon& src);
 
+    /*
+     * Move support
+     * ------------
+     * Moving a lexicon transfers its edge array and word set without
+     * copying them, and leaves the source lexicon empty.
+     */
+    DawgLexicon(DawgLexicon&& src);
+    DawgLexicon& operator=(DawgLexicon&& src);
+
     /*
      * Iterator support
      * ----------------
@@ -297,7 +309,7 @@ public:
         std::string currentSetWord;
         std::string tmpWord;
         Edge* edgePtr;
-        Stack<Edge*> stack;
+        Stack<Edge*, 16> stack; /* Ancestors of edgePtr, one per letter */
         Set<std::string>::iterator setIterator;
         Set<std::string>::iterator setEnd;
 
@@ -398,7 +410,7 @@ public:
 
 private:
     Edge* findEdgeForChar(Edge* children, char ch) const;
-    Edge* traceToLastEdge(const std::string& s) const;
+    Edge* traceToLastEdge(std::string_view s) const;
     void readBinaryFile(const std::string& filename);
     void deepCopy(const DawgLexicon& src);
     int countDawgWords(Edge* start) const;
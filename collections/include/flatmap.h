@@ -0,0 +1,975 @@
+/*
+ * File: flatmap.h
+ * ---------------
+ * This file exports the template class <code>FlatMap</code>, which
+ * maintains a collection of <i>key</i>-<i>value</i> pairs in sorted
+ * arrays.  It is intended for maps that are built once and then read
+ * many times.
+ */
+
+#ifndef _flatmap_h
+#define _flatmap_h
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+
+#include "compare.h"
+#include "map.h"
+#include "transparentkey.h"
+#include "vector.h"
+
+/*
+ * Type: FlatValues<ValueType>
+ * ---------------------------
+ * The array of values in a FlatMap.  If the value type is an empty
+ * class, as it is for the map inside FlatSet, the second version is
+ * used, which stores nothing at all; as in MapNode, every element is the
+ * same shared object.
+ */
+
+template <typename ValueType,
+          bool noValue = std::is_empty<ValueType>::value &&
+                         std::is_default_constructible<ValueType>::value>
+class FlatValues {
+public:
+    ValueType& operator[](int index) {
+        return values[index];
+    }
+
+    const ValueType& operator[](int index) const {
+        return values[index];
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        values.emplace(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void emplaceAt(int index, Args&&... args) {
+        values.emplaceAt(index, std::forward<Args>(args)...);
+    }
+
+    void remove(int index) {
+        values.remove(index);
+    }
+
+    void reserve(int n) {
+        values.reserve(n);
+    }
+
+    void clear() {
+        values.clear();
+    }
+
+private:
+    Vector<ValueType> values;
+};
+
+template <typename ValueType>
+class FlatValues<ValueType, true> {
+public:
+    ValueType& operator[](int) {
+        return value;
+    }
+
+    const ValueType& operator[](int) const {
+        return value;
+    }
+
+    template <typename... Args>
+    void emplace(Args&&...) {
+        /* Empty */
+    }
+
+    template <typename... Args>
+    void emplaceAt(int, Args&&...) {
+        /* Empty */
+    }
+
+    void remove(int) {
+        /* Empty */
+    }
+
+    void reserve(int) {
+        /* Empty */
+    }
+
+    void clear() {
+        /* Empty */
+    }
+
+private:
+    static ValueType value;
+};
+
+template <typename ValueType>
+ValueType FlatValues<ValueType, true>::value;
+
+/*
+ * Class: FlatMap<KeyType,ValueType>
+ * ---------------------------------
+ * This class maintains an association between keys and values, just as
+ * <code>Map</code> does, and it exports the same interface and iterates
+ * in the same order.  The keys are kept in one sorted array and the
+ * values in a parallel array, so a lookup is a binary search over
+ * contiguous memory rather than a walk through separately allocated
+ * tree nodes.  The price is that <code>put</code> and <code>remove</code>
+ * must shift the entries that follow, which takes linear time.  The usual
+ * pattern is therefore to build a <code>Map</code> and then freeze it into
+ * a <code>FlatMap</code>.
+ */
+
+template <typename KeyType, typename ValueType>
+class FlatMap {
+public:
+    /*
+     * Constructor: FlatMap
+     * Usage: FlatMap<KeyType,ValueType> map;
+     * --------------------------------------
+     * Initializes a new empty map that associates keys and values of the
+     * specified types.  Entries in an initializer list may come in any
+     * order; if a key appears more than once, the last value wins.
+     */
+
+    FlatMap();
+    FlatMap(std::initializer_list<std::pair<KeyType, ValueType>> list);
+
+    /*
+     * Constructor: FlatMap
+     * Usage: FlatMap<KeyType,ValueType> flat(map);
+     * --------------------------------------------
+     * Freezes a <code>Map</code> into a <code>FlatMap</code> that has the
+     * same entries and the same comparison function.  The map already
+     * holds its keys in order, so the conversion takes linear time and
+     * does no comparisons.  If the map is an rvalue, its keys and values
+     * are moved rather than copied, and the map is left empty.
+     */
+
+    explicit FlatMap(const Map<KeyType, ValueType>& map);
+    explicit FlatMap(Map<KeyType, ValueType>&& map);
+
+    /*
+     * Destructor: ~FlatMap
+     * --------------------
+     * Frees any heap storage associated with this map.
+     */
+
+    virtual ~FlatMap();
+
+    /*
+     * Method: size
+     * Usage: int nEntries = map.size();
+     * ---------------------------------
+     * Returns the number of entries in this map.
+     */
+
+    int size() const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (map.isEmpty()) ...
+     * -----------------------------
+     * Returns <code>true</code> if this map contains no entries.
+     */
+
+    bool isEmpty() const;
+
+    /*
+     * Method: put
+     * Usage: map.put(key, value);
+     * ---------------------------
+     * Associates <code>key</code> with <code>value</code> in this map,
+     * replacing any previous value.  Adding a new key shifts the entries
+     * after it and therefore takes linear time.
+     */
+
+    void put(const KeyType& key, const ValueType& value);
+    void put(const KeyType& key, ValueType&& value);
+
+    /*
+     * Method: tryEmplace
+     * Usage: if (map.tryEmplace(key, args...)) ...
+     * --------------------------------------------
+     * Adds an entry for <code>key</code> whose value is constructed from
+     * the remaining arguments, provided that <code>key</code> is not
+     * already present, and returns <code>true</code> if it does so.
+     */
+
+    template <typename... Args>
+    bool tryEmplace(const KeyType& key, Args&&... args);
+
+    /*
+     * Method: get
+     * Usage: ValueType value = map.get(key);
+     * --------------------------------------
+     * Returns the value associated with <code>key</code> in this map.
+     * If <code>key</code> is not found, <code>get</code> returns the
+     * default value for <code>ValueType</code>.
+     */
+
+    ValueType get(const KeyType& key) const;
+    template <typename K>
+    EnableIfTransparent<KeyType, K, ValueType> get(const K& key) const;
+
+    /*
+     * Method: containsKey
+     * Usage: if (map.containsKey(key)) ...
+     * ------------------------------------
+     * Returns <code>true</code> if there is an entry for <code>key</code>
+     * in this map.
+     */
+
+    bool containsKey(const KeyType& key) const;
+    template <typename K>
+    EnableIfTransparent<KeyType, K, bool> containsKey(const K& key) const;
+
+    /*
+     * Method: remove
+     * Usage: map.remove(key);
+     * -----------------------
+     * Removes any entry for <code>key</code> from this map.
+     */
+
+    void remove(const KeyType& key);
+    template <typename K>
+    EnableIfTransparent<KeyType, K, void> remove(const K& key);
+
+    /*
+     * Method: clear
+     * Usage: map.clear();
+     * -------------------
+     * Removes all entries from this map.
+     */
+
+    void clear();
+
+    /*
+     * Method: reserve
+     * Usage: map.reserve(n);
+     * ----------------------
+     * Makes room for at least <code>n</code> entries, so that a map that
+     * is filled in ascending key order never has to grow its arrays.
+     */
+
+    void reserve(int n);
+
+    /*
+     * Operator: []
+     * Usage: map[key]
+     * ---------------
+     * Selects the value associated with <code>key</code>.  If the key is
+     * not present in the map, a new entry is created whose value is set
+     * to the default for the value type.
+     */
+
+    ValueType& operator[](const KeyType& key);
+    ValueType operator[](const KeyType& key) const;
+
+    /*
+     * Operators: ==, !=
+     * Usage: if (map1 == map2) ...
+     * ----------------------------
+     * Compares two maps for equality, which requires that they have
+     * equal keys and that the corresponding values are equal.
+     */
+
+    bool operator==(const FlatMap& map2) const;
+    bool operator!=(const FlatMap& map2) const;
+
+    /*
+     * Operators: <, <=, >, >=
+     * Usage: if (map1 < map2) ...
+     * ---------------------------
+     * Relational operators to compare two maps entry by entry.  These
+     * operators require that the ValueType has a < operator.
+     */
+
+    bool operator<(const FlatMap& map2) const;
+    bool operator<=(const FlatMap& map2) const;
+    bool operator>(const FlatMap& map2) const;
+    bool operator>=(const FlatMap& map2) const;
+
+    /*
+     * Method: toString
+     * Usage: string str = map.toString();
+     * -----------------------------------
+     * Converts the map to a printable string representation.
+     */
+
+    std::string toString();
+
+    /*
+     * Method: mapAll
+     * Usage: map.mapAll(fn);
+     * ----------------------
+     * Iterates through the map entries and calls <code>fn(key, value)</code>
+     * for each one, in ascending order of the keys.
+     */
+
+    void mapAll(void (*fn)(KeyType, ValueType)) const;
+    void mapAll(void (*fn)(const KeyType&, const ValueType&)) const;
+
+    template <typename FunctorType>
+    void mapAll(FunctorType fn) const;
+
+    /*
+     * Methods: lowerBound, upperBound, floor, ceiling
+     * Usage: for (auto it = map.lowerBound(lo); it != map.upperBound(hi); ++it) ...
+     * -----------------------------------------------------------------------------
+     * These methods return iterators positioned in the same way as the
+     * corresponding methods of <code>Map</code>.  If there is no such key,
+     * the result is <code>end()</code>.
+     */
+
+    class iterator;
+
+    iterator lowerBound(const KeyType& key) const;
+    iterator upperBound(const KeyType& key) const;
+    iterator floor(const KeyType& key) const;
+    iterator ceiling(const KeyType& key) const;
+
+    /*
+     * Additional FlatMap operations
+     * -----------------------------
+     * In addition to the methods listed in this interface, the FlatMap
+     * class supports the following operations:
+     *
+     *   - Stream I/O using the << and >> operators
+     *   - Deep copying for the copy constructor and assignment operator
+     *   - Iteration using the range-based for statement and STL iterators,
+     *     in either direction using rbegin and rend
+     *   - Lookup by std::string_view or C string in a map whose keys are
+     *     strings, using get, containsKey, and remove (see transparentkey.h)
+     */
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes:
+     * ---------------------
+     * The map stores its keys in a Vector sorted by the comparator and its
+     * values in a parallel FlatValues array.  The comparator is the same
+     * type-erased Comparator that Map uses, which is what makes it possible
+     * to freeze a Map with a client comparator.  Since a call through the
+     * comparator is an indirect call, the map records whether it uses the
+     * default ordering and, if so, compares keys with < directly.
+     */
+
+private:
+    typedef typename Map<KeyType, ValueType>::Comparator Comparator;
+    typedef typename Map<KeyType, ValueType>::template TemplateComparator<std::less<KeyType>>
+        DefaultComparator;
+
+    /* Instance variables */
+
+    Vector<KeyType> keys;          /* Keys in ascending order         */
+    FlatValues<ValueType> values;  /* Values parallel to the keys     */
+    Comparator* cmpp;              /* Pointer to the comparator       */
+    bool defaultOrder;             /* True if the comparator is std::less */
+
+    /* Private methods */
+
+    void setComparator(Comparator* cmp) {
+        cmpp = cmp;
+        defaultOrder = cmp->isDefaultOrder();
+    }
+
+    /*
+     * Implementation notes: searchLower, searchUpper
+     * ----------------------------------------------
+     * These methods find the first key that is not less than key and the
+     * first key that is greater than key.  The search keeps a base pointer
+     * and a length and halves the length on every step regardless of the
+     * outcome of the comparison.  The only data-dependent operation is the
+     * choice of the new base, which the compiler can implement with a
+     * conditional move, so for simple keys the loop runs without any
+     * unpredictable branches and always makes ceil(log2 n) comparisons.
+     */
+
+    template <typename K, typename LessFn>
+    int searchLower(const K& key, LessFn lessThan) const {
+        int n = keys.size();
+        if (n == 0)
+            return 0;
+        const KeyType* first = &keys[0];
+        const KeyType* base = first;
+        while (n > 1) {
+            int half = n / 2;
+            base = lessThan(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        return int(base - first) + (lessThan(*base, key) ? 1 : 0);
+    }
+
+    template <typename K, typename LessFn>
+    int searchUpper(const K& key, LessFn lessThan) const {
+        int n = keys.size();
+        if (n == 0)
+            return 0;
+        const KeyType* first = &keys[0];
+        const KeyType* base = first;
+        while (n > 1) {
+            int half = n / 2;
+            base = lessThan(key, base[half]) ? base : base + half;
+            n -= half;
+        }
+        return int(base - first) + (lessThan(key, *base) ? 0 : 1);
+    }
+
+    /*
+     * Implementation notes: lowerIndex, upperIndex, findIndex
+     * -------------------------------------------------------
+     * These methods choose between the direct comparison and the
+     * comparator.  The findIndex method returns the index of the key, or
+     * -1 if it is absent.  A lookup key of a type other than KeyType can be
+     * compared directly only under the default ordering, so with a client
+     * comparator it is converted to KeyType once.
+     */
+
+    int lowerIndex(const KeyType& key) const {
+        if (defaultOrder)
+            return searchLower(key, [](const KeyType& k1, const KeyType& k2) { return k1 < k2; });
+        return searchLower(key, [this](const KeyType& k1, const KeyType& k2) {
+            return cmpp->lessThan(k1, k2);
+        });
+    }
+
+    int upperIndex(const KeyType& key) const {
+        if (defaultOrder)
+            return searchUpper(key, [](const KeyType& k1, const KeyType& k2) { return k1 < k2; });
+        return searchUpper(key, [this](const KeyType& k1, const KeyType& k2) {
+            return cmpp->lessThan(k1, k2);
+        });
+    }
+
+    int findIndex(const KeyType& key) const {
+        int index = lowerIndex(key);
+        if (index == keys.size() || compareKeys(key, keys[index]) != 0)
+            return -1;
+        return index;
+    }
+
+    template <typename K>
+    int findLookupKey(const K& key) const {
+        if (!defaultOrder)
+            return findIndex(KeyType(key));
+        int index = searchLower(key, [](const auto& k1, const auto& k2) { return k1 < k2; });
+        if (index == keys.size() || key < keys[index])
+            return -1;
+        return index;
+    }
+
+    /*
+     * Implementation notes: buildFrom(entries)
+     * ----------------------------------------
+     * Fills an empty map from a vector of entries in any order.  The
+     * entries are sorted by key through an index array, with ties broken
+     * by position, so that the last of several entries with the same key
+     * can be kept, just as a sequence of calls to put would keep it.
+     */
+
+    void buildFrom(Vector<std::pair<KeyType, ValueType>>& entries) {
+        int n = entries.size();
+        Vector<int> order;
+        order.reserve(n);
+        for (int i = 0; i < n; i++) {
+            order.add(i);
+        }
+        std::sort(order.begin(), order.end(), [this, &entries](int i1, int i2) {
+            int sign = compareKeys(entries[i1].first, entries[i2].first);
+            return sign < 0 || (sign == 0 && i1 < i2);
+        });
+        keys.reserve(n);
+        values.reserve(n);
+        for (int i = 0; i < n; i++) {
+            std::pair<KeyType, ValueType>& entry = entries[order[i]];
+            if (i + 1 < n && compareKeys(entry.first, entries[order[i + 1]].first) == 0)
+                continue;
+            keys.emplace(std::move(entry.first));
+            values.emplace(std::move(entry.second));
+        }
+    }
+
+    template <typename ValueType2>
+    friend class FlatSet;
+
+public:
+    /*
+     * Hidden features
+     * ---------------
+     * The remainder of this file consists of the code required to
+     * support deep copying and iteration.  Including these methods in
+     * the public portion of the interface would make that interface more
+     * difficult to understand for the average client.
+     */
+
+    /* Extended constructors */
+
+    template <typename CompareType>
+    explicit FlatMap(CompareType cmp) {
+        setComparator(new typename Map<KeyType, ValueType>::template TemplateComparator<CompareType>(cmp));
+    }
+
+    /*
+     * Implementation notes: compareKeys(k1, k2)
+     * -----------------------------------------
+     * Compares the keys k1 and k2 and returns an integer (-1, 0, or +1)
+     * depending on whether k1 < k2, k1 == k2, or k1 > k2, respectively.
+     */
+
+    int compareKeys(const KeyType& k1, const KeyType& k2) const {
+        if (defaultOrder)
+            return (k1 < k2) ? -1 : (k2 < k1) ? +1 : 0;
+        if (cmpp->lessThan(k1, k2))
+            return -1;
+        if (cmpp->lessThan(k2, k1))
+            return +1;
+        return 0;
+    }
+
+    /*
+     * Deep copying and moving support
+     * -------------------------------
+     * Copying a map copies its arrays and clones its comparator.  Moving
+     * a map moves its arrays; the source is left empty but keeps a usable
+     * comparator.
+     */
+
+    FlatMap(const FlatMap& src) : keys(src.keys), values(src.values) {
+        setComparator(src.cmpp->clone());
+    }
+
+    FlatMap(FlatMap&& src) : keys(std::move(src.keys)), values(std::move(src.values)) {
+        setComparator(src.cmpp->clone());
+        src.values.clear();
+    }
+
+    FlatMap& operator=(const FlatMap& src) {
+        if (this != &src) {
+            keys = src.keys;
+            values = src.values;
+            delete cmpp;
+            setComparator(src.cmpp->clone());
+        }
+        return *this;
+    }
+
+    FlatMap& operator=(FlatMap&& src) {
+        if (this != &src) {
+            std::swap(keys, src.keys);
+            std::swap(values, src.values);
+            std::swap(cmpp, src.cmpp);
+            std::swap(defaultOrder, src.defaultOrder);
+            src.clear();
+        }
+        return *this;
+    }
+
+    /*
+     * Iterator support
+     * ----------------
+     * The iterator holds an index into the key array.  It is
+     * bidirectional, like the iterator for Map, and rbegin and rend
+     * return std::reverse_iterator adapters.
+     */
+
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = KeyType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const KeyType*;
+        using reference = const KeyType&;
+
+        iterator() : mp(nullptr), index(0) {
+            /* Empty */
+        }
+
+        iterator(const FlatMap* mp, int index) : mp(mp), index(index) {
+            /* Empty */
+        }
+
+        iterator& operator++() {
+            index++;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator copy(*this);
+            operator++();
+            return copy;
+        }
+
+        iterator& operator--() {
+            index--;
+            return *this;
+        }
+
+        iterator operator--(int) {
+            iterator copy(*this);
+            operator--();
+            return copy;
+        }
+
+        bool operator==(const iterator& rhs) const {
+            return mp == rhs.mp && index == rhs.index;
+        }
+
+        bool operator!=(const iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+        const KeyType& operator*() const {
+            return mp->keys[index];
+        }
+
+        const KeyType* operator->() const {
+            return &mp->keys[index];
+        }
+
+    private:
+        const FlatMap* mp; /* Pointer to the map      */
+        int index;         /* Index of the current key */
+    };
+
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+
+    iterator begin() const {
+        return iterator(this, 0);
+    }
+
+    iterator end() const {
+        return iterator(this, keys.size());
+    }
+
+    reverse_iterator rbegin() const {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() const {
+        return reverse_iterator(begin());
+    }
+
+    template <typename K, typename V>
+    friend std::ostream& operator<<(std::ostream& os, const FlatMap<K, V>& map);
+    template <typename K, typename V>
+    friend std::istream& operator>>(std::istream& is, FlatMap<K, V>& map);
+};
+
+template <typename KeyType, typename ValueType>
+FlatMap<KeyType, ValueType>::FlatMap() {
+    setComparator(new DefaultComparator(std::less<KeyType>()));
+}
+
+template <typename KeyType, typename ValueType>
+FlatMap<KeyType, ValueType>::FlatMap(std::initializer_list<std::pair<KeyType, ValueType>> list) {
+    setComparator(new DefaultComparator(std::less<KeyType>()));
+    Vector<std::pair<KeyType, ValueType>> entries(list);
+    buildFrom(entries);
+}
+
+/*
+ * Implementation notes: freezing a Map
+ * ------------------------------------
+ * FlatMap is a friend of Map, so it can walk the nodes of the tree in
+ * order through the parent links and clone the map's comparator.
+ */
+
+template <typename KeyType, typename ValueType>
+FlatMap<KeyType, ValueType>::FlatMap(const Map<KeyType, ValueType>& map) {
+    typedef Map<KeyType, ValueType> MapType;
+    setComparator(map.cmpp->clone());
+    keys.reserve(map.size());
+    values.reserve(map.size());
+    for (auto np = MapType::leftmost(map.root); np != nullptr; np = MapType::successor(np)) {
+        keys.emplace(np->key);
+        values.emplace(np->value);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+FlatMap<KeyType, ValueType>::FlatMap(Map<KeyType, ValueType>&& map) {
+    typedef Map<KeyType, ValueType> MapType;
+    setComparator(map.cmpp->clone());
+    keys.reserve(map.size());
+    values.reserve(map.size());
+    for (auto np = MapType::leftmost(map.root); np != nullptr; np = MapType::successor(np)) {
+        keys.emplace(std::move(np->key));
+        values.emplace(std::move(np->value));
+    }
+    map.clear();
+}
+
+template <typename KeyType, typename ValueType>
+FlatMap<KeyType, ValueType>::~FlatMap() {
+    delete cmpp;
+}
+
+template <typename KeyType, typename ValueType>
+int FlatMap<KeyType, ValueType>::size() const {
+    return keys.size();
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::isEmpty() const {
+    return keys.isEmpty();
+}
+
+template <typename KeyType, typename ValueType>
+void FlatMap<KeyType, ValueType>::put(const KeyType& key, const ValueType& value) {
+    int index = lowerIndex(key);
+    if (index < keys.size() && compareKeys(key, keys[index]) == 0) {
+        values[index] = value;
+    } else {
+        keys.emplaceAt(index, key);
+        values.emplaceAt(index, value);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void FlatMap<KeyType, ValueType>::put(const KeyType& key, ValueType&& value) {
+    int index = lowerIndex(key);
+    if (index < keys.size() && compareKeys(key, keys[index]) == 0) {
+        values[index] = std::move(value);
+    } else {
+        keys.emplaceAt(index, key);
+        values.emplaceAt(index, std::move(value));
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename... Args>
+bool FlatMap<KeyType, ValueType>::tryEmplace(const KeyType& key, Args&&... args) {
+    int index = lowerIndex(key);
+    if (index < keys.size() && compareKeys(key, keys[index]) == 0)
+        return false;
+    keys.emplaceAt(index, key);
+    values.emplaceAt(index, std::forward<Args>(args)...);
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType FlatMap<KeyType, ValueType>::get(const KeyType& key) const {
+    int index = findIndex(key);
+    return (index < 0) ? ValueType() : values[index];
+}
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, ValueType> FlatMap<KeyType, ValueType>::get(const K& key) const {
+    int index = findLookupKey(key);
+    return (index < 0) ? ValueType() : values[index];
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::containsKey(const KeyType& key) const {
+    return findIndex(key) >= 0;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, bool> FlatMap<KeyType, ValueType>::containsKey(const K& key) const {
+    return findLookupKey(key) >= 0;
+}
+
+template <typename KeyType, typename ValueType>
+void FlatMap<KeyType, ValueType>::remove(const KeyType& key) {
+    int index = findIndex(key);
+    if (index >= 0) {
+        keys.remove(index);
+        values.remove(index);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, void> FlatMap<KeyType, ValueType>::remove(const K& key) {
+    int index = findLookupKey(key);
+    if (index >= 0) {
+        keys.remove(index);
+        values.remove(index);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void FlatMap<KeyType, ValueType>::clear() {
+    keys.clear();
+    values.clear();
+}
+
+template <typename KeyType, typename ValueType>
+void FlatMap<KeyType, ValueType>::reserve(int n) {
+    keys.reserve(n);
+    values.reserve(n);
+}
+
+template <typename KeyType, typename ValueType>
+ValueType& FlatMap<KeyType, ValueType>::operator[](const KeyType& key) {
+    int index = lowerIndex(key);
+    if (index == keys.size() || compareKeys(key, keys[index]) != 0) {
+        keys.emplaceAt(index, key);
+        values.emplaceAt(index);
+    }
+    return values[index];
+}
+
+template <typename KeyType, typename ValueType>
+ValueType FlatMap<KeyType, ValueType>::operator[](const KeyType& key) const {
+    return get(key);
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::operator==(const FlatMap& map2) const {
+    if (size() != map2.size())
+        return false;
+    for (int i = 0; i < size(); i++) {
+        if (compareKeys(keys[i], map2.keys[i]) != 0 || !(values[i] == map2.values[i]))
+            return false;
+    }
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::operator!=(const FlatMap& map2) const {
+    return !(*this == map2);
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::operator<(const FlatMap& map2) const {
+    return compare::compareMaps(*this, map2) < 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::operator<=(const FlatMap& map2) const {
+    return compare::compareMaps(*this, map2) <= 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::operator>(const FlatMap& map2) const {
+    return compare::compareMaps(*this, map2) > 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool FlatMap<KeyType, ValueType>::operator>=(const FlatMap& map2) const {
+    return compare::compareMaps(*this, map2) >= 0;
+}
+
+template <typename KeyType, typename ValueType>
+std::string FlatMap<KeyType, ValueType>::toString() {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+template <typename KeyType, typename ValueType>
+void FlatMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
+    for (int i = 0; i < size(); i++) {
+        fn(keys[i], values[i]);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void FlatMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&, const ValueType&)) const {
+    for (int i = 0; i < size(); i++) {
+        fn(keys[i], values[i]);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename FunctorType>
+void FlatMap<KeyType, ValueType>::mapAll(FunctorType fn) const {
+    for (int i = 0; i < size(); i++) {
+        fn(keys[i], values[i]);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+typename FlatMap<KeyType, ValueType>::iterator
+FlatMap<KeyType, ValueType>::lowerBound(const KeyType& key) const {
+    return iterator(this, lowerIndex(key));
+}
+
+template <typename KeyType, typename ValueType>
+typename FlatMap<KeyType, ValueType>::iterator
+FlatMap<KeyType, ValueType>::upperBound(const KeyType& key) const {
+    return iterator(this, upperIndex(key));
+}
+
+template <typename KeyType, typename ValueType>
+typename FlatMap<KeyType, ValueType>::iterator
+FlatMap<KeyType, ValueType>::floor(const KeyType& key) const {
+    int index = upperIndex(key);
+    return (index == 0) ? end() : iterator(this, index - 1);
+}
+
+template <typename KeyType, typename ValueType>
+typename FlatMap<KeyType, ValueType>::iterator
+FlatMap<KeyType, ValueType>::ceiling(const KeyType& key) const {
+    return iterator(this, lowerIndex(key));
+}
+
+/*
+ * Implementation notes: << and >>
+ * -------------------------------
+ * The insertion and extraction operators use the same format as those
+ * for Map.  The insertion operator reads the values directly from the
+ * array instead of looking up each key, and the extraction operator
+ * collects the entries and sorts them once.
+ */
+
+template <typename KeyType, typename ValueType>
+std::ostream& operator<<(std::ostream& os, const FlatMap<KeyType, ValueType>& map) {
+    os << "{";
+    for (int i = 0; i < map.size(); i++) {
+        if (i > 0)
+            os << ", ";
+        writeGenericValue(os, map.keys[i], false);
+        os << ":";
+        writeGenericValue(os, map.values[i], false);
+    }
+    return os << "}";
+}
+
+template <typename KeyType, typename ValueType>
+std::istream& operator>>(std::istream& is, FlatMap<KeyType, ValueType>& map) {
+    char ch;
+    is >> ch;
+    if (ch != '{')
+        error("operator >>: Missing {");
+    map.clear();
+    Vector<std::pair<KeyType, ValueType>> entries;
+    is >> ch;
+    if (ch != '}') {
+        is.unget();
+        while (true) {
+            KeyType key;
+            readGenericValue(is, key);
+            is >> ch;
+            if (ch != ':')
+                error("operator >>: Missing colon after key");
+            ValueType value;
+            readGenericValue(is, value);
+            entries.emplace(std::move(key), std::move(value));
+            is >> ch;
+            if (ch == '}')
+                break;
+            if (ch != ',') {
+                error(std::string("operator >>: Unexpected character ") + ch);
+            }
+        }
+    }
+    map.buildFrom(entries);
+    return is;
+}
+
+#endif  // _flatmap_h
@@ -0,0 +1,744 @@
+/*
+ * File: flatset.h
+ * ---------------
+ * This file exports the <code>FlatSet</code> class, which stores a set
+ * of distinct elements in a sorted array.  It is intended for sets that
+ * are built once and then read many times.
+ */
+
+#ifndef _flatset_h
+#define _flatset_h
+
+#include <algorithm>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+
+#include "compare.h"
+#include "flatmap.h"
+#include "set.h"
+#include "vector.h"
+
+/*
+ * Class: FlatSet<ValueType>
+ * -------------------------
+ * This class stores a collection of distinct elements, just as
+ * <code>Set</code> does, and it exports the same interface and iterates
+ * in the same order.  The elements are kept in a sorted array, so
+ * <code>contains</code> is a binary search over contiguous memory and the
+ * set operators are simple merges, but <code>add</code> and
+ * <code>remove</code> take linear time.  A <code>Set</code> can be frozen
+ * into a <code>FlatSet</code> in linear time.
+ */
+
+template <typename ValueType>
+class FlatSet {
+public:
+    /*
+     * Constructor: FlatSet
+     * Usage: FlatSet<ValueType> set;
+     *        FlatSet<ValueType> set(first, last);
+     * --------------------------------------------
+     * Creates a set of the specified element type, which is empty unless
+     * the values are given by an initializer list or an iterator range.
+     * The values may come in any order; they are sorted once.
+     */
+
+    FlatSet();
+    FlatSet(std::initializer_list<ValueType> list);
+
+    template <typename IteratorType,
+              typename = typename std::iterator_traits<IteratorType>::iterator_category>
+    FlatSet(IteratorType first, IteratorType last);
+
+    /*
+     * Constructor: FlatSet
+     * Usage: FlatSet<ValueType> flat(set);
+     * ------------------------------------
+     * Freezes a <code>Set</code> into a <code>FlatSet</code> with the same
+     * elements and comparison function, in linear time.  If the set is an
+     * rvalue, its elements are moved, and the set is left empty.
+     */
+
+    explicit FlatSet(const Set<ValueType>& set);
+    explicit FlatSet(Set<ValueType>&& set);
+
+    /*
+     * Destructor: ~FlatSet
+     * --------------------
+     * Frees any heap storage associated with this set.
+     */
+
+    virtual ~FlatSet();
+
+    /*
+     * Method: size
+     * Usage: count = set.size();
+     * --------------------------
+     * Returns the number of elements in this set.
+     */
+
+    int size() const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (set.isEmpty()) ...
+     * -----------------------------
+     * Returns <code>true</code> if this set contains no elements.
+     */
+
+    bool isEmpty() const;
+
+    /*
+     * Methods: add, insert
+     * Usage: set.add(value);
+     * ----------------------
+     * Adds an element to this set, if it was not already there.  These
+     * methods take linear time because they shift the later elements.
+     */
+
+    void add(const ValueType& value);
+    void insert(const ValueType& value);
+
+    /*
+     * Method: remove
+     * Usage: set.remove(value);
+     * -------------------------
+     * Removes an element from this set.  If the value was not
+     * contained in the set, no error is generated and the set
+     * remains unchanged.
+     */
+
+    void remove(const ValueType& value);
+    template <typename K>
+    EnableIfTransparent<ValueType, K, void> remove(const K& value);
+
+    /*
+     * Method: contains
+     * Usage: if (set.contains(value)) ...
+     * -----------------------------------
+     * Returns <code>true</code> if the specified value is in this set.
+     */
+
+    bool contains(const ValueType& value) const;
+    template <typename K>
+    EnableIfTransparent<ValueType, K, bool> contains(const K& value) const;
+
+    /*
+     * Method: isSubsetOf
+     * Usage: if (set.isSubsetOf(set2)) ...
+     * ------------------------------------
+     * Returns <code>true</code> if every element of this set is
+     * contained in <code>set2</code>.
+     */
+
+    bool isSubsetOf(const FlatSet& set2) const;
+
+    /*
+     * Method: clear
+     * Usage: set.clear();
+     * -------------------
+     * Removes all elements from this set.
+     */
+
+    void clear();
+
+    /*
+     * Operators: ==, !=, <, <=, >, >=
+     * Usage: if (set1 == set2) ...
+     * ----------------------------
+     * Compare two sets in the same way as the operators for
+     * <code>Set</code>.
+     */
+
+    bool operator==(const FlatSet& set2) const;
+    bool operator!=(const FlatSet& set2) const;
+    bool operator<(const FlatSet& set2) const;
+    bool operator<=(const FlatSet& set2) const;
+    bool operator>(const FlatSet& set2) const;
+    bool operator>=(const FlatSet& set2) const;
+
+    /*
+     * Operators: +, *, -
+     * Usage: set1 + set2
+     *        set1 * set2
+     *        set1 - set2
+     * ------------------
+     * Return the union, intersection, or difference of two sets.  The
+     * right hand operand of + and - can also be a single element.
+     */
+
+    FlatSet operator+(const FlatSet& set2) const;
+    FlatSet operator+(const ValueType& element) const;
+    FlatSet operator*(const FlatSet& set2) const;
+    FlatSet operator-(const FlatSet& set2) const;
+    FlatSet operator-(const ValueType& element) const;
+
+    /*
+     * Operators: +=, *=, -=
+     * Usage: set1 += set2;
+     *        set1 += value;
+     * ---------------------
+     * Update <code>set1</code> with the union, intersection, or difference.
+     * As with <code>Set</code>, the comma operator can follow a single
+     * value, as in <code>digits += 0, 1, 2;</code>.
+     */
+
+    FlatSet& operator+=(const FlatSet& set2);
+    FlatSet& operator+=(const ValueType& value);
+    FlatSet& operator*=(const FlatSet& set2);
+    FlatSet& operator-=(const FlatSet& set2);
+    FlatSet& operator-=(const ValueType& value);
+
+    /*
+     * Method: first
+     * Usage: ValueType value = set.first();
+     * -------------------------------------
+     * Returns the first value in the set.  If the set is empty,
+     * <code>first</code> generates an error.
+     */
+
+    ValueType first() const;
+
+    /*
+     * Methods: lowerBound, upperBound, floor, ceiling
+     * Usage: for (auto it = set.lowerBound(lo); it != set.upperBound(hi); ++it) ...
+     * -----------------------------------------------------------------------------
+     * Return iterators positioned as the corresponding methods of
+     * <code>Set</code> do, or <code>end()</code> if there is no such value.
+     */
+
+    class iterator;
+
+    iterator lowerBound(const ValueType& value) const;
+    iterator upperBound(const ValueType& value) const;
+    iterator floor(const ValueType& value) const;
+    iterator ceiling(const ValueType& value) const;
+
+    /*
+     * Method: toString
+     * Usage: string str = set.toString();
+     * -----------------------------------
+     * Converts the set to a printable string representation.
+     */
+
+    std::string toString();
+
+    /*
+     * Method: mapAll
+     * Usage: set.mapAll(fn);
+     * ----------------------
+     * Calls <code>fn(value)</code> for each element of the set, in
+     * ascending order.
+     */
+
+    void mapAll(void (*fn)(ValueType)) const;
+    void mapAll(void (*fn)(const ValueType&)) const;
+
+    template <typename FunctorType>
+    void mapAll(FunctorType fn) const;
+
+    /*
+     * Additional FlatSet operations
+     * -----------------------------
+     * In addition to the methods listed in this interface, the FlatSet
+     * class supports the following operations:
+     *
+     *   - Stream I/O using the << and >> operators
+     *   - Deep copying for the copy constructor and assignment operator
+     *   - Iteration using the range-based for statement and STL iterators,
+     *     in either direction using rbegin and rend
+     *   - Lookup by std::string_view or C string in a set of strings
+     */
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    FlatMap<ValueType, SetMarker> map; /* Map used to store the element   */
+    bool removeFlag;                   /* Flag to differentiate += and -= */
+
+    Vector<ValueType>& elements() {
+        return map.keys;
+    }
+
+    const Vector<ValueType>& elements() const {
+        return map.keys;
+    }
+
+    FlatSet emptyCopy() const;
+    const Vector<ValueType>& orderedElements(const FlatSet& set2, Vector<ValueType>& copy) const;
+
+public:
+    /*
+     * Hidden features
+     * ---------------
+     * The remainder of this file consists of the code required to
+     * support the comma operator, deep copying, and iteration.
+     */
+
+    /* Extended constructors */
+
+    template <typename CompareType>
+    explicit FlatSet(CompareType cmp) : map(FlatMap<ValueType, SetMarker>(cmp)), removeFlag(false) {
+        /* Empty */
+    }
+
+    /*
+     * Copying and moving support
+     * --------------------------
+     * A set copies or moves its underlying map.
+     */
+
+    FlatSet(const FlatSet& src) = default;
+    FlatSet(FlatSet&& src) = default;
+    FlatSet& operator=(const FlatSet& src) = default;
+    FlatSet& operator=(FlatSet&& src) = default;
+
+    FlatSet& operator,(const ValueType& value) {
+        if (this->removeFlag) {
+            this->remove(value);
+        } else {
+            this->add(value);
+        }
+        return *this;
+    }
+
+    /*
+     * Iterator support
+     * ----------------
+     * The set iterator is the iterator of the underlying map.
+     */
+
+    class iterator : public FlatMap<ValueType, SetMarker>::iterator {
+    public:
+        iterator() {
+            /* Empty */
+        }
+
+        iterator(const typename FlatMap<ValueType, SetMarker>::iterator& it)
+            : FlatMap<ValueType, SetMarker>::iterator(it) {
+            /* Empty */
+        }
+    };
+
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+
+    iterator begin() const {
+        return iterator(map.begin());
+    }
+
+    iterator end() const {
+        return iterator(map.end());
+    }
+
+    reverse_iterator rbegin() const {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() const {
+        return reverse_iterator(begin());
+    }
+};
+
+extern void error(std::string msg);
+
+template <typename ValueType>
+FlatSet<ValueType>::FlatSet() : removeFlag(false) {
+    /* Empty */
+}
+
+template <typename ValueType>
+FlatSet<ValueType>::FlatSet(std::initializer_list<ValueType> list)
+    : FlatSet(list.begin(), list.end()) {
+    /* Empty */
+}
+
+/*
+ * Implementation notes: FlatSet(first, last)
+ * ------------------------------------------
+ * The values are appended to the array, which is sorted only if it is
+ * out of order; the duplicates are then squeezed out in a single pass.
+ */
+
+template <typename ValueType>
+template <typename IteratorType, typename>
+FlatSet<ValueType>::FlatSet(IteratorType first, IteratorType last) : removeFlag(false) {
+    Vector<ValueType>& vec = elements();
+    for (; first != last; ++first) {
+        vec.add(*first);
+    }
+    auto lessThan = [this](const ValueType& v1, const ValueType& v2) {
+        return map.compareKeys(v1, v2) < 0;
+    };
+    if (!std::is_sorted(vec.begin(), vec.end(), lessThan))
+        std::sort(vec.begin(), vec.end(), lessThan);
+    int n = 0;
+    for (int i = 0; i < vec.size(); i++) {
+        if (n == 0 || lessThan(vec[n - 1], vec[i])) {
+            if (n != i)
+                vec[n] = std::move(vec[i]);
+            n++;
+        }
+    }
+    vec.resize(n);
+}
+
+template <typename ValueType>
+FlatSet<ValueType>::FlatSet(const Set<ValueType>& set) : map(set.map), removeFlag(false) {
+    /* Empty */
+}
+
+template <typename ValueType>
+FlatSet<ValueType>::FlatSet(Set<ValueType>&& set) : map(std::move(set.map)), removeFlag(false) {
+    /* Empty */
+}
+
+template <typename ValueType>
+FlatSet<ValueType>::~FlatSet() {
+    /* Empty */
+}
+
+template <typename ValueType>
+int FlatSet<ValueType>::size() const {
+    return map.size();
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::isEmpty() const {
+    return map.isEmpty();
+}
+
+template <typename ValueType>
+void FlatSet<ValueType>::add(const ValueType& value) {
+    map.tryEmplace(value);
+}
+
+template <typename ValueType>
+void FlatSet<ValueType>::insert(const ValueType& value) {
+    map.tryEmplace(value);
+}
+
+template <typename ValueType>
+void FlatSet<ValueType>::remove(const ValueType& value) {
+    map.remove(value);
+}
+
+template <typename ValueType>
+template <typename K>
+EnableIfTransparent<ValueType, K, void> FlatSet<ValueType>::remove(const K& value) {
+    map.remove(value);
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::contains(const ValueType& value) const {
+    return map.containsKey(value);
+}
+
+template <typename ValueType>
+template <typename K>
+EnableIfTransparent<ValueType, K, bool> FlatSet<ValueType>::contains(const K& value) const {
+    return map.containsKey(value);
+}
+
+template <typename ValueType>
+void FlatSet<ValueType>::clear() {
+    map.clear();
+}
+
+/*
+ * Implementation notes: set operators
+ * -----------------------------------
+ * Both sets are sorted arrays, so each operator is a single merge that
+ * appends the elements of the result to a new array in ascending order,
+ * which takes O(n + m) time.  The merge needs both arrays in the order of
+ * this set, so the operators read the right operand through
+ * orderedElements.  That method returns the elements of set2 as they are
+ * if they are in strictly ascending order under this comparator, which
+ * is always the case when the two sets use the same comparator.  If set2
+ * was built with a different comparator, it returns a sorted copy from
+ * which elements that this comparator considers equal have been removed.
+ * The emptyCopy method makes the empty result set, which shares the
+ * comparator of this set.
+ */
+
+template <typename ValueType>
+FlatSet<ValueType> FlatSet<ValueType>::emptyCopy() const {
+    FlatSet<ValueType> set;
+    delete set.map.cmpp;
+    set.map.setComparator(map.cmpp->clone());
+    return set;
+}
+
+template <typename ValueType>
+const Vector<ValueType>& FlatSet<ValueType>::orderedElements(const FlatSet& set2,
+                                                             Vector<ValueType>& copy) const {
+    const Vector<ValueType>& v2 = set2.elements();
+    auto lessThan = [this](const ValueType& v1, const ValueType& v2) {
+        return map.compareKeys(v1, v2) < 0;
+    };
+    auto outOfOrder = [&lessThan](const ValueType& v1, const ValueType& v2) {
+        return !lessThan(v1, v2);
+    };
+    if (std::adjacent_find(v2.begin(), v2.end(), outOfOrder) == v2.end())
+        return v2;
+    Vector<ValueType> sorted = v2;
+    std::sort(sorted.begin(), sorted.end(), lessThan);
+    copy.clear();
+    copy.reserve(sorted.size());
+    for (const ValueType& value : sorted) {
+        if (copy.isEmpty() || lessThan(copy[copy.size() - 1], value))
+            copy.add(value);
+    }
+    return copy;
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::isSubsetOf(const FlatSet& set2) const {
+    const Vector<ValueType>& v1 = elements();
+    Vector<ValueType> copy;
+    const Vector<ValueType>& v2 = orderedElements(set2, copy);
+    if (v1.size() > v2.size())
+        return false;
+    int j = 0;
+    for (int i = 0; i < v1.size(); i++) {
+        while (j < v2.size() && map.compareKeys(v2[j], v1[i]) < 0) {
+            j++;
+        }
+        if (j == v2.size() || map.compareKeys(v2[j], v1[i]) != 0)
+            return false;
+        j++;
+    }
+    return true;
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::operator==(const FlatSet& set2) const {
+    return size() == set2.size() && isSubsetOf(set2);
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::operator!=(const FlatSet& set2) const {
+    return !(*this == set2);
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::operator<(const FlatSet& set2) const {
+    return compare::compare(*this, set2) < 0;
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::operator<=(const FlatSet& set2) const {
+    return compare::compare(*this, set2) <= 0;
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::operator>(const FlatSet& set2) const {
+    return compare::compare(*this, set2) > 0;
+}
+
+template <typename ValueType>
+bool FlatSet<ValueType>::operator>=(const FlatSet& set2) const {
+    return compare::compare(*this, set2) >= 0;
+}
+
+template <typename ValueType>
+FlatSet<ValueType> FlatSet<ValueType>::operator+(const FlatSet& set2) const {
+    const Vector<ValueType>& v1 = elements();
+    Vector<ValueType> copy;
+    const Vector<ValueType>& v2 = orderedElements(set2, copy);
+    FlatSet<ValueType> set = emptyCopy();
+    Vector<ValueType>& result = set.elements();
+    result.reserve(v1.size() + v2.size());
+    int i = 0;
+    int j = 0;
+    while (i < v1.size() && j < v2.size()) {
+        int sign = map.compareKeys(v1[i], v2[j]);
+        if (sign <= 0) {
+            result.add(v1[i++]);
+            if (sign == 0)
+                j++;
+        } else {
+            result.add(v2[j++]);
+        }
+    }
+    while (i < v1.size()) {
+        result.add(v1[i++]);
+    }
+    while (j < v2.size()) {
+        result.add(v2[j++]);
+    }
+    return set;
+}
+
+template <typename ValueType>
+FlatSet<ValueType> FlatSet<ValueType>::operator+(const ValueType& element) const {
+    FlatSet<ValueType> set = *this;
+    set.add(element);
+    return set;
+}
+
+template <typename ValueType>
+FlatSet<ValueType> FlatSet<ValueType>::operator*(const FlatSet& set2) const {
+    const Vector<ValueType>& v1 = elements();
+    Vector<ValueType> copy;
+    const Vector<ValueType>& v2 = orderedElements(set2, copy);
+    FlatSet<ValueType> set = emptyCopy();
+    Vector<ValueType>& result = set.elements();
+    int i = 0;
+    int j = 0;
+    while (i < v1.size() && j < v2.size()) {
+        int sign = map.compareKeys(v1[i], v2[j]);
+        if (sign < 0) {
+            i++;
+        } else if (sign > 0) {
+            j++;
+        } else {
+            result.add(v1[i++]);
+            j++;
+        }
+    }
+    return set;
+}
+
+template <typename ValueType>
+FlatSet<ValueType> FlatSet<ValueType>::operator-(const FlatSet& set2) const {
+    const Vector<ValueType>& v1 = elements();
+    Vector<ValueType> copy;
+    const Vector<ValueType>& v2 = orderedElements(set2, copy);
+    FlatSet<ValueType> set = emptyCopy();
+    Vector<ValueType>& result = set.elements();
+    result.reserve(v1.size());
+    int j = 0;
+    for (int i = 0; i < v1.size(); i++) {
+        while (j < v2.size() && map.compareKeys(v2[j], v1[i]) < 0) {
+            j++;
+        }
+        if (j == v2.size() || map.compareKeys(v2[j], v1[i]) != 0)
+            result.add(v1[i]);
+    }
+    return set;
+}
+
+template <typename ValueType>
+FlatSet<ValueType> FlatSet<ValueType>::operator-(const ValueType& element) const {
+    FlatSet<ValueType> set = *this;
+    set.remove(element);
+    return set;
+}
+
+template <typename ValueType>
+FlatSet<ValueType>& FlatSet<ValueType>::operator+=(const FlatSet& set2) {
+    map = std::move((*this + set2).map);
+    return *this;
+}
+
+template <typename ValueType>
+FlatSet<ValueType>& FlatSet<ValueType>::operator+=(const ValueType& value) {
+    this->add(value);
+    this->removeFlag = false;
+    return *this;
+}
+
+template <typename ValueType>
+FlatSet<ValueType>& FlatSet<ValueType>::operator*=(const FlatSet& set2) {
+    map = std::move((*this * set2).map);
+    return *this;
+}
+
+template <typename ValueType>
+FlatSet<ValueType>& FlatSet<ValueType>::operator-=(const FlatSet& set2) {
+    map = std::move((*this - set2).map);
+    return *this;
+}
+
+template <typename ValueType>
+FlatSet<ValueType>& FlatSet<ValueType>::operator-=(const ValueType& value) {
+    this->remove(value);
+    this->removeFlag = true;
+    return *this;
+}
+
+template <typename ValueType>
+ValueType FlatSet<ValueType>::first() const {
+    if (isEmpty())
+        error("first: set is empty");
+    return *begin();
+}
+
+template <typename ValueType>
+typename FlatSet<ValueType>::iterator FlatSet<ValueType>::lowerBound(const ValueType& value) const {
+    return iterator(map.lowerBound(value));
+}
+
+template <typename ValueType>
+typename FlatSet<ValueType>::iterator FlatSet<ValueType>::upperBound(const ValueType& value) const {
+    return iterator(map.upperBound(value));
+}
+
+template <typename ValueType>
+typename FlatSet<ValueType>::iterator FlatSet<ValueType>::floor(const ValueType& value) const {
+    return iterator(map.floor(value));
+}
+
+template <typename ValueType>
+typename FlatSet<ValueType>::iterator FlatSet<ValueType>::ceiling(const ValueType& value) const {
+    return iterator(map.ceiling(value));
+}
+
+template <typename ValueType>
+std::string FlatSet<ValueType>::toString() {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+template <typename ValueType>
+void FlatSet<ValueType>::mapAll(void (*fn)(ValueType)) const {
+    for (const ValueType& value : elements()) {
+        fn(value);
+    }
+}
+
+template <typename ValueType>
+void FlatSet<ValueType>::mapAll(void (*fn)(const ValueType&)) const {
+    for (const ValueType& value : elements()) {
+        fn(value);
+    }
+}
+
+template <typename ValueType>
+template <typename FunctorType>
+void FlatSet<ValueType>::mapAll(FunctorType fn) const {
+    for (const ValueType& value : elements()) {
+        fn(value);
+    }
+}
+
+template <typename ValueType>
+std::ostream& operator<<(std::ostream& os, const FlatSet<ValueType>& set) {
+    os << "{";
+    bool started = false;
+    for (const ValueType& value : set) {
+        if (started)
+            os << ", ";
+        writeGenericValue(os, value, true);
+        started = true;
+    }
+    os << "}";
+    return os;
+}
+
+template <typename ValueType>
+std::istream& operator>>(std::istream& is, FlatSet<ValueType>& set) {
+    Set<ValueType> tree;
+    is >> tree;
+    set = FlatSet<ValueType>(std::move(tree));
+    return is;
+}
+
+#endif  // _flatset_h
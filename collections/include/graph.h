@@ -27,12 +27,27 @@
 #ifndef _graph_h
 #define _graph_h
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 
+#include "hashmap.h"
 #include "hashset.h"
 #include "map.h"
 #include "set.h"
+#include "smallvector.h"
+#include "stack.h"
+#include "threadpool.h"
 #include "tokenscanner.h"
+#include "vector.h"
+
+template <typename NodeType, typename ArcType>
+class CompactGraph;
+
+template <typename NodeType, typename ArcType>
+class GraphReader;
 
 /*
  * Class: Graph<NodeType,ArcType>
@@ -54,6 +69,7 @@
  * <ul>
  *   <li>A <code>NodeType *</code> field called <code>start</code>
  *   <li>A <code>NodeType *</code> field called <code>finish</code>
+ *   <li>A numeric field called <code>cost</code>
  * </ul>
  */
 
@@ -104,6 +120,18 @@ public:
 
     void clear();
 
+    /*
+     * Method: reserve
+     * Usage: g.reserve(nNodes, nArcs);
+     * --------------------------------
+     * Makes room in the tables that index the graph for the specified
+     * numbers of nodes and arcs, so that adding them does not rehash
+     * those tables as the graph grows.  The contents of the graph do
+     * not change.
+     */
+
+    void reserve(int nNodes, int nArcs);
+
     /*
      * Method: addNode
      * Usage: NodeType *node = g.addNode(name);
@@ -135,13 +163,46 @@ public:
     /*
      * Method: getNode
      * Usage: NodeType *node = g.getNode(name);
+     *        NodeType *node = g.getNode(id);
      * ----------------------------------------
      * Looks up a node in the name table attached to the graph and
-     * returns a pointer to that node.  If no node with the specified
-     * name exists, <code>getNode</code> returns <code>nullptr</code>.
+     * returns a pointer to that node.  The second form looks up the node
+     * by its integer id instead.  If no node with the specified name or
+     * id exists, <code>getNode</code> returns <code>nullptr</code>.
      */
 
     NodeType* getNode(const std::string& name) const;
+    NodeType* getNode(int id) const;
+
+    /*
+     * Method: getId
+     * Usage: int id = g.getId(node);
+     *        int id = g.getId(name);
+     * ------------------------------
+     * Returns the integer id of a node, which can be indicated either as
+     * a pointer or by name, or -1 if the graph does not contain it.  A
+     * node receives an id when it is added to the graph and keeps it
+     * until it is removed, so ids can index arrays of per-node data.
+     * Ids start at 0, and the id of a removed node is given to the next
+     * node added, which keeps every id below <code>idLimit()</code>.
+     * A snapshot taken by <code>freeze</code> gives each node the same
+     * id.
+     */
+
+    int getId(NodeType* node) const;
+    int getId(const std::string& name) const;
+
+    /*
+     * Method: idLimit
+     * Usage: Vector<double> distance(g.idLimit());
+     * --------------------------------------------
+     * Returns a number larger than every node id in use, which is the
+     * size of an array indexed by node id.  This value is the same as
+     * <code>size()</code> unless nodes have been removed and their ids
+     * have not yet been reused.
+     */
+
+    int idLimit() const;
 
     /*
      * Method: addArc
@@ -185,6 +246,9 @@ public:
      * Returns <code>true</code> if the graph contains an arc from
      * <code>n1</code> to <code>n2</code>.  As in the <code>addArc</code>
      * method, nodes can be specified either as node pointers or by name.
+     * The graph keeps a hash table of connected pairs, so this method
+     * runs in constant time no matter how many arcs leave
+     * <code>n1</code>.
      */
 
     bool isConnected(NodeType* n1, NodeType* n2) const;
@@ -226,6 +290,37 @@ public:
     const Set<NodeType*> getNeighbors(NodeType* node) const;
     const Set<NodeType*> getNeighbors(const std::string& node) const;
 
+    /*
+     * Method: getNeighborView
+     * Usage: for (NodeType *neighbor : g.getNeighborView(node)) ...
+     *        for (NodeType *neighbor : g.getNeighborView(name)) ...
+     * ------------------------------------------------------------
+     * Returns a view of the finish nodes of the arcs that leave the
+     * specified node.  Unlike <code>getNeighbors</code>, this method does
+     * not build a new set: the view reads the arc set of the node as it
+     * is iterated, so it reflects later changes to the graph.  A neighbor
+     * joined by parallel arcs appears once for each arc.
+     */
+
+    class NeighborView;
+
+    NeighborView getNeighborView(NodeType* node) const;
+    NeighborView getNeighborView(const std::string& name) const;
+
+    /*
+     * Method: freeze
+     * Usage: CompactGraph<NodeType,ArcType> csr = g.freeze();
+     * -------------------------------------------------------
+     * Returns a <code>CompactGraph</code> snapshot of the current nodes
+     * and arcs, which is much faster to traverse than the graph itself.
+     * Each node keeps its id, so arrays indexed by the ids of the graph
+     * can be used with the snapshot.  The snapshot does not change when
+     * the graph does, so a client that edits the graph must call
+     * <code>freeze</code> again to see the changes.
+     */
+
+    CompactGraph<NodeType, ArcType> freeze() const;
+
     /*
      * Method: toString
      * Usage: string str = g.toString();
@@ -359,14 +454,18 @@ public:
 private:
     /* Instance variables */
 
-    Set<NodeType*> nodes;                /* The set of nodes in the graph */
-    Set<ArcType*> arcs;                  /* The set of arcs in the graph  */
-    Map<std::string, NodeType*> nodeMap; /* A map from names to nodes     */
-    GraphComparator comparator;          /* The comparator for this graph */
+    Set<NodeType*> nodes;                    /* The set of nodes in the graph   */
+    Set<ArcType*> arcs;                      /* The set of arcs in the graph    */
+    HashMap<std::string, NodeType*> nodeMap; /* A map from names to nodes       */
+    HashMap<NodeType*, int> nodeIds;         /* A map from nodes to their ids   */
+    Vector<NodeType*> nodesById;             /* The node with each id, or null  */
+    Stack<int> freeIds;                      /* Ids released by removeNode      */
+    HashMap<long long, int> arcCounts;       /* The number of arcs on each pair */
+    GraphComparator comparator;              /* The comparator for this graph   */
 
     /*
-     * Functions: operator=, copy constructor
-     * --------------------------------------
+     * Functions: operator=, copy constructor, move constructor
+     * --------------------------------------------------------
      * These functions are part of the public interface of the class but are
      * defined here to avoid adding confusion to the Graph class.
      */
@@ -374,6 +473,8 @@ private:
 public:
     Graph& operator=(const Graph& src);
     Graph(const Graph& src);
+    Graph& operator=(Graph&& src);
+    Graph(Graph&& src);
 
     static int compare(NodeType* n1, NodeType* n2) {
         if (n1 == n2)
@@ -459,7 +560,7 @@ public:
             return *setitr;
         }
 
-        NodeType** operator->() {
+        NodeType* const* operator->() {
             return &(*setitr);
         }
 
@@ -478,10 +579,425 @@ public:
         return iterator(*this, true);
     }
 
+    /*
+     * Class: NeighborView
+     * -------------------
+     * The view returned by getNeighborView, which maps each arc in the
+     * arc set of a node to its finish node as it is iterated.
+     */
+
+    class NeighborView {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = NodeType*;
+            using difference_type = std::ptrdiff_t;
+            using pointer = NodeType**;
+            using reference = NodeType*;
+
+            explicit iterator(typename Set<ArcType*>::iterator arcitr) : arcitr(arcitr) {
+                // empty
+            }
+
+            iterator& operator++() {
+                ++arcitr;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator copy(*this);
+                operator++();
+                return copy;
+            }
+
+            bool operator==(const iterator& rhs) const {
+                return arcitr == rhs.arcitr;
+            }
+
+            bool operator!=(const iterator& rhs) const {
+                return !(*this == rhs);
+            }
+
+            NodeType* operator*() const {
+                return (*arcitr)->finish;
+            }
+
+        private:
+            typename Set<ArcType*>::iterator arcitr;
+        };
+
+        explicit NeighborView(const Set<ArcType*>& arcs) : arcs(&arcs) {
+            // empty
+        }
+
+        int size() const {
+            return arcs->size();
+        }
+
+        bool isEmpty() const {
+            return arcs->isEmpty();
+        }
+
+        iterator begin() const {
+            return iterator(arcs->begin());
+        }
+
+        iterator end() const {
+            return iterator(arcs->end());
+        }
+
+    private:
+        const Set<ArcType*>* arcs;
+    };
+
 private:
     void deepCopy(const Graph& src);
-    NodeType* getExistingNode(std::string name) const;
+    NodeType* getExistingNode(const std::string& name) const;
     NodeType* scanNode(TokenScanner& scanner);
+    void countArc(ArcType* arc, int delta);
+    static long long arcKey(int id1, int id2);
+    void loadSorted(const Vector<NodeType*>& newNodes, const Vector<ArcType*>& newArcs);
+
+    friend class GraphReader<NodeType, ArcType>;
+};
+
+/*
+ * Class: GraphSpan<ValueType>
+ * ---------------------------
+ * This class is a read-only view of consecutive elements in one of the
+ * arrays of a <code>CompactGraph</code>, such as the neighbors of a node.
+ * It supports range-based <code>for</code> loops and selection with
+ * square brackets, and stays valid for as long as the snapshot does.
+ */
+
+template <typename ValueType>
+class GraphSpan {
+public:
+    /*
+     * Constructor: GraphSpan
+     * Usage: GraphSpan<ValueType> span(array, n);
+     * -------------------------------------------
+     * Creates a span of the <code>n</code> elements starting at
+     * <code>array</code>.  Clients usually obtain spans from
+     * <code>CompactGraph::neighbors</code> and its relatives instead.
+     */
+
+    GraphSpan(const ValueType* array, int n);
+
+    /*
+     * Methods: size, isEmpty
+     * Usage: int n = span.size();
+     * ---------------------------
+     * Return the number of elements in the span and whether it is empty.
+     */
+
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * Operator: []
+     * Usage: span[index]
+     * ------------------
+     * Selects an element of the span.  As with <code>Vector</code>, the
+     * index is checked unless SPL_UNCHECKED_INDEXING is defined.
+     */
+
+    const ValueType& operator[](int index) const;
+
+    /*
+     * Methods: begin, end
+     * Usage: for (int id : span) ...
+     * ------------------------------
+     * Return pointers to the first element of the span and just past the
+     * last one.
+     */
+
+    const ValueType* begin() const;
+    const ValueType* end() const;
+
+private:
+    const ValueType* first; /* The first element of the span */
+    int n;                  /* The number of elements        */
+};
+
+/*
+ * Class: CompactGraph<NodeType,ArcType>
+ * -------------------------------------
+ * This class is an immutable snapshot of a <code>Graph</code> in
+ * <b><i>compressed sparse row</i></b> form, which is created by calling
+ * the <code>freeze</code> method of the graph.  Each node keeps the
+ * integer id it has in the graph, and every id is below
+ * <code>idLimit()</code>.  An id freed by removing a node from the
+ * graph belongs to no node in the snapshot; it has no arcs, and
+ * <code>getNode</code> returns <code>nullptr</code> for it.  The arcs
+ * that leave a node occupy a contiguous block of three parallel
+ * arrays holding the id of the finish node, the cost, and the original
+ * arc, so traversals read memory in order instead of chasing pointers
+ * through sets and comparing names.  The usual pattern is
+ *
+ *<pre>
+ *    CompactGraph&lt;NodeType,ArcType&gt; csr = g.freeze();
+ *    for (int id = 0; id &lt; csr.idLimit(); id++) {
+ *        for (int neighbor : csr.neighbors(id)) ...
+ *    }
+ *</pre>
+ *
+ * The snapshot refers to the nodes and arcs of the graph, but never
+ * changes them.  It must not be used after the nodes or arcs it refers
+ * to have been removed from the graph.  A snapshot read from a file by
+ * <code>GraphReader::readCompact</code> instead owns its nodes and arcs.
+ */
+
+template <typename NodeType, typename ArcType>
+class CompactGraph {
+public:
+    /*
+     * Constructor: CompactGraph
+     * Usage: CompactGraph<NodeType,ArcType> csr;
+     *        CompactGraph<NodeType,ArcType> csr(g);
+     * --------------------------------------------
+     * Creates a snapshot of the specified graph, which is the same as
+     * calling <code>g.freeze()</code>.  The default constructor creates
+     * a snapshot of an empty graph.
+     */
+
+    CompactGraph();
+    explicit CompactGraph(const Graph<NodeType, ArcType>& graph);
+
+    /*
+     * Methods: size, isEmpty
+     * Usage: int n = csr.size();
+     * --------------------------
+     * Return the number of nodes in the snapshot and whether it has none.
+     */
+
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * Method: idLimit
+     * Usage: Vector<double> distance(csr.idLimit());
+     * ----------------------------------------------
+     * Returns a number larger than every node id, which is the size of
+     * an array indexed by node id.  This value is the
+     * <code>idLimit()</code> of the graph when the snapshot was taken.
+     */
+
+    int idLimit() const;
+
+    /*
+     * Method: arcCount
+     * Usage: int m = csr.arcCount();
+     * ------------------------------
+     * Returns the number of arcs in the snapshot.
+     */
+
+    int arcCount() const;
+
+    /*
+     * Method: getId
+     * Usage: int id = csr.getId(node);
+     *        int id = csr.getId(name);
+     * --------------------------------
+     * Returns the id of the specified node, which can be indicated either
+     * as a pointer or by name, or -1 if the snapshot does not contain it.
+     * The snapshot keeps its ids in order of name, so the lookup is a
+     * binary search.
+     */
+
+    int getId(NodeType* node) const;
+    int getId(const std::string& name) const;
+
+    /*
+     * Method: getNode
+     * Usage: NodeType *node = csr.getNode(id);
+     * ----------------------------------------
+     * Returns the node with the specified id, or <code>nullptr</code> if
+     * the id belongs to no node.
+     */
+
+    NodeType* getNode(int id) const;
+
+    /*
+     * Method: degree
+     * Usage: int n = csr.degree(id);
+     * ------------------------------
+     * Returns the number of arcs that leave the specified node.
+     */
+
+    int degree(int id) const;
+
+    /*
+     * Methods: neighbors, costs, arcs
+     * Usage: for (int neighbor : csr.neighbors(id)) ...
+     *        for (double cost : csr.costs(id)) ...
+     *        for (ArcType *arc : csr.arcs(id)) ...
+     * -------------------------------------------------
+     * Return the finish node ids, costs, and original arcs of the arcs
+     * that leave the specified node.  The three spans are parallel, so
+     * element <code>i</code> of each describes the same arc.  A node
+     * with parallel arcs to the same neighbor lists that neighbor once
+     * for each arc.
+     */
+
+    GraphSpan<int> neighbors(int id) const;
+    GraphSpan<double> costs(int id) const;
+    GraphSpan<ArcType*> arcs(int id) const;
+
+    /*
+     * Methods: getOffsets, getTargets, getCosts, getArcs
+     * Usage: const Vector<int>& offsets = csr.getOffsets();
+     * -----------------------------------------------------
+     * Return the arrays behind the snapshot for clients that want to
+     * index them directly.  The arcs that leave node <code>id</code> are
+     * the ones at positions <code>offsets[id]</code> up to but not
+     * including <code>offsets[id + 1]</code> of the target, cost, and arc
+     * arrays, so the offset array has <code>size() + 1</code> elements.
+     */
+
+    const Vector<int>& getOffsets() const;
+    const Vector<int>& getTargets() const;
+    const Vector<double>& getCosts() const;
+    const Vector<ArcType*>& getArcs() const;
+
+    /*
+     * Method: reversed
+     * Usage: CompactGraph<NodeType,ArcType> rev = csr.reversed();
+     * -----------------------------------------------------------
+     * Returns a snapshot of the same nodes, with the same ids, in which
+     * every arc points the other way.  In the result,
+     * <code>neighbors(id)</code> lists the nodes that have arcs into node
+     * <code>id</code>, and <code>arcs(id)</code> lists those arcs, which
+     * still have their original <code>start</code> and <code>finish</code>.
+     */
+
+    CompactGraph reversed() const;
+
+    /*
+     * Method: parallelBreadthFirstSearch
+     * Usage: Vector<int> depth = csr.parallelBreadthFirstSearch(source);
+     *        Vector<int> depth = csr.parallelBreadthFirstSearch(source, pool);
+     * ---------------------------------------------------------------------
+     * Returns a vector giving, for each node id, the number of arcs on the
+     * shortest path from <code>source</code> to that node, or -1 if the
+     * node cannot be reached.  The search expands each level of the
+     * breadth-first tree in parallel on the threads of <code>pool</code>
+     * or of the default pool.  While the frontier is small it follows the
+     * arcs leaving the frontier; once the frontier touches a large part
+     * of the graph it switches to checking each unreached node for an arc
+     * from the frontier, which examines far fewer arcs on the middle
+     * levels of large graphs.
+     */
+
+    Vector<int> parallelBreadthFirstSearch(int source, ThreadPool& pool = ThreadPool::getDefault()) const;
+
+    /*
+     * Method: parallelConnectedComponents
+     * Usage: Vector<int> component = csr.parallelConnectedComponents();
+     *        Vector<int> component = csr.parallelConnectedComponents(pool);
+     * --------------------------------------------------------------------
+     * Returns a vector giving the number of the connected component that
+     * contains each node, ignoring the direction of the arcs, or -1 for
+     * an id that belongs to no node.  The components are numbered from 0
+     * in order of their lowest node id, so the result does not depend on
+     * the number of threads.
+     */
+
+    Vector<int> parallelConnectedComponents(ThreadPool& pool = ThreadPool::getDefault()) const;
+
+    /*
+     * Method: parallelPageRank
+     * Usage: Vector<double> rank = csr.parallelPageRank();
+     *        Vector<double> rank = csr.parallelPageRank(iterations, damping, pool);
+     * -------------------------------------------------------------------------
+     * Returns the PageRank of each node after the specified number of
+     * iterations, which defaults to 20, with the specified damping factor,
+     * which defaults to 0.85.  The ranks start out equal and always sum
+     * to 1.  The rank of a node without arcs is spread evenly over all
+     * nodes, and parallel arcs count once each.  An id that belongs to no
+     * node has a rank of 0.  Every iteration computes
+     * the new ranks of the nodes in parallel.
+     */
+
+    Vector<double> parallelPageRank(int iterations = 20, double damping = 0.85,
+                                    ThreadPool& pool = ThreadPool::getDefault()) const;
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    /* Constants */
+
+    static const int PARALLEL_GRAIN = 1024;    /* Nodes per parallel chunk      */
+    static const int BOTTOM_UP_ARC_RATIO = 14; /* Thresholds for switching the */
+    static const int TOP_DOWN_NODE_RATIO = 24; /* direction of the search      */
+
+    /* Instance variables */
+
+    Vector<NodeType*> nodeList; /* The nodes in id order, or null      */
+    Vector<int> nameOrder;      /* The ids in order of name            */
+    Vector<int> offsetList;     /* The first arc of each node          */
+    Vector<int> targetList;     /* The finish node id of each arc      */
+    Vector<double> costList;    /* The cost of each arc                */
+    Vector<ArcType*> arcList;   /* The arc each position came from     */
+
+    /*
+     * The incoming arcs of each node, stored as offsets into an array of
+     * the ids of the nodes they come from.  The parallel algorithms build
+     * them the first time they need them and keep them, since the
+     * snapshot never changes.  A copy of the snapshot starts without
+     * them.
+     */
+
+    struct IncomingArcs {
+        IncomingArcs() : built(false) {
+            /* Empty */
+        }
+
+        IncomingArcs(const IncomingArcs&) : built(false) {
+            /* Empty */
+        }
+
+        IncomingArcs& operator=(const IncomingArcs&) {
+            built = false;
+            offsets.clear();
+            sources.clear();
+            return *this;
+        }
+
+        std::mutex lock;     /* Serializes building the arrays      */
+        bool built;          /* Whether the arrays have been built  */
+        Vector<int> offsets; /* The first incoming arc of each node */
+        Vector<int> sources; /* The start node of each incoming arc */
+    };
+
+    mutable IncomingArcs incoming;
+
+    /*
+     * The nodes and arcs of a snapshot that GraphReader builds directly
+     * from a file, which belong to no graph.  Copies of the snapshot,
+     * including reversed ones, share them, and the last copy to be
+     * destroyed frees them.  For a snapshot of a graph, this pointer is
+     * empty.
+     */
+
+    struct OwnedElements {
+        std::unique_ptr<NodeType[]> nodes;
+        std::unique_ptr<ArcType[]> arcs;
+    };
+
+    std::shared_ptr<OwnedElements> owned;
+
+    friend class GraphReader<NodeType, ArcType>;
+
+    void checkId(int id, const char* prefix) const;
+    const IncomingArcs& getIncomingArcs() const;
+    static int findRoot(std::atomic<int>* links, int id);
 };
 
 extern void error(std::string msg);
@@ -552,6 +1068,57 @@ void Graph<NodeType, ArcType>::clear() {
     arcs.clear();
     nodes.clear();
     nodeMap.clear();
+    nodeIds.clear();
+    nodesById.clear();
+    freeIds.clear();
+    arcCounts.clear();
+}
+
+template <typename NodeType, typename ArcType>
+void Graph<NodeType, ArcType>::reserve(int nNodes, int nArcs) {
+    nodeMap.reserve(nNodes);
+    nodeIds.reserve(nNodes);
+    nodesById.reserve(nNodes);
+    arcCounts.reserve(nArcs);
+}
+
+/*
+ * Implementation notes: loadSorted
+ * --------------------------------
+ * This method fills an empty graph in one step for GraphReader.  The
+ * nodes must be in alphabetical order, with distinct names, and the arcs
+ * in the order defined by compare, so that every set in the graph can
+ * be built directly from a sorted array.  The nodes receive ids in the
+ * same order.
+ */
+
+template <typename NodeType, typename ArcType>
+void Graph<NodeType, ArcType>::loadSorted(const Vector<NodeType*>& newNodes, const Vector<ArcType*>& newArcs) {
+    int nNodes = newNodes.size();
+    int nArcs = newArcs.size();
+    reserve(nNodes, nArcs);
+    if (nNodes > 0)
+        nodes.assignSorted(&newNodes[0], nNodes);
+    for (NodeType* node : newNodes) {
+        node->arcs = Set<ArcType*>(comparator);
+        nodeMap.put(node->name, node);
+        nodeIds.put(node, nodesById.size());
+        nodesById.add(node);
+    }
+    if (nArcs > 0)
+        arcs.assignSorted(&newArcs[0], nArcs);
+    for (int k = 0; k < nArcs;) {
+        NodeType* start = newArcs[k]->start;
+        int end = k + 1;
+        while (end < nArcs && newArcs[end]->start == start) {
+            end++;
+        }
+        start->arcs.assignSorted(&newArcs[k], end - k);
+        k = end;
+    }
+    for (ArcType* arc : newArcs) {
+        countArc(arc, +1);
+    }
 }
 
 /*
@@ -560,8 +1127,9 @@ void Graph<NodeType, ArcType>::clear() {
  * The addNode method appears in two forms: one that creates a node
  * from its name and one that assumes that the client has created
  * the new node.  In each case, the implementation must add the node
- * the set of nodes for the graph and add the name-to-node association
- * to the node map.
+ * the set of nodes for the graph, add the name-to-node association
+ * to the node map, and give the node an id, preferring one that an
+ * earlier call to removeNode has released.
  */
 
 template <typename NodeType, typename ArcType>
@@ -579,6 +1147,15 @@ NodeType* Graph<NodeType, ArcType>::addNode(NodeType* node) {
     }
     nodes.add(node);
     nodeMap[node->name] = node;
+    int id;
+    if (freeIds.isEmpty()) {
+        id = nodesById.size();
+        nodesById.add(node);
+    } else {
+        id = freeIds.pop();
+        nodesById[id] = node;
+    }
+    nodeIds[node] = id;
     return node;
 }
 
@@ -588,7 +1165,8 @@ NodeType* Graph<NodeType, ArcType>::addNode(NodeType* node) {
  * The removeNode method removes the specified node but must also
  * remove any arcs in the graph containing the node.  To avoid
  * changing the node set during iteration, this implementation
- * creates a vector of arcs that require deletion.
+ * creates a vector of arcs that require deletion.  The node's name
+ * and id are released so that they can be used by later nodes.
  */
 
 template <typename NodeType, typename ArcType>
@@ -598,7 +1176,7 @@ void Graph<NodeType, ArcType>::removeNode(const std::string& name) {
 
 template <typename NodeType, typename ArcType>
 void Graph<NodeType, ArcType>::removeNode(NodeType* node) {
-    Vector<ArcType*> toRemove;
+    SmallVector<ArcType*, 8> toRemove;
     for (ArcType* arc : arcs) {
         if (arc->start == node || arc->finish == node) {
             toRemove.add(arc);
@@ -608,6 +1186,13 @@ void Graph<NodeType, ArcType>::removeNode(NodeType* node) {
         removeArc(arc);
     }
     nodes.remove(node);
+    int id = getId(node);
+    if (id >= 0) {
+        nodeMap.remove(node->name);
+        nodeIds.remove(node);
+        nodesById[id] = nullptr;
+        freeIds.push(id);
+    }
 }
 
 /*
@@ -625,13 +1210,46 @@ NodeType* Graph<NodeType, ArcType>::getNode(const std::string& name) const {
 }
 
 template <typename NodeType, typename ArcType>
-NodeType* Graph<NodeType, ArcType>::getExistingNode(std::string name) const {
+NodeType* Graph<NodeType, ArcType>::getNode(int id) const {
+    if (id < 0 || id >= nodesById.size())
+        return nullptr;
+    return nodesById[id];
+}
+
+template <typename NodeType, typename ArcType>
+NodeType* Graph<NodeType, ArcType>::getExistingNode(const std::string& name) const {
     NodeType* node = nodeMap.get(name);
     if (node == nullptr)
         error("Graph class: No node named " + name);
     return node;
 }
 
+/*
+ * Implementation notes: getId, idLimit
+ * ------------------------------------
+ * The ids live in a hash map keyed by node pointer, which answers
+ * getId without comparing names.  The nodesById vector maps ids back
+ * to nodes, so its size is the id limit.
+ */
+
+template <typename NodeType, typename ArcType>
+int Graph<NodeType, ArcType>::getId(NodeType* node) const {
+    if (!nodeIds.containsKey(node))
+        return -1;
+    return nodeIds.get(node);
+}
+
+template <typename NodeType, typename ArcType>
+int Graph<NodeType, ArcType>::getId(const std::string& name) const {
+    NodeType* node = nodeMap.get(name);
+    return (node == nullptr) ? -1 : getId(node);
+}
+
+template <typename NodeType, typename ArcType>
+int Graph<NodeType, ArcType>::idLimit() const {
+    return nodesById.size();
+}
+
 /*
  * Implementation notes: addArc
  * ----------------------------
@@ -657,6 +1275,7 @@ template <typename NodeType, typename ArcType>
 ArcType* Graph<NodeType, ArcType>::addArc(ArcType* arc) {
     arc->start->arcs.add(arc);
     arcs.add(arc);
+    countArc(arc, +1);
     return arc;
 }
 
@@ -668,7 +1287,9 @@ ArcType* Graph<NodeType, ArcType>::addArc(ArcType* arc) {
  * graph as a whole and the set of arcs in the starting node.  The
  * methods that remove an arc specified by its endpoints, however,
  * must take account of the fact that there might be more than one
- * such arc and delete all of them.
+ * such arc and delete all of them.  Those arcs all leave n1, so only
+ * its arc set needs to be searched, and not even that if the arc
+ * counts show that the nodes are not connected.
  */
 
 template <typename NodeType, typename ArcType>
@@ -678,8 +1299,10 @@ void Graph<NodeType, ArcType>::removeArc(const std::string& s1, const std::strin
 
 template <typename NodeType, typename ArcType>
 void Graph<NodeType, ArcType>::removeArc(NodeType* n1, NodeType* n2) {
-    Vector<ArcType*> toRemove;
-    for (ArcType* arc : arcs) {
+    if (!isConnected(n1, n2))
+        return;
+    SmallVector<ArcType*, 8> toRemove;
+    for (ArcType* arc : n1->arcs) {
         if (arc->start == n1 && arc->finish == n2) {
             toRemove.add(arc);
         }
@@ -691,25 +1314,56 @@ void Graph<NodeType, ArcType>::removeArc(NodeType* n1, NodeType* n2) {
 
 template <typename NodeType, typename ArcType>
 void Graph<NodeType, ArcType>::removeArc(ArcType* arc) {
-    arc->start->arcs.remove(arc);
-    arcs.remove(arc);
+    if (arcs.contains(arc)) {
+        arc->start->arcs.remove(arc);
+        arcs.remove(arc);
+        countArc(arc, -1);
+    }
+}
+
+/*
+ * Private methods: countArc, arcKey
+ * ---------------------------------
+ * The arcCounts map records how many arcs join each ordered pair of
+ * nodes, keyed by packing the two node ids into one 64-bit integer.
+ * The ids are shifted as unsigned values, so the key is well defined
+ * even for the id of -1 that getId returns for a foreign node.
+ * Pairs whose count drops to zero are removed from the map, so a pair
+ * is connected exactly when its key is present.
+ */
+
+template <typename NodeType, typename ArcType>
+void Graph<NodeType, ArcType>::countArc(ArcType* arc, int delta) {
+    long long key = arcKey(getId(arc->start), getId(arc->finish));
+    int count = arcCounts.get(key) + delta;
+    if (count > 0) {
+        arcCounts.put(key, count);
+    } else {
+        arcCounts.remove(key);
+    }
+}
+
+template <typename NodeType, typename ArcType>
+long long Graph<NodeType, ArcType>::arcKey(int id1, int id2) {
+    return (long long) (((unsigned long long) (unsigned int) id1 << 32) | (unsigned int) id2);
 }
 
 /*
  * Implementation notes: isConnected
  * ---------------------------------
- * Node n1 is connected to n2 if any of the arcs leaving n1 finish at n2.
+ * Node n1 is connected to n2 if any of the arcs leaving n1 finish at n2,
+ * which is the case exactly when arcCounts has an entry for the pair.
  * The two versions of this method allow nodes to be specified either as
  * node pointers or by name.
  */
 
 template <typename NodeType, typename ArcType>
 bool Graph<NodeType, ArcType>::isConnected(NodeType* n1, NodeType* n2) const {
-    for (ArcType* arc : n1->arcs) {
-        if (arc->finish == n2)
-            return true;
-    }
-    return false;
+    int id1 = getId(n1);
+    int id2 = getId(n2);
+    if (id1 < 0 || id2 < 0)
+        return false;
+    return arcCounts.containsKey(arcKey(id1, id2));
 }
 
 template <typename NodeType, typename ArcType>
@@ -766,6 +1420,28 @@ const Set<NodeType*> Graph<NodeType, ArcType>::getNeighbors(const std::string& n
     return getNeighbors(getExistingNode(node));
 }
 
+/*
+ * Implementation notes: getNeighborView
+ * -------------------------------------
+ * The view holds only a pointer to the arc set of the node, so creating
+ * one costs nothing regardless of the degree of the node.
+ */
+
+template <typename NodeType, typename ArcType>
+typename Graph<NodeType, ArcType>::NeighborView Graph<NodeType, ArcType>::getNeighborView(NodeType* node) const {
+    return NeighborView(node->arcs);
+}
+
+template <typename NodeType, typename ArcType>
+typename Graph<NodeType, ArcType>::NeighborView Graph<NodeType, ArcType>::getNeighborView(const std::string& name) const {
+    return NeighborView(getExistingNode(name)->arcs);
+}
+
+template <typename NodeType, typename ArcType>
+CompactGraph<NodeType, ArcType> Graph<NodeType, ArcType>::freeze() const {
+    return CompactGraph<NodeType, ArcType>(*this);
+}
+
 /*
  * Implementation notes: operator=, copy constructor
  * -------------------------------------------------
@@ -789,21 +1465,62 @@ Graph<NodeType, ArcType>::Graph(const Graph& src) {
     deepCopy(src);
 }
 
+/*
+ * Implementation notes: move operator=, move constructor
+ * ------------------------------------------------------
+ * Moving a graph transfers ownership of the existing nodes and arcs
+ * instead of rebuilding them, and leaves the source graph empty.
+ */
+
+template <typename NodeType, typename ArcType>
+Graph<NodeType, ArcType>& Graph<NodeType, ArcType>::operator=(Graph&& src) {
+    if (this != &src) {
+        clear();
+        nodes = std::move(src.nodes);
+        arcs = std::move(src.arcs);
+        nodeMap = std::move(src.nodeMap);
+        nodeIds = std::move(src.nodeIds);
+        nodesById = std::move(src.nodesById);
+        freeIds = std::move(src.freeIds);
+        arcCounts = std::move(src.arcCounts);
+    }
+    return *this;
+}
+
+template <typename NodeType, typename ArcType>
+Graph<NodeType, ArcType>::Graph(Graph&& src)
+    : nodes(std::move(src.nodes)),
+      arcs(std::move(src.arcs)),
+      nodeMap(std::move(src.nodeMap)),
+      nodeIds(std::move(src.nodeIds)),
+      nodesById(std::move(src.nodesById)),
+      freeIds(std::move(src.freeIds)),
+      arcCounts(std::move(src.arcCounts)) {
+    /* Empty */
+}
+
 /*
  * Private method: deepCopy
  * ------------------------
  * Common code factored out of the copy constructor and operator= to
- * copy the contents from the other graph.
+ * copy the contents from the other graph.  The nodes are copied in id
+ * order, with placeholders for unused ids, so that each copy has the
+ * same id as its original.
  */
 
 template <typename NodeType, typename ArcType>
 void Graph<NodeType, ArcType>::deepCopy(const Graph& src) {
-    for (NodeType* oldNode : src.nodes) {
+    for (NodeType* oldNode : src.nodesById) {
+        if (oldNode == nullptr) {
+            nodesById.add(nullptr);
+            continue;
+        }
         NodeType* newNode = new NodeType();
         *newNode = *oldNode;
         newNode->arcs.clear();
         addNode(newNode);
     }
+    freeIds = src.freeIds;
     for (ArcType* oldArc : src.arcs) {
         ArcType* newArc = new ArcType();
         *newArc = *oldArc;
@@ -888,6 +1605,9 @@ NodeType* Graph<NodeType, ArcType>::scanNode(TokenScanner& scanner) {
  * contain client-specific data.  To ensure that this information is
  * correctly written and read by these operators, clients must override
  * the methods writeNodeData, writeArcData, scanNodeData, and scanArcData.
+ * The extraction operator reads one token at a time and inserts each
+ * node and arc separately, so large graphs without such data load far
+ * faster with the GraphReader class in graphreader.h.
  */
 
 template <typename NodeType, typename ArcType>
@@ -936,4 +1656,558 @@ std::istream& operator>>(std::istream& is, Graph<NodeType, ArcType>& g) {
     return is;
 }
 
+/*
+ * Implementation notes: GraphSpan
+ * -------------------------------
+ * A span is just a pointer and a length, so every method is a single
+ * expression.
+ */
+
+template <typename ValueType>
+GraphSpan<ValueType>::GraphSpan(const ValueType* array, int n) {
+    this->first = array;
+    this->n = n;
+}
+
+template <typename ValueType>
+int GraphSpan<ValueType>::size() const {
+    return n;
+}
+
+template <typename ValueType>
+bool GraphSpan<ValueType>::isEmpty() const {
+    return n == 0;
+}
+
+template <typename ValueType>
+const ValueType& GraphSpan<ValueType>::operator[](int index) const {
+#ifndef SPL_UNCHECKED_INDEXING
+    if (index < 0 || index >= n)
+        error("GraphSpan index out of range");
+#endif
+    return first[index];
+}
+
+template <typename ValueType>
+const ValueType* GraphSpan<ValueType>::begin() const {
+    return first;
+}
+
+template <typename ValueType>
+const ValueType* GraphSpan<ValueType>::end() const {
+    return first + n;
+}
+
+/*
+ * Implementation notes: CompactGraph constructor
+ * ----------------------------------------------
+ * The constructor copies the nodes in id order, records their ids in
+ * the order in which the graph iterates over them, which is the order
+ * of their names, and then makes a pass over the arc set of each node
+ * to fill in the arrays, so the arcs of a node appear in the same order
+ * as in its arc set.  The graph's own map from nodes to ids resolves the
+ * finish node of each arc without comparing any names.  Every array is
+ * reserved at its final size before it is filled.
+ */
+
+template <typename NodeType, typename ArcType>
+CompactGraph<NodeType, ArcType>::CompactGraph() {
+    offsetList.add(0);
+}
+
+template <typename NodeType, typename ArcType>
+CompactGraph<NodeType, ArcType>::CompactGraph(const Graph<NodeType, ArcType>& graph) {
+    int nIds = graph.idLimit();
+    int nArcs = graph.getArcSet().size();
+    nodeList.reserve(nIds);
+    nameOrder.reserve(graph.size());
+    offsetList.reserve(nIds + 1);
+    targetList.reserve(nArcs);
+    costList.reserve(nArcs);
+    arcList.reserve(nArcs);
+    for (int id = 0; id < nIds; id++) {
+        nodeList.add(graph.getNode(id));
+    }
+    for (NodeType* node : graph.getNodeSet()) {
+        nameOrder.add(graph.getId(node));
+    }
+    offsetList.add(0);
+    for (NodeType* node : nodeList) {
+        if (node != nullptr) {
+            for (ArcType* arc : node->arcs) {
+                targetList.add(graph.getId(arc->finish));
+                costList.add(arc->cost);
+                arcList.add(arc);
+            }
+        }
+        offsetList.add(targetList.size());
+    }
+}
+
+template <typename NodeType, typename ArcType>
+int CompactGraph<NodeType, ArcType>::size() const {
+    return nameOrder.size();
+}
+
+template <typename NodeType, typename ArcType>
+bool CompactGraph<NodeType, ArcType>::isEmpty() const {
+    return nameOrder.isEmpty();
+}
+
+template <typename NodeType, typename ArcType>
+int CompactGraph<NodeType, ArcType>::idLimit() const {
+    return nodeList.size();
+}
+
+template <typename NodeType, typename ArcType>
+int CompactGraph<NodeType, ArcType>::arcCount() const {
+    return targetList.size();
+}
+
+/*
+ * Implementation notes: getId
+ * ---------------------------
+ * The nameOrder array lists the ids in the order defined by
+ * Graph::compare, so both forms of getId can find a node by binary
+ * search.  Names are unique within a graph, which lets the second form
+ * compare names alone.
+ */
+
+template <typename NodeType, typename ArcType>
+int CompactGraph<NodeType, ArcType>::getId(NodeType* node) const {
+    int lh = 0;
+    int rh = nameOrder.size() - 1;
+    while (lh <= rh) {
+        int mid = lh + (rh - lh) / 2;
+        int cmp = Graph<NodeType, ArcType>::compare(node, nodeList[nameOrder[mid]]);
+        if (cmp == 0)
+            return nameOrder[mid];
+        if (cmp < 0) {
+            rh = mid - 1;
+        } else {
+            lh = mid + 1;
+        }
+    }
+    return -1;
+}
+
+template <typename NodeType, typename ArcType>
+int CompactGraph<NodeType, ArcType>::getId(const std::string& name) const {
+    int lh = 0;
+    int rh = nameOrder.size() - 1;
+    while (lh <= rh) {
+        int mid = lh + (rh - lh) / 2;
+        int cmp = name.compare(nodeList[nameOrder[mid]]->name);
+        if (cmp == 0)
+            return nameOrder[mid];
+        if (cmp < 0) {
+            rh = mid - 1;
+        } else {
+            lh = mid + 1;
+        }
+    }
+    return -1;
+}
+
+template <typename NodeType, typename ArcType>
+NodeType* CompactGraph<NodeType, ArcType>::getNode(int id) const {
+    checkId(id, "getNode");
+    return nodeList[id];
+}
+
+template <typename NodeType, typename ArcType>
+int CompactGraph<NodeType, ArcType>::degree(int id) const {
+    checkId(id, "degree");
+    return offsetList[id + 1] - offsetList[id];
+}
+
+template <typename NodeType, typename ArcType>
+GraphSpan<int> CompactGraph<NodeType, ArcType>::neighbors(int id) const {
+    checkId(id, "neighbors");
+    int start = offsetList[id];
+    return GraphSpan<int>(targetList.data() + start, offsetList[id + 1] - start);
+}
+
+template <typename NodeType, typename ArcType>
+GraphSpan<double> CompactGraph<NodeType, ArcType>::costs(int id) const {
+    checkId(id, "costs");
+    int start = offsetList[id];
+    return GraphSpan<double>(costList.data() + start, offsetList[id + 1] - start);
+}
+
+template <typename NodeType, typename ArcType>
+GraphSpan<ArcType*> CompactGraph<NodeType, ArcType>::arcs(int id) const {
+    checkId(id, "arcs");
+    int start = offsetList[id];
+    return GraphSpan<ArcType*>(arcList.data() + start, offsetList[id + 1] - start);
+}
+
+template <typename NodeType, typename ArcType>
+const Vector<int>& CompactGraph<NodeType, ArcType>::getOffsets() const {
+    return offsetList;
+}
+
+template <typename NodeType, typename ArcType>
+const Vector<int>& CompactGraph<NodeType, ArcType>::getTargets() const {
+    return targetList;
+}
+
+template <typename NodeType, typename ArcType>
+const Vector<double>& CompactGraph<NodeType, ArcType>::getCosts() const {
+    return costList;
+}
+
+template <typename NodeType, typename ArcType>
+const Vector<ArcType*>& CompactGraph<NodeType, ArcType>::getArcs() const {
+    return arcList;
+}
+
+/*
+ * Implementation notes: reversed
+ * ------------------------------
+ * The reversed arrays are filled by a counting sort on finish node.
+ * Because the source nodes are visited in id order, the incoming arcs
+ * of each node end up sorted by the id of the node they come from.
+ */
+
+template <typename NodeType, typename ArcType>
+CompactGraph<NodeType, ArcType> CompactGraph<NodeType, ArcType>::reversed() const {
+    int n = idLimit();
+    int m = arcCount();
+    CompactGraph result;
+    result.nodeList = nodeList;
+    result.nameOrder = nameOrder;
+    result.owned = owned;
+    result.offsetList = Vector<int>(n + 1, 0);
+    for (int arc = 0; arc < m; arc++) {
+        result.offsetList[targetList[arc] + 1]++;
+    }
+    for (int id = 0; id < n; id++) {
+        result.offsetList[id + 1] += result.offsetList[id];
+    }
+    result.targetList = Vector<int>(m);
+    result.costList = Vector<double>(m);
+    result.arcList = Vector<ArcType*>(m);
+    Vector<int> next = result.offsetList;
+    for (int id = 0; id < n; id++) {
+        for (int arc = offsetList[id]; arc < offsetList[id + 1]; arc++) {
+            int pos = next[targetList[arc]]++;
+            result.targetList[pos] = id;
+            result.costList[pos] = costList[arc];
+            result.arcList[pos] = arcList[arc];
+        }
+    }
+    return result;
+}
+
+/*
+ * Implementation notes: parallelBreadthFirstSearch
+ * ------------------------------------------------
+ * The search keeps the depth of every node in an array of atomic
+ * integers and builds the tree one level at a time, using one of two
+ * strategies for each level:
+ *
+ * - Top-down: the frontier is divided among the threads, which follow
+ *   the arcs leaving their frontier nodes and claim each unreached
+ *   neighbor with a compare-and-swap, so exactly one thread adds it to
+ *   the next frontier.
+ *
+ * - Bottom-up: all the nodes are divided among the threads, which look
+ *   through the incoming arcs of each unreached node for one from the
+ *   frontier and stop at the first they find.  Each node is written
+ *   only by the thread that owns it, so no compare-and-swap is needed.
+ *
+ * Following the heuristic of Beamer, Asanovic, and Patterson, the
+ * search switches to bottom-up when the arcs leaving the frontier
+ * outnumber the arcs leaving unreached nodes divided by
+ * BOTTOM_UP_ARC_RATIO, and back to top-down once the frontier holds
+ * fewer than one node in TOP_DOWN_NODE_RATIO.  The incoming arcs are
+ * needed only by a level that runs bottom-up.  The work of each level
+ * is divided into fixed chunks of PARALLEL_GRAIN items, each of which
+ * collects its part of the next frontier separately, and the parts are
+ * joined in chunk order.
+ */
+
+template <typename NodeType, typename ArcType>
+Vector<int> CompactGraph<NodeType, ArcType>::parallelBreadthFirstSearch(int source,
+                                                                        ThreadPool& pool) const {
+    checkId(source, "parallelBreadthFirstSearch");
+    int n = idLimit();
+    std::unique_ptr<std::atomic<int>[]> depth(new std::atomic<int>[n]);
+    pool.parallelFor(n, PARALLEL_GRAIN, [&depth](int start, int end) {
+        for (int id = start; id < end; id++) {
+            depth[id].store(-1, std::memory_order_relaxed);
+        }
+    });
+    depth[source].store(0, std::memory_order_relaxed);
+    Vector<int> frontier;
+    frontier.add(source);
+    long frontierArcs = degree(source);
+    long unexploredArcs = arcCount() - frontierArcs;
+    bool bottomUp = false;
+    const IncomingArcs* reverse = nullptr;
+    for (int level = 0; !frontier.isEmpty(); level++) {
+        if (bottomUp) {
+            bottomUp = frontier.size() * long(TOP_DOWN_NODE_RATIO) >= n;
+        } else {
+            bottomUp = frontierArcs * BOTTOM_UP_ARC_RATIO > unexploredArcs;
+        }
+        if (bottomUp && reverse == nullptr)
+            reverse = &getIncomingArcs();
+        int nItems = bottomUp ? n : frontier.size();
+        int nChunks = (nItems + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+        Vector<Vector<int>> parts(nChunks);
+        Vector<long> partArcs(nChunks, 0);
+        pool.parallelFor(nChunks, 1, [&](int firstChunk, int lastChunk) {
+            for (int chunk = firstChunk; chunk < lastChunk; chunk++) {
+                int start = chunk * PARALLEL_GRAIN;
+                int end = std::min(nItems, start + PARALLEL_GRAIN);
+                Vector<int>& part = parts[chunk];
+                long arcs = 0;
+                for (int i = start; i < end; i++) {
+                    if (bottomUp) {
+                        if (depth[i].load(std::memory_order_relaxed) >= 0)
+                            continue;
+                        const Vector<int>& sources = reverse->sources;
+                        for (int arc = reverse->offsets[i]; arc < reverse->offsets[i + 1]; arc++) {
+                            if (depth[sources[arc]].load(std::memory_order_relaxed) == level) {
+                                depth[i].store(level + 1, std::memory_order_relaxed);
+                                part.add(i);
+                                arcs += offsetList[i + 1] - offsetList[i];
+                                break;
+                            }
+                        }
+                    } else {
+                        int id = frontier[i];
+                        for (int arc = offsetList[id]; arc < offsetList[id + 1]; arc++) {
+                            int next = targetList[arc];
+                            int unreached = -1;
+                            if (depth[next].load(std::memory_order_relaxed) == -1
+                                    && depth[next].compare_exchange_strong(unreached, level + 1,
+                                                                           std::memory_order_relaxed)) {
+                                part.add(next);
+                                arcs += offsetList[next + 1] - offsetList[next];
+                            }
+                        }
+                    }
+                }
+                partArcs[chunk] = arcs;
+            }
+        });
+        frontier.clear();
+        frontierArcs = 0;
+        for (int i = 0; i < nChunks; i++) {
+            frontier.appendAll(parts[i]);
+            frontierArcs += partArcs[i];
+        }
+        unexploredArcs -= frontierArcs;
+    }
+    Vector<int> result(n);
+    int* array = result.data();
+    pool.parallelFor(n, PARALLEL_GRAIN, [array, &depth](int start, int end) {
+        for (int id = start; id < end; id++) {
+            array[id] = depth[id].load(std::memory_order_relaxed);
+        }
+    });
+    return result;
+}
+
+/*
+ * Implementation notes: parallelConnectedComponents
+ * -------------------------------------------------
+ * The components are found with a concurrent union-find structure in an
+ * array of atomic parent links.  Every thread takes a range of nodes and
+ * unites each node with the finish of each of its arcs.  A union links
+ * the root with the larger id to the one with the smaller id using a
+ * compare-and-swap, which fails and is retried if another thread has
+ * linked that root in the meantime.  Since links always point to smaller
+ * ids, the structure never forms a cycle, and the root of each
+ * component is its lowest node id.  Finding a root halves the path as it
+ * goes, which is safe to do concurrently because it only ever replaces a
+ * link with one to an ancestor.  A final pass finds the root of every
+ * node, and a serial pass numbers the roots in id order, skipping the
+ * ids that belong to no node.
+ */
+
+template <typename NodeType, typename ArcType>
+Vector<int> CompactGraph<NodeType, ArcType>::parallelConnectedComponents(ThreadPool& pool) const {
+    int n = idLimit();
+    std::unique_ptr<std::atomic<int>[]> parent(new std::atomic<int>[n]);
+    std::atomic<int>* links = parent.get();
+    pool.parallelFor(n, PARALLEL_GRAIN, [links](int start, int end) {
+        for (int id = start; id < end; id++) {
+            links[id].store(id, std::memory_order_relaxed);
+        }
+    });
+    pool.parallelFor(n, PARALLEL_GRAIN, [this, links](int start, int end) {
+        for (int id = start; id < end; id++) {
+            for (int arc = offsetList[id]; arc < offsetList[id + 1]; arc++) {
+                int root1 = findRoot(links, id);
+                int root2 = findRoot(links, targetList[arc]);
+                while (root1 != root2) {
+                    if (root1 < root2)
+                        std::swap(root1, root2);
+                    int expected = root1;
+                    if (links[root1].compare_exchange_strong(expected, root2, std::memory_order_relaxed))
+                        break;
+                    root1 = findRoot(links, root1);
+                    root2 = findRoot(links, root2);
+                }
+            }
+        }
+    });
+    Vector<int> result(n);
+    int* array = result.data();
+    pool.parallelFor(n, PARALLEL_GRAIN, [array, links](int start, int end) {
+        for (int id = start; id < end; id++) {
+            array[id] = findRoot(links, id);
+        }
+    });
+    Vector<int> number(n, -1);
+    int nComponents = 0;
+    for (int id = 0; id < n; id++) {
+        if (nodeList[id] == nullptr) {
+            array[id] = -1;
+            continue;
+        }
+        int root = array[id];
+        if (number[root] < 0)
+            number[root] = nComponents++;
+        array[id] = number[root];
+    }
+    return result;
+}
+
+/*
+ * Implementation notes: parallelPageRank
+ * --------------------------------------
+ * Each iteration pulls rank along the incoming arcs of every node, so
+ * the threads write disjoint parts of the new rank vector and never
+ * contend.  A first parallel pass divides each rank by the out-degree
+ * of its node and sums the ranks of nodes without arcs.  That pass is
+ * divided into fixed chunks of PARALLEL_GRAIN nodes, each writing its
+ * own partial sum, and the partial sums are added in chunk order, so
+ * the result is the same for any number of threads.  The ids that belong
+ * to no node start with a rank of 0 and have no incoming arcs, so the
+ * second pass only has to keep them at 0.
+ */
+
+template <typename NodeType, typename ArcType>
+Vector<double> CompactGraph<NodeType, ArcType>::parallelPageRank(int iterations, double damping,
+                                                                 ThreadPool& pool) const {
+    int n = idLimit();
+    int nNodes = size();
+    if (nNodes == 0)
+        return Vector<double>(n, 0);
+    const IncomingArcs& reverse = getIncomingArcs();
+    Vector<double> rank(n, 1.0 / nNodes);
+    for (int id = 0; id < n; id++) {
+        if (nodeList[id] == nullptr)
+            rank[id] = 0;
+    }
+    Vector<double> next(n);
+    Vector<double> share(n);
+    int nChunks = (n + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+    Vector<double> partialSums(nChunks);
+    for (int i = 0; i < iterations; i++) {
+        pool.parallelFor(nChunks, 1, [&](int firstChunk, int lastChunk) {
+            for (int chunk = firstChunk; chunk < lastChunk; chunk++) {
+                int start = chunk * PARALLEL_GRAIN;
+                int end = std::min(n, start + PARALLEL_GRAIN);
+                double sum = 0;
+                for (int id = start; id < end; id++) {
+                    int outDegree = offsetList[id + 1] - offsetList[id];
+                    if (outDegree == 0) {
+                        sum += rank[id];
+                        share[id] = 0;
+                    } else {
+                        share[id] = rank[id] / outDegree;
+                    }
+                }
+                partialSums[chunk] = sum;
+            }
+        });
+        double dangling = 0;
+        for (double sum : partialSums) {
+            dangling += sum;
+        }
+        double base = (1 - damping) / nNodes + damping * dangling / nNodes;
+        pool.parallelFor(n, PARALLEL_GRAIN, [&](int start, int end) {
+            for (int id = start; id < end; id++) {
+                double sum = 0;
+                for (int arc = reverse.offsets[id]; arc < reverse.offsets[id + 1]; arc++) {
+                    sum += share[reverse.sources[arc]];
+                }
+                next[id] = (nodeList[id] == nullptr) ? 0 : base + damping * sum;
+            }
+        });
+        std::swap(rank, next);
+    }
+    return rank;
+}
+
+/*
+ * Private method: getIncomingArcs
+ * -------------------------------
+ * Returns the incoming arcs of the snapshot, building them by a counting
+ * sort on finish node if this is the first request.  The lock makes
+ * concurrent first requests build the arrays only once.
+ */
+
+template <typename NodeType, typename ArcType>
+const typename CompactGraph<NodeType, ArcType>::IncomingArcs&
+CompactGraph<NodeType, ArcType>::getIncomingArcs() const {
+    std::lock_guard<std::mutex> guard(incoming.lock);
+    if (!incoming.built) {
+        int n = idLimit();
+        incoming.offsets = Vector<int>(n + 1, 0);
+        for (int target : targetList) {
+            incoming.offsets[target + 1]++;
+        }
+        for (int id = 0; id < n; id++) {
+            incoming.offsets[id + 1] += incoming.offsets[id];
+        }
+        incoming.sources = Vector<int>(arcCount());
+        Vector<int> next = incoming.offsets;
+        for (int id = 0; id < n; id++) {
+            for (int arc = offsetList[id]; arc < offsetList[id + 1]; arc++) {
+                incoming.sources[next[targetList[arc]]++] = id;
+            }
+        }
+        incoming.built = true;
+    }
+    return incoming;
+}
+
+/*
+ * Private method: findRoot
+ * ------------------------
+ * Returns the root of the union-find tree containing a node, pointing
+ * each node on the way at its grandparent.
+ */
+
+template <typename NodeType, typename ArcType>
+int CompactGraph<NodeType, ArcType>::findRoot(std::atomic<int>* links, int id) {
+    while (true) {
+        int parent = links[id].load(std::memory_order_relaxed);
+        if (parent == id)
+            return id;
+        int grandparent = links[parent].load(std::memory_order_relaxed);
+        if (grandparent != parent)
+            links[id].store(grandparent, std::memory_order_relaxed);
+        id = grandparent;
+    }
+}
+
+template <typename NodeType, typename ArcType>
+void CompactGraph<NodeType, ArcType>::checkId(int id, const char* prefix) const {
+#ifndef SPL_UNCHECKED_INDEXING
+    if (id < 0 || id >= nodeList.size())
+        error(std::string("CompactGraph::") + prefix + ": Node id " + std::to_string(id) + " out of range");
+#else
+    (void) id;
+    (void) prefix;
+#endif
+}
+
 #endif
@@ -0,0 +1,744 @@
+/*
+ * File: graphreader.h
+ * -------------------
+ * This file exports the <code>GraphReader</code> class, which loads
+ * large graphs from text files much faster than the extraction operator
+ * for <code>Graph</code>.
+ */
+
+#ifndef _graphreader_h
+#define _graphreader_h
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "graph.h"
+#include "hashmap.h"
+#include "vector.h"
+
+/*
+ * Type: GraphFormat
+ * -----------------
+ * This enumerated type lists the text formats that a
+ * <code>GraphReader</code> accepts.  <code>GRAPH_TEXT</code> is the
+ * format written by the insertion operator for graphs, a list of node
+ * and arc entries in braces:
+ *
+ *<pre>
+ *    {A, B, C, A -> B, B - C 2.5}
+ *</pre>
+ *
+ * As with the extraction operator, <code>n1 -> n2</code> is a directed
+ * arc and <code>n1 - n2</code> stands for two arcs, one in each
+ * direction.  Names are either quoted strings or runs of letters,
+ * digits, and underscores, and an arc may be followed by its cost.
+ *
+ * <p><code>EDGE_LIST</code> is the plain format used by most graph
+ * datasets, with one entry per line:
+ *
+ *<pre>
+ *    # Comment lines start with a sharp sign
+ *    A B
+ *    B C 2.5
+ *    D
+ *</pre>
+ *
+ * A line with two names is a directed arc, optionally followed by its
+ * cost, and a line with one name is a node.  Names extend to the next
+ * space or tab.
+ */
+
+enum GraphFormat { GRAPH_TEXT, EDGE_LIST };
+
+/*
+ * Class: GraphReader<NodeType,ArcType>
+ * ------------------------------------
+ * This class reads graphs whose nodes and arcs carry no data beyond
+ * their names and costs.  It reads the file in large blocks, gives each
+ * name an id the first time it appears, and builds the graph only after
+ * the whole file has been read, when the final number of nodes and arcs
+ * is known.  It can fill in a <code>Graph</code> or build a
+ * <code>CompactGraph</code> directly, without creating a graph at all:
+ *
+ *<pre>
+ *    GraphReader&lt;NodeType,ArcType&gt; reader(EDGE_LIST);
+ *    CompactGraph&lt;NodeType,ArcType&gt; csr = reader.readCompact(infile);
+ *</pre>
+ *
+ * Graphs whose nodes or arcs have other fields must still be read with
+ * the extraction operator, which calls <code>scanNodeData</code> and
+ * <code>scanArcData</code>.
+ */
+
+template <typename NodeType, typename ArcType>
+class GraphReader {
+public:
+    /*
+     * Constructor: GraphReader
+     * Usage: GraphReader<NodeType,ArcType> reader;
+     *        GraphReader<NodeType,ArcType> reader(format);
+     * ------------------------------------------------
+     * Creates a reader for the specified format, which defaults to
+     * <code>GRAPH_TEXT</code>.
+     */
+
+    explicit GraphReader(GraphFormat format = GRAPH_TEXT);
+
+    /*
+     * Destructor: ~GraphReader
+     * ------------------------
+     * Frees the storage used by the reader.
+     */
+
+    virtual ~GraphReader();
+
+    /*
+     * Method: reserve
+     * Usage: reader.reserve(nNodes, nArcs);
+     * -------------------------------------
+     * Tells the reader how many nodes and arcs to expect, so that it can
+     * allocate its tables at their final size instead of growing them as
+     * it reads.  The numbers are only a hint and apply to every later
+     * read; an undirected entry in <code>GRAPH_TEXT</code> counts as two
+     * arcs.
+     */
+
+    void reserve(int nNodes, int nArcs);
+
+    /*
+     * Method: read
+     * Usage: reader.read(infile, g);
+     * ------------------------------
+     * Reads a graph from the stream into <code>g</code>, replacing its
+     * previous contents.  The nodes receive ids in alphabetical order.
+     * Arcs without a cost keep the cost given to them by the
+     * <code>ArcType</code> constructor.  If the text is malformed,
+     * <code>read</code> calls <code>error</code> and leaves the graph
+     * unchanged.
+     */
+
+    void read(std::istream& is, Graph<NodeType, ArcType>& g);
+
+    /*
+     * Method: readCompact
+     * Usage: CompactGraph<NodeType,ArcType> csr = reader.readCompact(infile);
+     * -----------------------------------------------------------------------
+     * Reads a graph from the stream and returns it as a
+     * <code>CompactGraph</code>, with the same ids and the same order of
+     * arcs that <code>freeze</code> would give the graph that
+     * <code>read</code> builds.  The snapshot owns its nodes and arcs,
+     * which are freed along with the last copy of it.  They belong to no
+     * graph, so the <code>arcs</code> field of each node is empty.
+     */
+
+    CompactGraph<NodeType, ArcType> readCompact(std::istream& is);
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: GraphReader data structure
+     * ------------------------------------------------
+     * Reading a graph happens in two phases.  The parser scans the text
+     * out of a large buffer, copying each name into a single reusable
+     * token string, and looks the name up in a hash map from names to
+     * ids without allocating anything unless the name is new.  Arcs are
+     * recorded as parallel arrays of start ids, finish ids, and costs.
+     * Once the text has been read, read or readCompact turns the arrays
+     * into the requested kind of graph and releases them.
+     */
+
+private:
+    /* Constants */
+
+    static const int BUFFER_SIZE = 1 << 20; /* Bytes read from the stream at once */
+
+    /* Instance variables */
+
+    GraphFormat format;               /* The format of the text            */
+    int nodeHint;                     /* Expected number of nodes          */
+    int arcHint;                      /* Expected number of arcs           */
+    std::istream* input;              /* The stream being read             */
+    std::unique_ptr<char[]> buffer;   /* The block of text being parsed    */
+    int pos;                          /* Next character in the buffer      */
+    int limit;                        /* End of the text in the buffer     */
+    int lineNumber;                   /* Line of the next character        */
+    double defaultCost;               /* The cost of an arc with none      */
+    std::string token;                /* The name or number just scanned   */
+    HashMap<std::string, int> ids;    /* One more than the id of each name */
+    Vector<std::string> names;        /* The name of each id               */
+    Vector<int> starts;               /* The start node id of each arc     */
+    Vector<int> finishes;             /* The finish node id of each arc    */
+    Vector<double> costs;             /* The cost of each arc              */
+
+    void parse(std::istream& is);
+    void parseGraphText();
+    void parseEdgeList();
+    void reset();
+    bool fill();
+    int peekChar();
+    void skipWhitespace();
+    void skipBlanks();
+    int scanNode();
+    void scanQuotedName();
+    double scanCost();
+    int intern();
+    void addArc(int start, int finish, double cost);
+    void arrange(Vector<int>& order, Vector<int>& rank, Vector<int>& placed);
+    void syntaxError(const std::string& msg) const;
+
+    template <typename Predicate>
+    void scanToken(Predicate isTokenChar);
+
+    static bool isNameChar(int ch);
+    static bool isFieldChar(int ch);
+    static bool isNumberChar(int ch);
+
+    GraphReader(const GraphReader&) = delete;
+    GraphReader& operator=(const GraphReader&) = delete;
+};
+
+template <typename NodeType, typename ArcType>
+GraphReader<NodeType, ArcType>::GraphReader(GraphFormat format) {
+    this->format = format;
+    nodeHint = 0;
+    arcHint = 0;
+    input = nullptr;
+    pos = limit = 0;
+    lineNumber = 1;
+    defaultCost = 0;
+}
+
+template <typename NodeType, typename ArcType>
+GraphReader<NodeType, ArcType>::~GraphReader() {
+    /* Empty */
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::reserve(int nNodes, int nArcs) {
+    nodeHint = std::max(nNodes, 0);
+    arcHint = std::max(nArcs, 0);
+}
+
+/*
+ * Implementation notes: read
+ * --------------------------
+ * The nodes and arcs are created in the order of the graph, which lets
+ * loadSorted build every set in the graph in linear time instead of
+ * inserting the elements one at a time.  Parallel arcs of equal cost are
+ * ordered by address in a graph, so those runs are sorted again once
+ * the arcs exist.
+ */
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::read(std::istream& is, Graph<NodeType, ArcType>& g) {
+    parse(is);
+    Vector<int> order;
+    Vector<int> rank;
+    Vector<int> placed;
+    arrange(order, rank, placed);
+    int nNodes = names.size();
+    int nArcs = starts.size();
+    Vector<NodeType*> nodes;
+    nodes.reserve(nNodes);
+    for (int i : order) {
+        NodeType* node = new NodeType();
+        node->name = std::move(names[i]);
+        nodes.add(node);
+    }
+    Vector<ArcType*> arcs;
+    arcs.reserve(nArcs);
+    for (int i : placed) {
+        ArcType* arc = new ArcType();
+        arc->start = nodes[rank[starts[i]]];
+        arc->finish = nodes[rank[finishes[i]]];
+        arc->cost = costs[i];
+        arcs.add(arc);
+    }
+    for (int k = 0; k < nArcs;) {
+        int end = k + 1;
+        NodeType* start = arcs[k]->start;
+        NodeType* finish = arcs[k]->finish;
+        while (end < nArcs && arcs[end]->start == start && arcs[end]->finish == finish) {
+            end++;
+        }
+        if (end - k > 1) {
+            std::sort(arcs.begin() + k, arcs.begin() + end, [](ArcType* a1, ArcType* a2) {
+                return Graph<NodeType, ArcType>::compare(a1, a2) < 0;
+            });
+        }
+        k = end;
+    }
+    reset();
+    g.clear();
+    g.loadSorted(nodes, arcs);
+}
+
+/*
+ * Implementation notes: readCompact
+ * ---------------------------------
+ * The arrays of the snapshot are filled in the order computed by
+ * arrange.  The arcs are stored in that order too, so parallel arcs of
+ * equal cost also end up in order of address, as in a graph.
+ */
+
+template <typename NodeType, typename ArcType>
+CompactGraph<NodeType, ArcType> GraphReader<NodeType, ArcType>::readCompact(std::istream& is) {
+    typedef typename CompactGraph<NodeType, ArcType>::OwnedElements OwnedElements;
+    parse(is);
+    Vector<int> order;
+    Vector<int> rank;
+    Vector<int> placed;
+    arrange(order, rank, placed);
+    int nNodes = names.size();
+    int nArcs = starts.size();
+    CompactGraph<NodeType, ArcType> csr;
+    csr.owned = std::make_shared<OwnedElements>();
+    csr.owned->nodes.reset(new NodeType[nNodes]());
+    csr.owned->arcs.reset(new ArcType[nArcs]());
+    csr.nodeList.reserve(nNodes);
+    csr.nameOrder.reserve(nNodes);
+    for (int id = 0; id < nNodes; id++) {
+        NodeType* node = &csr.owned->nodes[id];
+        node->name = std::move(names[order[id]]);
+        csr.nodeList.add(node);
+        csr.nameOrder.add(id);
+    }
+    csr.offsetList = Vector<int>(nNodes + 1, 0);
+    for (int i = 0; i < nArcs; i++) {
+        csr.offsetList[rank[starts[i]] + 1]++;
+    }
+    for (int id = 0; id < nNodes; id++) {
+        csr.offsetList[id + 1] += csr.offsetList[id];
+    }
+    csr.targetList.reserve(nArcs);
+    csr.costList.reserve(nArcs);
+    csr.arcList.reserve(nArcs);
+    for (int k = 0; k < nArcs; k++) {
+        int i = placed[k];
+        ArcType* arc = &csr.owned->arcs[k];
+        arc->start = csr.nodeList[rank[starts[i]]];
+        arc->finish = csr.nodeList[rank[finishes[i]]];
+        arc->cost = costs[i];
+        csr.targetList.add(rank[finishes[i]]);
+        csr.costList.add(arc->cost);
+        csr.arcList.add(arc);
+    }
+    reset();
+    return csr;
+}
+
+/*
+ * Implementation notes: arrange
+ * -----------------------------
+ * Graphs keep their nodes in order of name and their arcs in order of
+ * start node, finish node, and cost.  The arrange method sorts the names
+ * once, giving order, the ids read in alphabetical order, and rank, the
+ * position of each id in that order.  It then arranges the arcs with two
+ * passes of a stable counting sort, first by finish node and then by
+ * start node, which takes time proportional to the number of arcs.  Only
+ * runs of parallel arcs, which are rare, still need to be sorted by
+ * cost.
+ */
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::arrange(Vector<int>& order, Vector<int>& rank, Vector<int>& placed) {
+    int nNodes = names.size();
+    int nArcs = starts.size();
+    order = Vector<int>(nNodes);
+    for (int i = 0; i < nNodes; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](int i1, int i2) { return names[i1] < names[i2]; });
+    rank = Vector<int>(nNodes);
+    for (int i = 0; i < nNodes; i++) {
+        rank[order[i]] = i;
+    }
+    Vector<int> byFinish(nArcs);
+    Vector<int> next(nNodes + 1, 0);
+    for (int i = 0; i < nArcs; i++) {
+        next[rank[finishes[i]] + 1]++;
+    }
+    for (int id = 0; id < nNodes; id++) {
+        next[id + 1] += next[id];
+    }
+    for (int i = 0; i < nArcs; i++) {
+        byFinish[next[rank[finishes[i]]]++] = i;
+    }
+    next = Vector<int>(nNodes + 1, 0);
+    for (int i = 0; i < nArcs; i++) {
+        next[rank[starts[i]] + 1]++;
+    }
+    for (int id = 0; id < nNodes; id++) {
+        next[id + 1] += next[id];
+    }
+    placed = Vector<int>(nArcs);
+    for (int i : byFinish) {
+        placed[next[rank[starts[i]]]++] = i;
+    }
+    for (int k = 0; k < nArcs;) {
+        int start = starts[placed[k]];
+        int finish = finishes[placed[k]];
+        int end = k + 1;
+        while (end < nArcs && starts[placed[end]] == start && finishes[placed[end]] == finish) {
+            end++;
+        }
+        if (end - k > 1) {
+            std::stable_sort(placed.begin() + k, placed.begin() + end,
+                             [this](int i1, int i2) { return costs[i1] < costs[i2]; });
+        }
+        k = end;
+    }
+}
+
+/*
+ * Implementation notes: parse
+ * ---------------------------
+ * An arc without a cost is given the cost of a new ArcType.  The buffer
+ * and the name map are released as soon as the text has been parsed,
+ * and the arrays once the graph has been built.  Parsing starts with a
+ * call to reset in case an earlier read stopped with an error.
+ */
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::parse(std::istream& is) {
+    reset();
+    input = &is;
+    buffer.reset(new char[BUFFER_SIZE]);
+    defaultCost = ArcType().cost;
+    ids.reserve(nodeHint);
+    names.reserve(nodeHint);
+    starts.reserve(arcHint);
+    finishes.reserve(arcHint);
+    costs.reserve(arcHint);
+    if (format == EDGE_LIST) {
+        parseEdgeList();
+    } else {
+        parseGraphText();
+    }
+    input = nullptr;
+    buffer.reset();
+    ids = HashMap<std::string, int>();
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::parseGraphText() {
+    skipWhitespace();
+    if (peekChar() != '{')
+        syntaxError("Missing {");
+    pos++;
+    skipWhitespace();
+    while (peekChar() != '}') {
+        int n1 = scanNode();
+        skipWhitespace();
+        if (peekChar() == '-') {
+            pos++;
+            bool directed = peekChar() == '>';
+            if (directed)
+                pos++;
+            skipWhitespace();
+            int n2 = scanNode();
+            skipWhitespace();
+            double cost = defaultCost;
+            int ch = peekChar();
+            if (ch != ',' && ch != '}' && ch != EOF) {
+                cost = scanCost();
+                skipWhitespace();
+            }
+            addArc(n1, n2, cost);
+            if (!directed)
+                addArc(n2, n1, cost);
+        }
+        int ch = peekChar();
+        if (ch == ',') {
+            pos++;
+            skipWhitespace();
+        } else if (ch != '}') {
+            syntaxError(ch == EOF ? "Missing }" : "Unexpected character " + std::string(1, char(ch)));
+        }
+    }
+    pos++;
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::parseEdgeList() {
+    while (true) {
+        skipBlanks();
+        int ch = peekChar();
+        if (ch == EOF)
+            break;
+        if (ch == '\n') {
+            pos++;
+            lineNumber++;
+            continue;
+        }
+        if (ch == '#') {
+            while (ch != '\n' && ch != EOF) {
+                pos++;
+                ch = peekChar();
+            }
+            continue;
+        }
+        scanToken(isFieldChar);
+        int n1 = intern();
+        skipBlanks();
+        ch = peekChar();
+        if (ch == '\n' || ch == EOF)
+            continue;
+        scanToken(isFieldChar);
+        int n2 = intern();
+        skipBlanks();
+        double cost = defaultCost;
+        ch = peekChar();
+        if (ch != '\n' && ch != EOF) {
+            scanToken(isFieldChar);
+            char* end;
+            cost = std::strtod(token.c_str(), &end);
+            if (end != token.c_str() + token.length())
+                syntaxError("Illegal cost " + token);
+            skipBlanks();
+            ch = peekChar();
+            if (ch != '\n' && ch != EOF)
+                syntaxError("Too many fields");
+        }
+        addArc(n1, n2, cost);
+    }
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::reset() {
+    input = nullptr;
+    buffer.reset();
+    pos = limit = 0;
+    lineNumber = 1;
+    ids = HashMap<std::string, int>();
+    names.clear();
+    starts.clear();
+    finishes.clear();
+    costs.clear();
+}
+
+/*
+ * Implementation notes: fill, peekChar
+ * ------------------------------------
+ * Characters are consumed by advancing pos, and fill reads the next
+ * block of the stream once the buffer has been used up.  Everything
+ * else in the parser looks at the input through peekChar, which
+ * returns EOF at the end of the stream.
+ */
+
+template <typename NodeType, typename ArcType>
+bool GraphReader<NodeType, ArcType>::fill() {
+    if (pos < limit)
+        return true;
+    input->read(buffer.get(), BUFFER_SIZE);
+    pos = 0;
+    limit = int(input->gcount());
+    return limit > 0;
+}
+
+template <typename NodeType, typename ArcType>
+int GraphReader<NodeType, ArcType>::peekChar() {
+    if (pos == limit && !fill())
+        return EOF;
+    return (unsigned char) buffer[pos];
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::skipWhitespace() {
+    while (true) {
+        int ch = peekChar();
+        if (ch == '\n') {
+            lineNumber++;
+        } else if (ch == EOF || !isspace(ch)) {
+            return;
+        }
+        pos++;
+    }
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::skipBlanks() {
+    while (true) {
+        int ch = peekChar();
+        if (ch == '\n' || ch == EOF || !isspace(ch))
+            return;
+        pos++;
+    }
+}
+
+/*
+ * Implementation notes: scanToken
+ * -------------------------------
+ * The token is copied out of the buffer one block at a time rather than
+ * one character at a time.  Only a token that crosses the end of the
+ * buffer takes more than one step.
+ */
+
+template <typename NodeType, typename ArcType>
+template <typename Predicate>
+void GraphReader<NodeType, ArcType>::scanToken(Predicate isTokenChar) {
+    token.clear();
+    while (pos < limit || fill()) {
+        int start = pos;
+        while (pos < limit && isTokenChar((unsigned char) buffer[pos])) {
+            pos++;
+        }
+        token.append(buffer.get() + start, pos - start);
+        if (pos < limit)
+            return;
+    }
+}
+
+template <typename NodeType, typename ArcType>
+int GraphReader<NodeType, ArcType>::scanNode() {
+    int ch = peekChar();
+    if (ch == '"' || ch == '\'') {
+        scanQuotedName();
+    } else if (ch != EOF && isNameChar(ch)) {
+        scanToken(isNameChar);
+    } else {
+        syntaxError(ch == EOF ? "Missing }" : "Missing node name");
+    }
+    return intern();
+}
+
+/*
+ * Implementation notes: scanQuotedName
+ * ------------------------------------
+ * Quoted names use the escape sequences written by writeQuotedString
+ * and read by readQuotedString in strlib.h.
+ */
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::scanQuotedName() {
+    int delim = peekChar();
+    pos++;
+    token.clear();
+    while (true) {
+        int ch = peekChar();
+        if (ch == EOF || ch == '\n')
+            syntaxError("Unterminated string");
+        pos++;
+        if (ch == delim)
+            return;
+        if (ch == '\\') {
+            ch = peekChar();
+            if (ch == EOF)
+                syntaxError("Unterminated string");
+            pos++;
+            if (isdigit(ch) || ch == 'x') {
+                int base = 8;
+                int maxDigits = 3;
+                int nDigits = 1;
+                int result = ch - '0';
+                if (ch == 'x') {
+                    base = 16;
+                    maxDigits = 2;
+                    nDigits = 0;
+                    result = 0;
+                }
+                for (; nDigits < maxDigits; nDigits++) {
+                    ch = peekChar();
+                    if (ch == EOF || !isxdigit(ch) || (base == 8 && !isdigit(ch)))
+                        break;
+                    result = base * result + (isdigit(ch) ? ch - '0' : toupper(ch) - 'A' + 10);
+                    pos++;
+                }
+                ch = result;
+            } else {
+                switch (ch) {
+                    case 'a':
+                        ch = '\a';
+                        break;
+                    case 'b':
+                        ch = '\b';
+                        break;
+                    case 'f':
+                        ch = '\f';
+                        break;
+                    case 'n':
+                        ch = '\n';
+                        break;
+                    case 'r':
+                        ch = '\r';
+                        break;
+                    case 't':
+                        ch = '\t';
+                        break;
+                    case 'v':
+                        ch = '\v';
+                        break;
+                }
+            }
+        }
+        token += char(ch);
+    }
+}
+
+template <typename NodeType, typename ArcType>
+double GraphReader<NodeType, ArcType>::scanCost() {
+    scanToken(isNumberChar);
+    char* end;
+    double cost = std::strtod(token.c_str(), &end);
+    if (token.empty() || end != token.c_str() + token.length())
+        syntaxError("Illegal cost " + (token.empty() ? std::string(1, char(peekChar())) : token));
+    return cost;
+}
+
+/*
+ * Implementation notes: intern
+ * ----------------------------
+ * The map stores one more than each id, so that the zero it creates for
+ * a new name means that the name has no id yet.  Looking the token up
+ * as a string_view copies it only when the name is new.
+ */
+
+template <typename NodeType, typename ArcType>
+int GraphReader<NodeType, ArcType>::intern() {
+    int& slot = ids[std::string_view(token)];
+    if (slot == 0) {
+        names.add(token);
+        slot = names.size();
+    }
+    return slot - 1;
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::addArc(int start, int finish, double cost) {
+    starts.add(start);
+    finishes.add(finish);
+    costs.add(cost);
+}
+
+template <typename NodeType, typename ArcType>
+void GraphReader<NodeType, ArcType>::syntaxError(const std::string& msg) const {
+    error("GraphReader: " + msg + " on line " + std::to_string(lineNumber));
+}
+
+template <typename NodeType, typename ArcType>
+bool GraphReader<NodeType, ArcType>::isNameChar(int ch) {
+    return isalnum(ch) || ch == '_' || ch >= 0x80;
+}
+
+template <typename NodeType, typename ArcType>
+bool GraphReader<NodeType, ArcType>::isFieldChar(int ch) {
+    return !isspace(ch);
+}
+
+template <typename NodeType, typename ArcType>
+bool GraphReader<NodeType, ArcType>::isNumberChar(int ch) {
+    return isalnum(ch) || ch == '.' || ch == '+' || ch == '-';
+}
+
+#endif  // _graphreader_h
@@ -26,11 +26,176 @@
 #ifndef _grid_h
 #define _grid_h
 
+#include <algorithm>
+#include <functional>
 #include <initializer_list>
+#include <type_traits>
+#include <utility>
 
 #include "strlib.h"
 #include "vector.h"
 
+/*
+ * Class: GridSpan<ValueType>
+ * --------------------------
+ * This class is a view of a contiguous run of grid elements, such as one
+ * row of a <code>Grid</code>.  A span does not own its elements; it
+ * refers to the storage of the grid from which it was obtained and
+ * becomes invalid when that grid is resized, assigned, or destroyed.  The
+ * elements of a <code>GridSpan&lt;const ValueType&gt;</code> are read-only.
+ * Because <code>begin</code> and <code>end</code> return plain pointers,
+ * loops over a span compile to simple array loops:
+ *
+ *<pre>
+ *    for (double&amp; x : image.row(r)) {
+ *       x *= gain;
+ *    }
+ *</pre>
+ */
+
+template <typename ValueType>
+class GridSpan {
+public:
+    /*
+     * Constructor: GridSpan
+     * Usage: GridSpan<ValueType> span(array, n);
+     * ------------------------------------------
+     * Creates a span of the <code>n</code> elements starting at
+     * <code>array</code>.  Clients usually obtain spans from
+     * <code>Grid::row</code> instead.
+     */
+
+    GridSpan(ValueType* array, int n);
+
+    /*
+     * Method: size
+     * Usage: int n = span.size();
+     * ---------------------------
+     * Returns the number of elements in the span.
+     */
+
+    int size() const;
+
+    /*
+     * Operator: []
+     * Usage: span[index]
+     * ------------------
+     * Selects an element of the span.  As with <code>Vector</code>, the
+     * index is checked unless SPL_UNCHECKED_INDEXING is defined.
+     */
+
+    ValueType& operator[](int index) const;
+
+    /*
+     * Methods: data, begin, end
+     * Usage: ValueType* array = span.data();
+     * --------------------------------------
+     * Return pointers to the first element of the span and, for
+     * <code>end</code>, just past the last one.
+     */
+
+    ValueType* data() const;
+    ValueType* begin() const;
+    ValueType* end() const;
+
+    /*
+     * Method: fill
+     * Usage: span.fill(value);
+     * ------------------------
+     * Stores <code>value</code> in every element of the span.
+     */
+
+    void fill(const ValueType& value) const;
+
+private:
+    ValueType* first; /* The first element of the span */
+    int n;            /* The number of elements        */
+};
+
+/*
+ * Class: GridView<ValueType>
+ * --------------------------
+ * This class is a view of a rectangular region of a <code>Grid</code>,
+ * as returned by <code>Grid::subgrid</code>.  The rows of the region are
+ * contiguous, and consecutive rows are a fixed stride apart in the
+ * underlying array.  Like <code>GridSpan</code>, a view refers to the
+ * storage of its grid, and copying a view copies only the reference.  A
+ * <code>GridView&lt;ValueType&gt;</code> converts implicitly to a
+ * <code>GridView&lt;const ValueType&gt;</code>.
+ */
+
+template <typename ValueType>
+class GridView {
+public:
+    /*
+     * Constructor: GridView
+     * Usage: GridView<ValueType> view(origin, nRows, nCols, stride);
+     * --------------------------------------------------------------
+     * Creates a view of <code>nRows</code> rows of <code>nCols</code>
+     * elements each, in which row <code>r</code> begins at
+     * <code>origin + r * stride</code>.
+     */
+
+    GridView(ValueType* origin, int nRows, int nCols, int stride);
+
+    template <typename OtherType,
+              typename = typename std::enable_if<std::is_convertible<OtherType*, ValueType*>::value>::type>
+    GridView(const GridView<OtherType>& view);
+
+    /*
+     * Methods: numRows, numCols, stride
+     * Usage: int nRows = view.numRows();
+     * ----------------------------------
+     * Return the dimensions of the view and the distance, in elements,
+     * between the starts of consecutive rows.
+     */
+
+    int numRows() const;
+    int numCols() const;
+    int stride() const;
+
+    /*
+     * Methods: row, []
+     * Usage: GridSpan<ValueType> span = view.row(r);
+     *        view[r][c]
+     * ---------------------------------------------
+     * Returns row <code>r</code> of the view as a contiguous span.  The
+     * row index is checked unless SPL_UNCHECKED_INDEXING is defined.
+     */
+
+    GridSpan<ValueType> row(int r) const;
+    GridSpan<ValueType> operator[](int r) const;
+
+    /*
+     * Method: fill
+     * Usage: view.fill(value);
+     * ------------------------
+     * Stores <code>value</code> in every element of the view.
+     */
+
+    void fill(const ValueType& value) const;
+
+    /*
+     * Method: copyFrom
+     * Usage: view.copyFrom(src);
+     * --------------------------
+     * Copies the elements of <code>src</code>, which must have the same
+     * dimensions as this view, into this view.  The two views may overlap,
+     * as when shifting part of a grid within itself.
+     */
+
+    void copyFrom(const GridView<const typename std::remove_const<ValueType>::type>& src) const;
+
+private:
+    ValueType* origin; /* The first element of row 0            */
+    int nRows;         /* The number of rows in the view        */
+    int nCols;         /* The number of columns in the view     */
+    int rowStride;     /* Elements between the starts of rows   */
+
+    template <typename OtherType>
+    friend class GridView;
+};
+
 /*
  * Class: Grid<ValueType>
  * ----------------------
@@ -157,6 +322,66 @@ public:
     GridRow operator[](int row);
     const GridRow operator[](int row) const;
 
+    /*
+     * Method: at_unchecked
+     * Usage: grid.at_unchecked(row, col)
+     * ----------------------------------
+     * Returns a reference to the element at the specified position without
+     * checking the indices, even when bounds checking is enabled.  A
+     * position outside the grid has undefined behavior.
+     */
+
+    ValueType& at_unchecked(int row, int col);
+    const ValueType& at_unchecked(int row, int col) const;
+
+    /*
+     * Method: data
+     * Usage: ValueType* array = grid.data();
+     * --------------------------------------
+     * Returns a pointer to the array that holds the elements of this grid
+     * in row-major order, so that the element at <code>row</code>,
+     * <code>col</code> is <code>array[row * grid.numCols() + col]</code>.
+     * The pointer remains valid until the grid is resized or assigned.
+     */
+
+    ValueType* data();
+    const ValueType* data() const;
+
+    /*
+     * Method: row
+     * Usage: GridSpan<ValueType> span = grid.row(row);
+     * ------------------------------------------------
+     * Returns the specified row of this grid as a contiguous span, through
+     * which the row can be processed without the per-element overhead of
+     * <code>get</code> and <code>set</code>.  This method signals an error
+     * if the row is outside the grid.
+     */
+
+    GridSpan<ValueType> row(int row);
+    GridSpan<const ValueType> row(int row) const;
+
+    /*
+     * Method: subgrid
+     * Usage: GridView<ValueType> view = grid.subgrid(row, col, nRows, nCols);
+     * -----------------------------------------------------------------------
+     * Returns a view of the <code>nRows</code>-by-<code>nCols</code> region
+     * whose upper left corner is at <code>row</code>, <code>col</code>.
+     * Changes made through the view change this grid.  This method signals
+     * an error if the region does not lie within the grid.
+     */
+
+    GridView<ValueType> subgrid(int row, int col, int nRows, int nCols);
+    GridView<const ValueType> subgrid(int row, int col, int nRows, int nCols) const;
+
+    /*
+     * Method: fill
+     * Usage: grid.fill(value);
+     * ------------------------
+     * Stores <code>value</code> in every element of this grid.
+     */
+
+    void fill(const ValueType& value);
+
     /*
      * Method: toString
      * Usage: string str = grid.toString();
@@ -203,6 +428,13 @@ private:
     /* of the implementation and should not be of interest to clients.    */
     /**********************************************************************/
 
+    /*
+     * Implementation notes: bounds checking
+     * -------------------------------------
+     * As in Vector, get, set, and the [] operators check their indices
+     * unless SPL_UNCHECKED_INDEXING is defined.
+     */
+
     /*
      * Implementation notes: Grid data structure
      * -----------------------------------------
@@ -270,6 +502,30 @@ public:
         deepCopy(src);
     }
 
+    /*
+     * Move support
+     * ------------
+     * Moving a grid transfers its element array, leaving the source
+     * grid with no rows and no columns.
+     */
+
+    Grid(Grid&& src) noexcept : elements(src.elements), nRows(src.nRows), nCols(src.nCols) {
+        src.elements = nullptr;
+        src.nRows = src.nCols = 0;
+    }
+
+    Grid& operator=(Grid&& src) noexcept {
+        if (this != &src) {
+            delete[] elements;
+            elements = src.elements;
+            nRows = src.nRows;
+            nCols = src.nCols;
+            src.elements = nullptr;
+            src.nRows = src.nCols = 0;
+        }
+        return *this;
+    }
+
     /*
      * Iterator support
      * ----------------
@@ -350,18 +606,22 @@ public:
         }
 
         ValueType& operator[](int col) {
+#ifndef SPL_UNCHECKED_INDEXING
             extern void error(std::string msg);
             if (!gp->inBounds(row, col)) {
                 error("Grid index values out of range");
             }
+#endif
             return gp->elements[(row * gp->nCols) + col];
         }
 
         ValueType operator[](int col) const {
+#ifndef SPL_UNCHECKED_INDEXING
             extern void error(std::string msg);
             if (!gp->inBounds(row, col)) {
                 error("Grid index values out of range");
             }
+#endif
             return gp->elements[(row * gp->nCols) + col];
         }
 
@@ -460,23 +720,29 @@ bool Grid<ValueType>::inBounds(int row, int col) const {
 
 template <typename ValueType>
 ValueType Grid<ValueType>::get(int row, int col) {
+#ifndef SPL_UNCHECKED_INDEXING
     if (!inBounds(row, col))
         error("get: Grid indices out of bounds");
+#endif
     return elements[(row * nCols) + col];
 }
 
 template <typename ValueType>
 const ValueType& Grid<ValueType>::get(int row, int col) const {
+#ifndef SPL_UNCHECKED_INDEXING
     if (!inBounds(row, col))
         error("get: Grid indices out of bounds");
+#endif
     return elements[(row * nCols) + col];
 }
 
 template <typename ValueType>
 void Grid<ValueType>::set(int row, int col, ValueType value) {
+#ifndef SPL_UNCHECKED_INDEXING
     if (!inBounds(row, col))
         error("set: Grid indices out of bounds");
-    elements[(row * nCols) + col] = value;
+#endif
+    elements[(row * nCols) + col] = std::move(value);
 }
 
 template <typename ValueType>
@@ -486,34 +752,88 @@ typename Grid<ValueType>::GridRow Grid<ValueType>::operator[](int row) {
 
 template <typename ValueType>
 const typename Grid<ValueType>::GridRow Grid<ValueType>::operator[](int row) const {
-    return GridRow(this, row);
+    return GridRow(const_cast<Grid*>(this), row);
+}
+
+template <typename ValueType>
+ValueType& Grid<ValueType>::at_unchecked(int row, int col) {
+    return elements[(row * nCols) + col];
+}
+
+template <typename ValueType>
+const ValueType& Grid<ValueType>::at_unchecked(int row, int col) const {
+    return elements[(row * nCols) + col];
+}
+
+template <typename ValueType>
+ValueType* Grid<ValueType>::data() {
+    return elements;
+}
+
+template <typename ValueType>
+const ValueType* Grid<ValueType>::data() const {
+    return elements;
+}
+
+template <typename ValueType>
+GridSpan<ValueType> Grid<ValueType>::row(int row) {
+    if (row < 0 || row >= nRows)
+        error("row: Grid row out of bounds");
+    return GridSpan<ValueType>(elements + row * nCols, nCols);
+}
+
+template <typename ValueType>
+GridSpan<const ValueType> Grid<ValueType>::row(int row) const {
+    if (row < 0 || row >= nRows)
+        error("row: Grid row out of bounds");
+    return GridSpan<const ValueType>(elements + row * nCols, nCols);
+}
+
+template <typename ValueType>
+GridView<ValueType> Grid<ValueType>::subgrid(int row, int col, int nRows, int nCols) {
+    if (row < 0 || col < 0 || nRows < 0 || nCols < 0 || row + nRows > this->nRows
+        || col + nCols > this->nCols) {
+        error("subgrid: Region is not inside the grid");
+    }
+    return GridView<ValueType>(elements + row * this->nCols + col, nRows, nCols, this->nCols);
+}
+
+template <typename ValueType>
+GridView<const ValueType> Grid<ValueType>::subgrid(int row, int col, int nRows, int nCols) const {
+    return const_cast<Grid*>(this)->subgrid(row, col, nRows, nCols);
 }
 
+template <typename ValueType>
+void Grid<ValueType>::fill(const ValueType& value) {
+    std::fill(elements, elements + nRows * nCols, value);
+}
+
+/*
+ * Implementation notes: mapAll
+ * ----------------------------
+ * Row-major order is the order of the underlying array, so the mapAll
+ * methods walk the array directly rather than indexing each element.
+ */
+
 template <typename ValueType>
 void Grid<ValueType>::mapAll(void (*fn)(ValueType value)) const {
-    for (int i = 0; i < nRows; i++) {
-        for (int j = 0; j < nCols; j++) {
-            fn(get(i, j));
-        }
+    for (int i = 0; i < nRows * nCols; i++) {
+        fn(elements[i]);
     }
 }
 
 template <typename ValueType>
 void Grid<ValueType>::mapAll(void (*fn)(const ValueType& value)) const {
-    for (int i = 0; i < nRows; i++) {
-        for (int j = 0; j < nCols; j++) {
-            fn(get(i, j));
-        }
+    for (int i = 0; i < nRows * nCols; i++) {
+        fn(elements[i]);
     }
 }
 
 template <typename ValueType>
 template <typename FunctorType>
 void Grid<ValueType>::mapAll(FunctorType fn) const {
-    for (int i = 0; i < nRows; i++) {
-        for (int j = 0; j < nCols; j++) {
-            fn(get(i, j));
-        }
+    for (int i = 0; i < nRows * nCols; i++) {
+        fn(elements[i]);
     }
 }
 
@@ -568,4 +888,129 @@ std::istream& operator>>(std::istream& is, Grid<ValueType>& grid) {
     }
     return is;
 }
+
+/*
+ * Implementation notes: GridSpan and GridView
+ * -------------------------------------------
+ * Spans and views are a pointer and a few integers, so they are passed
+ * and returned by value.  Their methods are const because they never
+ * change which elements a view refers to.
+ */
+
+template <typename ValueType>
+GridSpan<ValueType>::GridSpan(ValueType* array, int n) : first(array), n(n) {
+    /* Empty */
+}
+
+template <typename ValueType>
+int GridSpan<ValueType>::size() const {
+    return n;
+}
+
+template <typename ValueType>
+ValueType& GridSpan<ValueType>::operator[](int index) const {
+#ifndef SPL_UNCHECKED_INDEXING
+    if (index < 0 || index >= n)
+        error("GridSpan index out of range");
+#endif
+    return first[index];
+}
+
+template <typename ValueType>
+ValueType* GridSpan<ValueType>::data() const {
+    return first;
+}
+
+template <typename ValueType>
+ValueType* GridSpan<ValueType>::begin() const {
+    return first;
+}
+
+template <typename ValueType>
+ValueType* GridSpan<ValueType>::end() const {
+    return first + n;
+}
+
+template <typename ValueType>
+void GridSpan<ValueType>::fill(const ValueType& value) const {
+    std::fill(first, first + n, value);
+}
+
+template <typename ValueType>
+GridView<ValueType>::GridView(ValueType* origin, int nRows, int nCols, int stride)
+    : origin(origin), nRows(nRows), nCols(nCols), rowStride(stride) {
+    /* Empty */
+}
+
+template <typename ValueType>
+template <typename OtherType, typename>
+GridView<ValueType>::GridView(const GridView<OtherType>& view)
+    : origin(view.origin), nRows(view.nRows), nCols(view.nCols), rowStride(view.rowStride) {
+    /* Empty */
+}
+
+template <typename ValueType>
+int GridView<ValueType>::numRows() const {
+    return nRows;
+}
+
+template <typename ValueType>
+int GridView<ValueType>::numCols() const {
+    return nCols;
+}
+
+template <typename ValueType>
+int GridView<ValueType>::stride() const {
+    return rowStride;
+}
+
+template <typename ValueType>
+GridSpan<ValueType> GridView<ValueType>::row(int r) const {
+#ifndef SPL_UNCHECKED_INDEXING
+    if (r < 0 || r >= nRows)
+        error("GridView row out of range");
+#endif
+    return GridSpan<ValueType>(origin + long(r) * rowStride, nCols);
+}
+
+template <typename ValueType>
+GridSpan<ValueType> GridView<ValueType>::operator[](int r) const {
+    return row(r);
+}
+
+template <typename ValueType>
+void GridView<ValueType>::fill(const ValueType& value) const {
+    for (int r = 0; r < nRows; r++) {
+        ValueType* p = origin + long(r) * rowStride;
+        std::fill(p, p + nCols, value);
+    }
+}
+
+/*
+ * Implementation notes: copyFrom
+ * ------------------------------
+ * If the destination starts later in memory than the source, the rows
+ * are copied from the bottom up and each row from right to left, so
+ * that no element of the source is overwritten before it is read.
+ * Otherwise, the copy runs forward.  For trivially copyable types,
+ * std::copy and std::copy_backward reduce each row to a memmove.
+ */
+
+template <typename ValueType>
+void GridView<ValueType>::copyFrom(const GridView<const typename std::remove_const<ValueType>::type>& src) const {
+    if (src.nRows != nRows || src.nCols != nCols)
+        error("copyFrom: Views have different dimensions");
+    if (std::less<const ValueType*>()(src.origin, origin)) {
+        for (int r = nRows - 1; r >= 0; r--) {
+            const ValueType* from = src.origin + long(r) * src.rowStride;
+            std::copy_backward(from, from + nCols, origin + long(r) * rowStride + nCols);
+        }
+    } else {
+        for (int r = 0; r < nRows; r++) {
+            const ValueType* from = src.origin + long(r) * src.rowStride;
+            std::copy(from, from + nCols, origin + long(r) * rowStride);
+        }
+    }
+}
+
 #endif
@@ -1,7 +1,13 @@
 #ifndef _hashcode_h
 #define _hashcode_h
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 /*
  * Function: hashCode
@@ -10,6 +16,8 @@
  * Returns a hash code for the specified key, which is always a
  * nonnegative integer.  This function is overloaded to support
  * all of the primitive types and the C++ <code>string</code> type.
+ * The result is the low-order bits of <code>hashCode64</code>, so it
+ * is well distributed but changes from one run of the program to the next.
  */
 int hashCode(bool key);
 int hashCode(char key);
@@ -21,6 +29,127 @@ int hashCode(const char* str);
 int hashCode(const std::string& str);
 int hashCode(void* key);
 
+/*
+ * Function: hashSeed
+ * Usage: uint64_t seed = hashSeed();
+ * ----------------------------------
+ * Returns the seed mixed into every 64-bit hash.  The seed is chosen at
+ * random the first time it is needed, which makes it impractical for an
+ * attacker to construct a set of keys that all collide.
+ */
+uint64_t hashSeed();
+
+/*
+ * Function: setHashSeed
+ * Usage: setHashSeed(seed);
+ * -------------------------
+ * Sets the hash seed to the specified value, which makes hash codes and
+ * the iteration order of hash tables repeatable from run to run.  This
+ * function must be called before any hash table is filled, because
+ * tables built under the old seed can no longer find their keys.
+ */
+void setHashSeed(uint64_t seed);
+
+/*
+ * Function: hashMix
+ * Usage: uint64_t hash = hashMix(x);
+ * ----------------------------------
+ * Scrambles a 64-bit integer so that every bit of the result depends on
+ * every bit of the input and on the hash seed.  Sequential integers are
+ * mapped to values that look unrelated.
+ */
+uint64_t hashMix(uint64_t x);
+
+/*
+ * Function: hashBytes
+ * Usage: uint64_t hash = hashBytes(data, length);
+ * -----------------------------------------------
+ * Returns a seeded 64-bit hash of the specified block of memory.  The
+ * function consumes the input eight bytes at a time.
+ */
+uint64_t hashBytes(const void* data, size_t length);
+
+/*
+ * Function: hashCombine
+ * Usage: hash = hashCombine(hash, hashCode64(value));
+ * ---------------------------------------------------
+ * Folds the hash of one more value into a running hash.  The result
+ * depends on the order in which the values are combined.
+ */
+inline uint64_t hashCombine(uint64_t hash, uint64_t value) {
+    return hashMix(hash ^ (value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2)));
+}
+
+/*
+ * Function: hashCode64
+ * Usage: uint64_t hash = hashCode64(key);
+ * ---------------------------------------
+ * Returns a full 64-bit hash for the specified key.  This is the hash
+ * used by <code>HashMap</code> and <code>HashSet</code>.  Strings are
+ * hashed with <code>hashBytes</code>, integral and enumerated types with
+ * <code>hashMix</code>, and pairs and tuples by combining the hashes of
+ * their components.  Any other type falls back on its
+ * <code>hashCode</code> function, whose result is passed through
+ * <code>hashMix</code>.
+ */
+uint64_t hashCode64(double key);
+uint64_t hashCode64(float key);
+uint64_t hashCode64(const char* str);
+uint64_t hashCode64(const std::string& str);
+uint64_t hashCode64(std::string_view str);
+
+template <typename T>
+uint64_t hashCode64(const T& key);
+template <typename T1, typename T2>
+uint64_t hashCode64(const std::pair<T1, T2>& pair);
+template <typename... Types>
+uint64_t hashCode64(const std::tuple<Types...>& tuple);
+
+template <typename T1, typename T2>
+uint64_t hashCode64(const std::pair<T1, T2>& pair) {
+    return hashCombine(hashCode64(pair.first), hashCode64(pair.second));
+}
+
+template <typename... Types>
+uint64_t hashCode64(const std::tuple<Types...>& tuple) {
+    uint64_t hash = 0;
+    std::apply([&hash](const Types&... values) {
+        ((hash = hashCombine(hash, hashCode64(values))), ...);
+    }, tuple);
+    return hash;
+}
+
+template <typename T>
+uint64_t hashCode64(const T& key) {
+    if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        return hashMix(uint64_t(key));
+    } else if constexpr (std::is_same<T, char*>::value) {
+        return hashCode64((const char*)key);
+    } else if constexpr (std::is_pointer<T>::value) {
+        return hashMix(uint64_t(reinterpret_cast<uintptr_t>(key)));
+    } else {
+        return hashMix(uint64_t(hashCode(key)));
+    }
+}
+
+/*
+ * Function: hashRange
+ * Usage: uint64_t hash = hashRange(collection.begin(), collection.end());
+ * -----------------------------------------------------------------------
+ * Returns a hash for the sequence of values between two iterators, which
+ * is useful when writing a <code>hashCode</code> function for a
+ * collection.  Two sequences with the same values in the same order
+ * have the same hash.
+ */
+template <typename IteratorType>
+uint64_t hashRange(IteratorType first, IteratorType last) {
+    uint64_t hash = 0;
+    for (; first != last; ++first) {
+        hash = hashCombine(hash, hashCode64(*first));
+    }
+    return hash;
+}
+
 /*
  * Constants that are used to help implement these functions
  * (see hashcode.h for example usage)
@@ -26,11 +26,17 @@
 #ifndef _hashmap_h
 #define _hashmap_h
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <initializer_list>
+#include <new>
 #include <string>
+#include <utility>
 
 #include "hashcode.h"
+#include "transparentkey.h"
 #include "vector.h"
 
 /*
@@ -63,7 +69,9 @@ public:
      *
      * that returns a positive integer determined by the key.  This interface
      * exports <code>hashCode</code> functions for <code>string</code> and
-     * the C++ primitive types.
+     * the C++ primitive types.  Strings, integral types, pairs, and tuples
+     * are hashed directly by the 64-bit functions in
+     * <code>hashcode.h</code>, which need no <code>hashCode</code>.
      */
 
     HashMap();
@@ -106,6 +114,20 @@ public:
 
     void put(KeyType key, ValueType value);
 
+    /*
+     * Method: tryEmplace
+     * Usage: if (map.tryEmplace(key, args...)) ...
+     * --------------------------------------------
+     * Adds an entry for <code>key</code> whose value is constructed from
+     * the remaining arguments, provided that <code>key</code> is not
+     * already present.  The method returns <code>true</code> if it adds
+     * a new entry; an existing entry is left unchanged, and in that case
+     * the value is never constructed.
+     */
+
+    template <typename... Args>
+    bool tryEmplace(const KeyType& key, Args&&... args);
+
     /*
      * Method: get
      * Usage: ValueType value = map.get(key);
@@ -116,6 +138,8 @@ public:
      */
 
     ValueType get(KeyType key) const;
+    template <typename K>
+    EnableIfTransparent<KeyType, K, ValueType> get(const K& key) const;
 
     /*
      * Method: containsKey
@@ -126,6 +150,8 @@ public:
      */
 
     bool containsKey(KeyType key) const;
+    template <typename K>
+    EnableIfTransparent<KeyType, K, bool> containsKey(const K& key) const;
 
     /*
      * Method: remove
@@ -135,6 +161,8 @@ public:
      */
 
     void remove(KeyType key);
+    template <typename K>
+    EnableIfTransparent<KeyType, K, void> remove(const K& key);
 
     /*
      * Method: clear
@@ -145,6 +173,18 @@ public:
 
     void clear();
 
+    /*
+     * Method: reserve
+     * Usage: map.reserve(n);
+     * ----------------------
+     * Enlarges the table, if necessary, so that it can hold <code>n</code>
+     * entries without growing.  Clients that know how many entries they
+     * are about to add can call this method first to avoid rehashing the
+     * table several times along the way.
+     */
+
+    void reserve(int n);
+
     /*
      * Operator: []
      * Usage: map[key]
@@ -159,6 +199,8 @@ public:
 
     ValueType& operator[](KeyType key);
     ValueType operator[](KeyType key) const;
+    template <typename K>
+    EnableIfTransparent<KeyType, K, ValueType&> operator[](const K& key);
 
     /*
      * Method: toString
@@ -191,6 +233,9 @@ public:
      *   - Stream I/O using the << and >> operators
      *   - Deep copying for the copy constructor and assignment operator
      *   - Iteration using the range-based for statement and STL iterators
+     *   - Lookup by std::string_view or C string in a map whose keys are
+     *     strings, using get, containsKey, remove, and [], without
+     *     building a temporary key (see transparentkey.h)
      *
      * The HashMap class makes no guarantees about the order of iteration.
      */
@@ -205,126 +250,478 @@ public:
     /*
      * Implementation notes:
      * ---------------------
-     * The HashMap class is represented using a hash table that uses
-     * bucket chaining to resolve collisions.
+     * The HashMap class is represented using an open-addressing hash
+     * table in the style of the "Swiss table" design.  The keys and
+     * values live inline in a flat array of slots, and a parallel array
+     * of one-byte control codes records which slots are in use.  The
+     * control bytes are probed eight at a time using ordinary 64-bit
+     * integer arithmetic, so no per-entry allocation or pointer chasing
+     * is required on lookup.
      */
 
 private:
     /* Constant definitions */
 
-    static const int INITIAL_BUCKET_COUNT = 101;
-    static const int MAX_LOAD_PERCENTAGE = 70;
+    static const int GROUP_WIDTH = 8;
+    static const int INITIAL_CAPACITY = 16;
+    static const int MAX_LOAD_NUMERATOR = 7;
+    static const int MAX_LOAD_DENOMINATOR = 8;
+    static const int MIGRATION_STEP = 4 * GROUP_WIDTH;
 
-    /* Type definition for cells in the bucket chain */
+    /*
+     * Control byte values
+     * -------------------
+     * A control byte is either EMPTY, DELETED (a tombstone left behind by
+     * remove), or a full slot, in which case it holds the low seven bits
+     * of the hash code.  The high bit therefore distinguishes the full
+     * slots from the other two states.
+     */
 
-    struct Cell {
+    static const signed char CTRL_EMPTY = -128;
+    static const signed char CTRL_DELETED = -2;
+
+    /* Type definition for the slots in the table */
+
+    struct Slot {
         KeyType key;
         ValueType value;
-        Cell* next;
+
+        template <typename K, typename... Args>
+        Slot(std::piecewise_construct_t, K&& key, Args&&... args)
+            : key(std::forward<K>(key)), value(std::forward<Args>(args)...) {
+        }
+    };
+
+    /* Type definition for one hash table */
+
+    struct Table {
+        signed char* ctrl; /* Control bytes, one per slot           */
+        Slot* slots;       /* Uninitialized storage for the entries */
+        int capacity;      /* Number of slots (a power of two)      */
+        int growthLeft;    /* Empty slots usable before rehashing   */
     };
 
     /* Instance variables */
 
-    Vector<Cell*> buckets;
-    int nBuckets;
-    int numEntries;
+    Table table;      /* The table that receives new entries       */
+    Table oldTable;   /* The table being drained by a rehash       */
+    int migrateIndex; /* Next slot of oldTable to migrate          */
+    int numEntries;   /* Number of entries in both tables          */
+    bool incremental; /* Whether growth uses incremental rehashing */
 
     /* Private methods */
 
     /*
-     * Private method: createBuckets
-     * Usage: createBuckets(nBuckets);
-     * -------------------------------
-     * Sets up the vector of buckets to have nBuckets entries, each nullptr.
-     * If asked to make empty vector, makes one bucket just to simplify
-     * handling elsewhere.
+     * Private method: hashOf
+     * Usage: uint64_t hash = hashOf(key);
+     * -----------------------------------
+     * Returns the 64-bit hash of key.  The high bits choose a group and
+     * the low seven bits are stored in the control byte, so both must be
+     * well distributed, which hashCode64 guarantees even for keys such as
+     * small integers that are nearly sequential.
      */
 
-    void createBuckets(int nBuckets) {
-        if (nBuckets == 0)
-            nBuckets = 1;
-        buckets = Vector<Cell*>(nBuckets, nullptr);
-        this->nBuckets = nBuckets;
-        numEntries = 0;
+    static uint64_t hashOf(const KeyType& key) {
+        return hashCode64(key);
+    }
+
+    static signed char h2(uint64_t hash) {
+        return (signed char)(hash & 0x7F);
     }
 
     /*
-     * Private method: deleteBuckets
-     * Usage: deleteBuckets(buckets);
-     * ------------------------------
-     * Deletes all the cells in the linked lists contained in vector.
+     * Private methods: loadGroup, matchByte, matchEmpty, matchEmptyOrDeleted
+     * ----------------------------------------------------------------------
+     * These methods implement the portable group probe.  The control bytes
+     * of one group are packed into a 64-bit word with byte i in bits
+     * 8*i..8*i+7, and each match method returns a word in which the high
+     * bit of byte i is set if slot i of the group satisfies the test.
+     * The matchByte test may report a rare false positive, which is
+     * harmless because the caller always compares the keys.
+     */
+
+    static uint64_t loadGroup(const Table& t, int index) {
+        uint64_t word = 0;
+        for (int i = 0; i < GROUP_WIDTH; i++) {
+            word |= uint64_t((unsigned char)t.ctrl[index + i]) << (8 * i);
+        }
+        return word;
+    }
+
+    static uint64_t matchByte(uint64_t group, signed char h) {
+        const uint64_t lsbs = 0x0101010101010101ULL;
+        const uint64_t msbs = 0x8080808080808080ULL;
+        uint64_t x = group ^ (lsbs * (unsigned char)h);
+        return (x - lsbs) & ~x & msbs;
+    }
+
+    static uint64_t matchEmpty(uint64_t group) {
+        return (group & ~(group << 6)) & 0x8080808080808080ULL;
+    }
+
+    static uint64_t matchEmptyOrDeleted(uint64_t group) {
+        return group & 0x8080808080808080ULL;
+    }
+
+    /*
+     * Private method: lowestMatch
+     * Usage: int offset = lowestMatch(mask);
+     * --------------------------------------
+     * Returns the index within the group of the first slot whose bit is
+     * set in the nonzero mask.
      */
 
-    void deleteBuckets(Vector<Cell*>& buckets) {
-        for (int i = 0; i < buckets.size(); i++) {
-            Cell* cp = buckets[i];
-            while (cp != nullptr) {
-                Cell* np = cp->next;
-                delete cp;
-                cp = np;
+    static int lowestMatch(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask) >> 3;
+#else
+        int offset = 0;
+        while ((mask & 0x80) == 0) {
+            mask >>= 8;
+            offset++;
+        }
+        return offset;
+#endif
+    }
+
+    /*
+     * Private method: findSlot
+     * Usage: int index = findSlot(t, key, hash);
+     * ------------------------------------------
+     * Returns the index of the slot in table t containing key, or -1 if
+     * the key is not there.  The key may be of any type that can be
+     * compared with KeyType using ==.  The probe visits whole groups in a triangular
+     * sequence, which reaches every group when the number of groups is
+     * a power of two, and stops at the first group that has an empty slot.
+     */
+
+    template <typename K>
+    static int findSlot(const Table& t, const K& key, uint64_t hash) {
+        if (t.capacity == 0)
+            return -1;
+        int groupMask = t.capacity / GROUP_WIDTH - 1;
+        int group = int((hash >> 7) & groupMask);
+        for (int step = 1;; step++) {
+            int base = group * GROUP_WIDTH;
+            uint64_t word = loadGroup(t, base);
+            for (uint64_t mask = matchByte(word, h2(hash)); mask != 0; mask &= mask - 1) {
+                int index = base + lowestMatch(mask);
+                if (t.slots[index].key == key)
+                    return index;
             }
-            buckets[i] = nullptr;
+            if (matchEmpty(word) != 0 || step > groupMask)
+                return -1;
+            group = (group + step) & groupMask;
         }
     }
 
     /*
-     * Private method: expandAndRehash
-     * Usage: expandAndRehash();
-     * -------------------------
-     * This method is used to increase the number of buckets in the map
-     * and then rehashes all existing entries and adds them into new buckets.
-     * This operation is used when the load factor (i.e. the number of cells
-     * per bucket) has increased enough to warrant this O(N) operation to
-     * enlarge and redistribute the entries.
+     * Private method: findEntry
+     * Usage: Slot *sp = findEntry(key, hash);
+     * ---------------------------------------
+     * Returns a pointer to the slot containing key, or nullptr if the key
+     * is not in the map.  While an incremental rehash is in progress, the
+     * key may still be in the old table, which is searched second.
      */
 
-    void expandAndRehash() {
-        Vector<Cell*> oldBuckets = buckets;
-        createBuckets(oldBuckets.size() * 2 + 1);
-        for (int i = 0; i < oldBuckets.size(); i++) {
-            for (Cell* cp = oldBuckets[i]; cp != nullptr; cp = cp->next) {
-                put(cp->key, cp->value);
+    template <typename K>
+    Slot* findEntry(const K& key, uint64_t hash) const {
+        int index = findSlot(table, key, hash);
+        if (index >= 0)
+            return &table.slots[index];
+        if (oldTable.capacity > 0) {
+            index = findSlot(oldTable, key, hash);
+            if (index >= 0)
+                return &oldTable.slots[index];
+        }
+        return nullptr;
+    }
+
+    /*
+     * Private method: removeEntry
+     * Usage: removeEntry(key, hash);
+     * ------------------------------
+     * Removes the entry for key, if any, from whichever table holds it,
+     * and advances an incremental rehash that is in progress.
+     */
+
+    template <typename K>
+    void removeEntry(const K& key, uint64_t hash) {
+        int index = findSlot(table, key, hash);
+        if (index >= 0) {
+            eraseSlot(table, index);
+            numEntries--;
+        } else if (oldTable.capacity > 0) {
+            index = findSlot(oldTable, key, hash);
+            if (index >= 0) {
+                eraseSlot(oldTable, index);
+                numEntries--;
             }
         }
-        deleteBuckets(oldBuckets);
+        if (oldTable.capacity > 0)
+            migrateStep();
     }
 
     /*
-     * Private method: findCell
-     * Usage: Cell *cp = findCell(bucket, key);
-     *        Cell *cp = findCell(bucket, key, parent);
-     * ------------------------------------------------
-     * Finds a cell in the chain for the specified bucket that matches key.
-     * If a match is found, the return value is a pointer to the cell containing
-     * the matching key.  If no match is found, the function returns nullptr.
-     * If the optional third argument is supplied, it is filled in with the
-     * cell preceding the matching cell to allow the client to splice out
-     * the target cell in the delete call.  If parent is nullptr, it indicates
-     * that the cell is the first cell in the bucket chain.
-     */
-
-    Cell* findCell(int bucket, KeyType key) const {
-        Cell* dummy;
-        return findCell(bucket, key, dummy);
-    }
-
-    Cell* findCell(int bucket, KeyType key, Cell*& parent) const {
-        parent = nullptr;
-        Cell* cp = buckets.get(bucket);
-        while (cp != nullptr && key != cp->key) {
-            parent = cp;
-            cp = cp->next;
+     * Private method: findInsertSlot
+     * Usage: int index = findInsertSlot(t, hash);
+     * -------------------------------------------
+     * Returns the first empty or deleted slot along the probe sequence
+     * for hash in table t.  The caller guarantees that such a slot exists.
+     */
+
+    static int findInsertSlot(const Table& t, uint64_t hash) {
+        int groupMask = t.capacity / GROUP_WIDTH - 1;
+        int group = int((hash >> 7) & groupMask);
+        for (int step = 1;; step++) {
+            int base = group * GROUP_WIDTH;
+            uint64_t mask = matchEmptyOrDeleted(loadGroup(t, base));
+            if (mask != 0)
+                return base + lowestMatch(mask);
+            group = (group + step) & groupMask;
+        }
+    }
+
+    /*
+     * Private method: claimSlot
+     * Usage: int index = claimSlot(t, hash);
+     * --------------------------------------
+     * Finds a free slot for hash in table t and marks it as full.  The
+     * slot itself is returned uninitialized, so the caller must construct
+     * the entry in place.
+     */
+
+    static int claimSlot(Table& t, uint64_t hash) {
+        int index = findInsertSlot(t, hash);
+        if (t.ctrl[index] == CTRL_EMPTY)
+            t.growthLeft--;
+        t.ctrl[index] = h2(hash);
+        return index;
+    }
+
+    /*
+     * Private method: prepareInsert
+     * Usage: int index = prepareInsert(hash);
+     * ---------------------------------------
+     * Reserves a slot in the current table for a new entry with the given
+     * hash, growing or cleaning the table first if no more empty slots
+     * may be used.  If an incremental rehash is in progress, this method
+     * also migrates the next batch of entries from the old table.
+     */
+
+    int prepareInsert(uint64_t hash) {
+        if (oldTable.capacity > 0)
+            migrateStep();
+        if (table.growthLeft == 0 && oldTable.capacity > 0)
+            finishRehash();
+        if (table.growthLeft == 0)
+            grow();
+        return claimSlot(table, hash);
+    }
+
+    /*
+     * Private method: insertEntry
+     * Usage: Slot* sp = insertEntry(hash, key, args...);
+     * --------------------------------------------------
+     * Adds a new entry for a key known to be absent, constructing the key
+     * and value in place from the arguments, and returns its slot.
+     */
+
+    template <typename K, typename... Args>
+    Slot* insertEntry(uint64_t hash, K&& key, Args&&... args) {
+        int index = prepareInsert(hash);
+        Slot* sp = &table.slots[index];
+        new (sp) Slot(std::piecewise_construct, std::forward<K>(key), std::forward<Args>(args)...);
+        numEntries++;
+        return sp;
+    }
+
+    static int maxLoad(int capacity) {
+        return capacity / MAX_LOAD_DENOMINATOR * MAX_LOAD_NUMERATOR;
+    }
+
+    /*
+     * Private method: eraseSlot
+     * Usage: eraseSlot(t, index);
+     * ---------------------------
+     * Destroys the entry in the specified slot of table t.  If the group
+     * containing the slot still has an empty slot, no probe sequence can
+     * ever have passed through the group, so the slot can be marked empty
+     * again; otherwise it must become a tombstone.
+     */
+
+    static void eraseSlot(Table& t, int index) {
+        t.slots[index].~Slot();
+        int base = index - index % GROUP_WIDTH;
+        if (matchEmpty(loadGroup(t, base)) != 0) {
+            t.ctrl[index] = CTRL_EMPTY;
+            t.growthLeft++;
+        } else {
+            t.ctrl[index] = CTRL_DELETED;
         }
-        return cp;
+    }
+
+    /*
+     * Private method: moveEntry
+     * Usage: moveEntry(src, index, dst);
+     * ----------------------------------
+     * Moves the entry in the specified slot of src into table dst.  The
+     * entry is move-constructed into its new slot rather than copied, and
+     * the source slot is left as a tombstone so that the remaining entries
+     * of src can still be found.
+     */
+
+    static void moveEntry(Table& src, int index, Table& dst) {
+        int target = claimSlot(dst, hashOf(src.slots[index].key));
+        new (&dst.slots[target]) Slot(std::move(src.slots[index]));
+        src.slots[index].~Slot();
+        src.ctrl[index] = CTRL_DELETED;
+    }
+
+    /*
+     * Private method: grow
+     * Usage: grow();
+     * --------------
+     * Makes room in a full table.  The new table is twice as large unless
+     * most of the used slots are tombstones, in which case it has the same
+     * capacity.  In the default mode, every entry is moved at once; in
+     * incremental mode, the current table becomes the old table and is
+     * drained a few groups at a time by later calls to migrateStep.
+     */
+
+    void grow() {
+        int newCapacity = table.capacity;
+        if (newCapacity == 0) {
+            newCapacity = INITIAL_CAPACITY;
+        } else if (numEntries * 2 >= maxLoad(newCapacity)) {
+            newCapacity *= 2;
+        }
+        oldTable = table;
+        allocateTable(table, newCapacity);
+        migrateIndex = 0;
+        if (!incremental)
+            finishRehash();
+    }
+
+    /*
+     * Private methods: migrateStep, finishRehash
+     * ------------------------------------------
+     * The migrateStep method moves the full slots among the next
+     * MIGRATION_STEP slots of the old table into the current table and
+     * frees the old table once it has been drained.  The finishRehash
+     * method completes the migration all at once.  Since each insertion
+     * migrates MIGRATION_STEP slots, the old table is always drained long
+     * before the new one can fill up.
+     */
+
+    void migrateStep() {
+        int limit = std::min(oldTable.capacity, migrateIndex + MIGRATION_STEP);
+        for (; migrateIndex < limit; migrateIndex++) {
+            if (oldTable.ctrl[migrateIndex] >= 0)
+                moveEntry(oldTable, migrateIndex, table);
+        }
+        if (migrateIndex == oldTable.capacity)
+            freeTable(oldTable);
+    }
+
+    void finishRehash() {
+        while (oldTable.capacity > 0) {
+            migrateStep();
+        }
+    }
+
+    /*
+     * Private methods: allocateTable, freeTable, destroyEntries, copyTable
+     * --------------------------------------------------------------------
+     * These methods manage the raw storage for a table.  The slot array
+     * is allocated without constructing any entries, so that the key and
+     * value types need not be default-constructible and the table never
+     * pays for initializing slots that are not in use.
+     */
+
+    static void allocateTable(Table& t, int capacity) {
+        t.capacity = capacity;
+        t.ctrl = new signed char[capacity];
+        std::memset(t.ctrl, CTRL_EMPTY, capacity);
+        t.slots = static_cast<Slot*>(::operator new(sizeof(Slot) * capacity));
+        t.growthLeft = maxLoad(capacity);
+    }
+
+    static void freeTable(Table& t) {
+        delete[] t.ctrl;
+        ::operator delete(t.slots);
+        t.ctrl = nullptr;
+        t.slots = nullptr;
+        t.capacity = t.growthLeft = 0;
+    }
+
+    static void destroyEntries(Table& t) {
+        for (int i = 0; i < t.capacity; i++) {
+            if (t.ctrl[i] >= 0)
+                t.slots[i].~Slot();
+        }
+    }
+
+    static void copyTable(Table& dst, const Table& src) {
+        dst.ctrl = nullptr;
+        dst.slots = nullptr;
+        dst.capacity = dst.growthLeft = 0;
+        if (src.capacity == 0)
+            return;
+        allocateTable(dst, src.capacity);
+        for (int i = 0; i < src.capacity; i++) {
+            if (src.ctrl[i] >= 0)
+                new (&dst.slots[i]) Slot(src.slots[i]);
+        }
+        std::memcpy(dst.ctrl, src.ctrl, src.capacity);
+        dst.growthLeft = src.growthLeft;
+    }
+
+    void initEmpty() {
+        table.ctrl = oldTable.ctrl = nullptr;
+        table.slots = oldTable.slots = nullptr;
+        table.capacity = oldTable.capacity = 0;
+        table.growthLeft = oldTable.growthLeft = 0;
+        migrateIndex = 0;
+        numEntries = 0;
+        incremental = false;
     }
 
     void deepCopy(const HashMap& src) {
-        createBuckets(src.nBuckets);
-        for (int i = 0; i < src.nBuckets; i++) {
-            for (Cell* cp = src.buckets.get(i); cp != nullptr; cp = cp->next) {
-                put(cp->key, cp->value);
-            }
+        copyTable(table, src.table);
+        copyTable(oldTable, src.oldTable);
+        migrateIndex = src.migrateIndex;
+        numEntries = src.numEntries;
+        incremental = src.incremental;
+    }
+
+    /*
+     * Private methods: slotCount, nextFullSlot, slotAt
+     * ------------------------------------------------
+     * These methods give the iterator and mapAll a single index space that
+     * covers the old table, if any, followed by the current table.
+     */
+
+    int slotCount() const {
+        return oldTable.capacity + table.capacity;
+    }
+
+    int nextFullSlot(int index) const {
+        for (; index < oldTable.capacity; index++) {
+            if (oldTable.ctrl[index] >= 0)
+                return index;
+        }
+        int n = slotCount();
+        while (index < n && table.ctrl[index - oldTable.capacity] < 0) {
+            index++;
         }
+        return index;
+    }
+
+    const Slot& slotAt(int index) const {
+        if (index < oldTable.capacity)
+            return oldTable.slots[index];
+        return table.slots[index - oldTable.capacity];
     }
 
 public:
@@ -342,12 +739,16 @@ public:
      * --------------------
      * This copy constructor and operator= are defined to make a
      * deep copy, making it possible to pass/return maps by value
-     * and assign from one map to another.
+     * and assign from one map to another.  The copy has the same
+     * capacity and layout as the original, so no entry is rehashed.
      */
 
     HashMap& operator=(const HashMap& src) {
         if (this != &src) {
-            clear();
+            destroyEntries(table);
+            destroyEntries(oldTable);
+            freeTable(table);
+            freeTable(oldTable);
             deepCopy(src);
         }
         return *this;
@@ -357,6 +758,57 @@ public:
         deepCopy(src);
     }
 
+    /*
+     * Move support
+     * ------------
+     * Moving a map transfers its tables without touching the entries.
+     * The source map is left empty, with no storage allocated.
+     */
+
+    HashMap(HashMap&& src) noexcept {
+        table = src.table;
+        oldTable = src.oldTable;
+        migrateIndex = src.migrateIndex;
+        numEntries = src.numEntries;
+        incremental = src.incremental;
+        src.initEmpty();
+    }
+
+    HashMap& operator=(HashMap&& src) noexcept {
+        if (this != &src) {
+            destroyEntries(table);
+            destroyEntries(oldTable);
+            freeTable(table);
+            freeTable(oldTable);
+            table = src.table;
+            oldTable = src.oldTable;
+            migrateIndex = src.migrateIndex;
+            numEntries = src.numEntries;
+            incremental = src.incremental;
+            src.initEmpty();
+        }
+        return *this;
+    }
+
+    /*
+     * Method: setIncrementalRehash
+     * Usage: map.setIncrementalRehash(flag);
+     * --------------------------------------
+     * Selects how the map grows once its table is full.  By default, the
+     * map moves every entry into a larger table at once.  If incremental
+     * rehashing is enabled, the old and new tables coexist after the table
+     * grows, and each subsequent <code>put</code> or <code>remove</code>
+     * migrates a small, fixed number of slots.  This mode avoids long
+     * pauses in latency-sensitive code at a slight cost in throughput.
+     * Turning the mode off completes any migration in progress.
+     */
+
+    void setIncrementalRehash(bool flag) {
+        incremental = flag;
+        if (!flag)
+            finishRehash();
+    }
+
     /*
      * Iterator support
      * ----------------
@@ -379,29 +831,16 @@ public:
 
         iterator(const HashMap* mp, bool end) {
             this->mp = mp;
-            if (end) {
-                bucket = mp->nBuckets;
-                cp = nullptr;
-            } else {
-                bucket = 0;
-                cp = mp->buckets.get(bucket);
-                while (cp == nullptr && ++bucket < mp->nBuckets) {
-                    cp = mp->buckets.get(bucket);
-                }
-            }
+            index = end ? mp->slotCount() : mp->nextFullSlot(0);
         }
 
         iterator(const iterator& it) {
             mp = it.mp;
-            bucket = it.bucket;
-            cp = it.cp;
+            index = it.index;
         }
 
         iterator& operator++() {
-            cp = cp->next;
-            while (cp == nullptr && ++bucket < mp->nBuckets) {
-                cp = mp->buckets.get(bucket);
-            }
+            index = mp->nextFullSlot(index + 1);
             return *this;
         }
 
@@ -412,7 +851,7 @@ public:
         }
 
         bool operator==(const iterator& rhs) {
-            return mp == rhs.mp && bucket == rhs.bucket && cp == rhs.cp;
+            return mp == rhs.mp && index == rhs.index;
         }
 
         bool operator!=(const iterator& rhs) {
@@ -420,19 +859,18 @@ public:
         }
 
         KeyType operator*() {
-            return cp->key;
+            return mp->slotAt(index).key;
         }
 
-        KeyType* operator->() {
-            return &cp->key;
+        const KeyType* operator->() {
+            return &mp->slotAt(index).key;
         }
 
         friend class HashMap;
 
     private:
-        const HashMap* mp; /* Pointer to the map           */
-        int bucket;        /* Index of current bucket      */
-        Cell* cp;          /* Current cell in bucket chain */
+        const HashMap* mp; /* Pointer to the map         */
+        int index;         /* Index of the current slot  */
     };
 
     iterator begin() const {
@@ -447,23 +885,25 @@ public:
 /*
  * Implementation notes: HashMap class
  * -----------------------------------
- * In this map implementation, the entries are stored in a hashtable.
- * The hashtable keeps a vector of "buckets", where each bucket is a
- * linked list of elements that share the same hash code (i.e. hash
- * collisions are resolved by chaining). The buckets are dynamically
- * allocated so that we can change the the number of buckets (rehash)
- * when the load factor becomes too high. The map should provide O(1)
- * performance on the put/remove/get operations.
+ * In this map implementation, the entries are stored in an open-addressing
+ * hash table whose capacity is always a power of two and a multiple of the
+ * group width.  The table is allocated lazily on the first insertion, so
+ * empty maps own no heap storage.  When the number of used slots reaches
+ * seven eighths of the capacity, the table is either doubled or, if most
+ * of the used slots are tombstones, rebuilt at the same size.  Lookups
+ * consult the old table only while an incremental rehash is under way.
+ * The map provides O(1) expected performance on the put/remove/get
+ * operations.
  */
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::HashMap() {
-    createBuckets(INITIAL_BUCKET_COUNT);
+    initEmpty();
 }
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::HashMap(std::initializer_list<std::pair<KeyType, ValueType>> list) {
-    createBuckets(INITIAL_BUCKET_COUNT);
+    initEmpty();
     for (const std::pair<KeyType, ValueType>& pair : list) {
         put(pair.first, pair.second);
     }
@@ -471,7 +911,10 @@ HashMap<KeyType, ValueType>::HashMap(std::initializer_list<std::pair<KeyType, Va
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::~HashMap() {
-    deleteBuckets(buckets);
+    destroyEntries(table);
+    destroyEntries(oldTable);
+    freeTable(table);
+    freeTable(oldTable);
 }
 
 template <typename KeyType, typename ValueType>
@@ -486,88 +929,132 @@ bool HashMap<KeyType, ValueType>::isEmpty() const {
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::put(KeyType key, ValueType value) {
-    (*this)[key] = value;
+    uint64_t hash = hashOf(key);
+    Slot* sp = findEntry(key, hash);
+    if (sp == nullptr) {
+        insertEntry(hash, std::move(key), std::move(value));
+    } else {
+        sp->value = std::move(value);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename... Args>
+bool HashMap<KeyType, ValueType>::tryEmplace(const KeyType& key, Args&&... args) {
+    uint64_t hash = hashOf(key);
+    if (findEntry(key, hash) != nullptr)
+        return false;
+    insertEntry(hash, key, std::forward<Args>(args)...);
+    return true;
 }
 
 template <typename KeyType, typename ValueType>
 ValueType HashMap<KeyType, ValueType>::get(KeyType key) const {
-    Cell* cp = findCell(hashCode(key) % nBuckets, key);
-    if (cp == nullptr)
+    Slot* sp = findEntry(key, hashOf(key));
+    if (sp == nullptr)
+        return ValueType();
+    return sp->value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, ValueType> HashMap<KeyType, ValueType>::get(const K& key) const {
+    typename std::decay<const K>::type probe = key;
+    Slot* sp = findEntry(probe, hashCode64(probe));
+    if (sp == nullptr)
         return ValueType();
-    return cp->value;
+    return sp->value;
 }
 
 template <typename KeyType, typename ValueType>
 bool HashMap<KeyType, ValueType>::containsKey(KeyType key) const {
-    return findCell(hashCode(key) % nBuckets, key) != nullptr;
+    return findEntry(key, hashOf(key)) != nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, bool> HashMap<KeyType, ValueType>::containsKey(const K& key) const {
+    typename std::decay<const K>::type probe = key;
+    return findEntry(probe, hashCode64(probe)) != nullptr;
 }
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::remove(KeyType key) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell* parent;
-    Cell* cp = findCell(bucket, key, parent);
-    if (cp != nullptr) {
-        if (parent == nullptr) {
-            buckets[bucket] = cp->next;
-        } else {
-            parent->next = cp->next;
-        }
-        delete cp;
-        numEntries--;
-    }
+    removeEntry(key, hashOf(key));
+}
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, void> HashMap<KeyType, ValueType>::remove(const K& key) {
+    typename std::decay<const K>::type probe = key;
+    removeEntry(probe, hashCode64(probe));
 }
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::clear() {
-    deleteBuckets(buckets);
+    destroyEntries(table);
+    destroyEntries(oldTable);
+    freeTable(oldTable);
+    if (table.capacity > 0)
+        std::memset(table.ctrl, CTRL_EMPTY, table.capacity);
+    table.growthLeft = maxLoad(table.capacity);
     numEntries = 0;
 }
 
 template <typename KeyType, typename ValueType>
-ValueType& HashMap<KeyType, ValueType>::operator[](KeyType key) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell* cp = findCell(bucket, key);
-    if (cp == nullptr) {
-        if (numEntries > MAX_LOAD_PERCENTAGE * nBuckets / 100.0) {
-            expandAndRehash();
-            bucket = hashCode(key) % nBuckets;
-        }
-        cp = new Cell;
-        cp->key = key;
-        cp->value = ValueType();
-        cp->next = buckets[bucket];
-        buckets[bucket] = cp;
-        numEntries++;
+void HashMap<KeyType, ValueType>::reserve(int n) {
+    finishRehash();
+    int capacity = std::max(table.capacity, int(INITIAL_CAPACITY));
+    while (maxLoad(capacity) < n) {
+        capacity *= 2;
     }
-    return cp->value;
+    if (capacity == table.capacity || n <= 0)
+        return;
+    oldTable = table;
+    allocateTable(table, capacity);
+    migrateIndex = 0;
+    finishRehash();
+}
+
+template <typename KeyType, typename ValueType>
+ValueType& HashMap<KeyType, ValueType>::operator[](KeyType key) {
+    uint64_t hash = hashOf(key);
+    Slot* sp = findEntry(key, hash);
+    if (sp == nullptr)
+        sp = insertEntry(hash, std::move(key));
+    return sp->value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, ValueType&> HashMap<KeyType, ValueType>::operator[](const K& key) {
+    typename std::decay<const K>::type probe = key;
+    uint64_t hash = hashCode64(probe);
+    Slot* sp = findEntry(probe, hash);
+    if (sp == nullptr)
+        sp = insertEntry(hash, KeyType(probe));
+    return sp->value;
 }
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != nullptr; cp = cp->next) {
-            fn(cp->key, cp->value);
-        }
+    for (int i = nextFullSlot(0); i < slotCount(); i = nextFullSlot(i + 1)) {
+        fn(slotAt(i).key, slotAt(i).value);
     }
 }
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&, const ValueType&)) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != nullptr; cp = cp->next) {
-            fn(cp->key, cp->value);
-        }
+    for (int i = nextFullSlot(0); i < slotCount(); i = nextFullSlot(i + 1)) {
+        fn(slotAt(i).key, slotAt(i).value);
     }
 }
 
 template <typename KeyType, typename ValueType>
 template <typename FunctorType>
 void HashMap<KeyType, ValueType>::mapAll(FunctorType fn) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != nullptr; cp = cp->next) {
-            fn(cp->key, cp->value);
-        }
+    for (int i = nextFullSlot(0); i < slotCount(); i = nextFullSlot(i + 1)) {
+        fn(slotAt(i).key, slotAt(i).value);
     }
 }
 
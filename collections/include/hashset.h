@@ -106,6 +106,8 @@ public:
      */
 
     void remove(const ValueType& value);
+    template <typename K>
+    EnableIfTransparent<ValueType, K, void> remove(const K& value);
 
     /*
      * Method: contains
@@ -115,6 +117,8 @@ public:
      */
 
     bool contains(const ValueType& value) const;
+    template <typename K>
+    EnableIfTransparent<ValueType, K, bool> contains(const K& value) const;
 
     /*
      * Method: isSubsetOf
@@ -290,6 +294,8 @@ public:
      *   - Stream I/O using the << and >> operators
      *   - Deep copying for the copy constructor and assignment operator
      *   - Iteration using the range-based for statement and STL iterators
+     *   - Lookup by std::string_view or C string in a set of strings,
+     *     using contains and remove, without building a temporary string
      *
      * The iteration forms process the HashSet in an unspecified order.
      */
@@ -315,6 +321,18 @@ public:
      * that interface more difficult to understand for the average client.
      */
 
+    /*
+     * Copying and moving support
+     * --------------------------
+     * A hash set copies or moves its underlying hash map.  Moving a
+     * hash set transfers the table and leaves the source set empty.
+     */
+
+    HashSet(const HashSet& src) = default;
+    HashSet(HashSet&& src) = default;
+    HashSet& operator=(const HashSet& src) = default;
+    HashSet& operator=(HashSet&& src) = default;
+
     HashSet& operator,(const ValueType& value) {
         if (this->removeFlag) {
             this->remove(value);
@@ -395,7 +413,7 @@ public:
 extern void error(std::string msg);
 
 template <typename ValueType>
-HashSet<ValueType>::HashSet() {
+HashSet<ValueType>::HashSet() : removeFlag(false) {
     /* Empty */
 }
 
@@ -436,11 +454,23 @@ void HashSet<ValueType>::remove(const ValueType& value) {
     map.remove(value);
 }
 
+template <typename ValueType>
+template <typename K>
+EnableIfTransparent<ValueType, K, void> HashSet<ValueType>::remove(const K& value) {
+    map.remove(value);
+}
+
 template <typename ValueType>
 bool HashSet<ValueType>::contains(const ValueType& value) const {
     return map.containsKey(value);
 }
 
+template <typename ValueType>
+template <typename K>
+EnableIfTransparent<ValueType, K, bool> HashSet<ValueType>::contains(const K& value) const {
+    return map.containsKey(value);
+}
+
 template <typename ValueType>
 void HashSet<ValueType>::clear() {
     map.clear();
@@ -448,6 +478,8 @@ void HashSet<ValueType>::clear() {
 
 template <typename ValueType>
 bool HashSet<ValueType>::isSubsetOf(const HashSet& set2) const {
+    if (size() > set2.size())
+        return false;
     iterator it = begin();
     iterator end = this->end();
     while (it != end) {
@@ -461,13 +493,18 @@ bool HashSet<ValueType>::isSubsetOf(const HashSet& set2) const {
 /*
  * Implementation notes: set operators
  * -----------------------------------
- * The implementations for the set operators use iteration to walk
- * over the elements in one or both sets.
+ * A hash lookup takes constant time, so the cost of each operator is
+ * set by how many elements it visits.  The operators therefore visit the
+ * smaller set and probe the larger one wherever the result allows it.
+ * A union starts from a copy of the larger set, which duplicates its
+ * table slot for slot without rehashing, and then adds the elements of
+ * the smaller one.  A difference with a small right operand likewise
+ * copies the left operand and removes the few elements it shares.
  */
 
 template <typename ValueType>
 bool HashSet<ValueType>::operator==(const HashSet& set2) const {
-    return this->isSubsetOf(set2) && set2.isSubsetOf(*this);
+    return size() == set2.size() && this->isSubsetOf(set2);
 }
 
 template <typename ValueType>
@@ -477,8 +514,9 @@ bool HashSet<ValueType>::operator!=(const HashSet& set2) const {
 
 template <typename ValueType>
 HashSet<ValueType> HashSet<ValueType>::operator+(const HashSet& set2) const {
-    HashSet<ValueType> set = *this;
-    for (const ValueType& value : set2) {
+    bool thisLarger = size() >= set2.size();
+    HashSet<ValueType> set = thisLarger ? *this : set2;
+    for (const ValueType& value : thisLarger ? set2 : *this) {
         set.add(value);
     }
     return set;
@@ -493,9 +531,11 @@ HashSet<ValueType> HashSet<ValueType>::operator+(const ValueType& element) const
 
 template <typename ValueType>
 HashSet<ValueType> HashSet<ValueType>::operator*(const HashSet& set2) const {
+    const HashSet& smaller = (size() <= set2.size()) ? *this : set2;
+    const HashSet& larger = (size() <= set2.size()) ? set2 : *this;
     HashSet<ValueType> set;
-    for (const ValueType& value : *this) {
-        if (set2.map.containsKey(value))
+    for (const ValueType& value : smaller) {
+        if (larger.map.containsKey(value))
             set.add(value);
     }
     return set;
@@ -503,6 +543,13 @@ HashSet<ValueType> HashSet<ValueType>::operator*(const HashSet& set2) const {
 
 template <typename ValueType>
 HashSet<ValueType> HashSet<ValueType>::operator-(const HashSet& set2) const {
+    if (set2.size() < size()) {
+        HashSet<ValueType> set = *this;
+        for (const ValueType& value : set2) {
+            set.remove(value);
+        }
+        return set;
+    }
     HashSet<ValueType> set;
     for (const ValueType& value : *this) {
         if (!set2.map.containsKey(value))
@@ -535,6 +582,10 @@ HashSet<ValueType>& HashSet<ValueType>::operator+=(const ValueType& value) {
 
 template <typename ValueType>
 HashSet<ValueType>& HashSet<ValueType>::operator*=(const HashSet& set2) {
+    if (set2.size() < size()) {
+        map = std::move((*this * set2).map);
+        return *this;
+    }
     Vector<ValueType> toRemove;
     for (const ValueType& value : *this) {
         if (!set2.map.containsKey(value))
@@ -548,6 +599,16 @@ HashSet<ValueType>& HashSet<ValueType>::operator*=(const HashSet& set2) {
 
 template <typename ValueType>
 HashSet<ValueType>& HashSet<ValueType>::operator-=(const HashSet& set2) {
+    if (this == &set2) {
+        clear();
+        return *this;
+    }
+    if (set2.size() < size()) {
+        for (const ValueType& value : set2) {
+            this->remove(value);
+        }
+        return *this;
+    }
     Vector<ValueType> toRemove;
     for (const ValueType& value : *this) {
         if (set2.map.containsKey(value))
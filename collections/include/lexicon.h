@@ -37,6 +37,7 @@
 #include <iterator>
 #include <set>
 #include <string>
+#include <string_view>
 
 #include "hashcode.h"
 #include "set.h"
@@ -137,8 +138,10 @@ public:
      * ignored, so "Zoo" is the same as "ZOO" or "zoo".
      * The empty string cannot be contained in a lexicon, nor can any word
      * containing any non-alphabetic characters such as punctuation or whitespace.
+     * The word may be passed as a <code>string</code>, a
+     * <code>string_view</code>, or a C string, and is never copied.
      */
-    bool contains(const std::string& word) const;
+    bool contains(std::string_view word) const;
 
     /*
      * Method: containsPrefix
@@ -150,7 +153,7 @@ public:
      * The empty string is a prefix of every string, so this method returns
      * true when passed the empty string.
      */
-    bool containsPrefix(const std::string& prefix) const;
+    bool containsPrefix(std::string_view prefix) const;
 
     /*
      * Method: equals
@@ -323,7 +326,7 @@ private:
      * recursive helpers to implement public add/contains/remove
      */
     bool addHelper(TrieNode*& node, const std::string& word, const std::string& originalWord);
-    bool containsHelper(TrieNode* node, const std::string& word, bool isPrefix) const;
+    bool containsHelper(TrieNode* node, std::string_view word, bool isPrefix) const;
     void deepCopy(const Lexicon& src);
     void deleteTree(TrieNode* node);
     void readBinaryFile(const std::string& filename);
@@ -355,6 +358,15 @@ public:
     Lexicon(const Lexicon& src);
     Lexicon& operator=(const Lexicon& src);
 
+    /*
+     * Move support
+     * ------------
+     * Moving a lexicon transfers its trie and word set without copying
+     * them, and leaves the source lexicon empty.
+     */
+    Lexicon(Lexicon&& src);
+    Lexicon& operator=(Lexicon&& src);
+
     /*
      * Iterator support
      * ----------------
@@ -12,9 +12,64 @@
 
 #include <cstdlib>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "compare.h"
-#include "stack.h"
+#include "nodepool.h"
+#include "transparentkey.h"
+#include "vector.h"
+
+/*
+ * Type: MapNode<KeyType,ValueType>
+ * --------------------------------
+ * The node type of the binary search tree used by Map.  If the value
+ * type is an empty class, as it is for the map inside Set, the second
+ * version of the node is used, which stores no value at all; its value
+ * member is a single shared object, which is indistinguishable from a
+ * separate object because an empty class has no state.  Each node also
+ * points to its parent, which lets an iterator move through the tree
+ * without keeping a stack.
+ */
+
+template <typename KeyType, typename ValueType,
+          bool noValue = std::is_empty<ValueType>::value &&
+                         std::is_default_constructible<ValueType>::value>
+struct MapNode {
+    KeyType key;     /* The key stored in this node         */
+    ValueType value; /* The corresponding value             */
+    MapNode* left;   /* Subtree containing all smaller keys */
+    MapNode* right;  /* Subtree containing all larger keys  */
+    MapNode* parent; /* Node whose subtree contains this one */
+    int bf;          /* AVL balance factor                  */
+
+    template <typename... Args>
+    MapNode(const KeyType& key, Args&&... args)
+        : key(key), value(std::forward<Args>(args)...), left(nullptr), right(nullptr),
+          parent(nullptr), bf(0) {
+    }
+};
+
+template <typename KeyType, typename ValueType>
+struct MapNode<KeyType, ValueType, true> {
+    KeyType key;
+    static ValueType value;
+    MapNode* left;
+    MapNode* right;
+    MapNode* parent;
+    int bf;
+
+    template <typename... Args>
+    MapNode(const KeyType& key, Args&&...)
+        : key(key), left(nullptr), right(nullptr), parent(nullptr), bf(0) {
+    }
+};
+
+template <typename KeyType, typename ValueType>
+ValueType MapNode<KeyType, ValueType, true>::value;
 
 /*
  * Class: Map<KeyType,ValueType>
@@ -75,6 +130,21 @@ public:
      */
 
     void put(const KeyType& key, const ValueType& value);
+    void put(const KeyType& key, ValueType&& value);
+
+    /*
+     * Method: tryEmplace
+     * Usage: if (map.tryEmplace(key, args...)) ...
+     * --------------------------------------------
+     * Adds an entry for <code>key</code> whose value is constructed from
+     * the remaining arguments, provided that <code>key</code> is not
+     * already present.  The method returns <code>true</code> if it adds
+     * a new entry; an existing entry is left unchanged, and in that case
+     * the value is never constructed.
+     */
+
+    template <typename... Args>
+    bool tryEmplace(const KeyType& key, Args&&... args);
 
     /*
      * Method: get
@@ -86,6 +156,8 @@ public:
      */
 
     ValueType get(const KeyType& key) const;
+    template <typename K>
+    EnableIfTransparent<KeyType, K, ValueType> get(const K& key) const;
 
     /*
      * Method: containsKey
@@ -96,6 +168,8 @@ public:
      */
 
     bool containsKey(const KeyType& key) const;
+    template <typename K>
+    EnableIfTransparent<KeyType, K, bool> containsKey(const K& key) const;
 
     /*
      * Method: remove
@@ -105,6 +179,8 @@ public:
      */
 
     void remove(const KeyType& key);
+    template <typename K>
+    EnableIfTransparent<KeyType, K, void> remove(const K& key);
 
     /*
      * Method: clear
@@ -186,6 +262,81 @@ public:
     template <typename FunctorType>
     void mapAll(FunctorType fn) const;
 
+    /*
+     * Class: Map<KeyType,ValueType>::NodeHandle
+     * -----------------------------------------
+     * A node handle owns one entry that has been taken out of a map with
+     * <code>extract</code>.  The entry can be examined or changed through
+     * the <code>key</code> and <code>value</code> methods and then put into
+     * this or another map of the same type with <code>insert</code>, which
+     * reuses the node instead of allocating a new one.  A handle that still
+     * holds an entry when it is destroyed frees that entry.
+     */
+
+    class NodeHandle;
+
+    /*
+     * Method: extract
+     * Usage: Map<KeyType,ValueType>::NodeHandle node = map.extract(key);
+     * ------------------------------------------------------------------
+     * Removes the entry for <code>key</code> from this map and returns it
+     * in a node handle.  If there is no such entry, the handle is empty.
+     */
+
+    NodeHandle extract(const KeyType& key);
+
+    /*
+     * Method: insert
+     * Usage: if (map.insert(std::move(node))) ...
+     * -------------------------------------------
+     * Adds the entry held by <code>node</code> to this map, provided that
+     * the map does not already have an entry with that key.  The method
+     * returns <code>true</code> and leaves the handle empty if it adds the
+     * entry; otherwise the handle keeps the entry.
+     */
+
+    bool insert(NodeHandle&& node);
+
+    /*
+     * Class: Map<KeyType,ValueType>::iterator
+     * ---------------------------------------
+     * A bidirectional iterator over the keys of a map in ascending order.
+     * The iterator is a single node pointer, so copying it is cheap, and
+     * stepping forward or backward needs no extra storage.  Inserting
+     * into the map does not invalidate iterators; removing an entry
+     * invalidates only the iterators that refer to that entry.
+     */
+
+    class iterator;
+
+    /*
+     * Methods: lowerBound, upperBound
+     * Usage: for (auto it = map.lowerBound(lo); it != map.upperBound(hi); ++it) ...
+     * -----------------------------------------------------------------------------
+     * Returns an iterator positioned at the first key that is not less
+     * than <code>key</code> (<code>lowerBound</code>) or greater than
+     * <code>key</code> (<code>upperBound</code>).  Together they select the
+     * keys in a range.  If there is no such key, the result is
+     * <code>end()</code>.
+     */
+
+    iterator lowerBound(const KeyType& key) const;
+    iterator upperBound(const KeyType& key) const;
+
+    /*
+     * Methods: floor, ceiling
+     * Usage: auto it = map.floor(key);
+     * --------------------------------
+     * Returns an iterator positioned at the largest key that is less than
+     * or equal to <code>key</code> (<code>floor</code>) or at the smallest
+     * key that is greater than or equal to <code>key</code>
+     * (<code>ceiling</code>).  If there is no such key, the result is
+     * <code>end()</code>.
+     */
+
+    iterator floor(const KeyType& key) const;
+    iterator ceiling(const KeyType& key) const;
+
     /*
      * Additional Map operations
      * -------------------------
@@ -194,7 +345,10 @@ public:
      *
      *   - Stream I/O using the << and >> operators
      *   - Deep copying for the copy constructor and assignment operator
-     *   - Iteration using the range-based for statement and STL iterators
+     *   - Iteration using the range-based for statement and STL iterators,
+     *     in either direction using rbegin and rend
+     *   - Lookup by std::string_view or C string in a map whose keys are
+     *     strings, using get, containsKey, and remove (see transparentkey.h)
      *
      * All iteration is guaranteed to proceed in the order established by
      * the comparison function passed to the constructor, which ordinarily
@@ -214,6 +368,19 @@ public:
      * The map class is represented using a binary search tree.  The
      * specific implementation used here is the classic AVL algorithm
      * developed by Georgii Adel'son-Vel'skii and Evgenii Landis in 1962.
+     *
+     * The nodes come from a NodePool owned by the map, so most allocations
+     * just advance a pointer, and clear and the destructor return all of
+     * the nodes to the heap at once.  The pool is held by a shared_ptr so
+     * that a node handle can keep the storage of its node alive after the
+     * map is cleared.  A map that receives a node from another map's pool
+     * keeps that pool alive in adoptedPools until it is itself cleared.
+     *
+     * Every node records its parent.  The methods that restructure the
+     * tree take the subtree root by reference, and they all leave the
+     * parent pointer of whatever node ends up in that position equal to
+     * the parent pointer of the node that was there before, so the parent
+     * links only need explicit attention where a node is newly attached.
      */
 
 private:
@@ -223,15 +390,10 @@ private:
     static const int BST_IN_BALANCE = 0;
     static const int BST_RIGHT_HEAVY = +1;
 
-    /* Type definition for nodes in the binary search tree */
+    /* Type definitions for nodes in the binary search tree */
 
-    struct BSTNode {
-        KeyType key;     /* The key stored in this node         */
-        ValueType value; /* The corresponding value             */
-        BSTNode* left;   /* Subtree containing all smaller keys */
-        BSTNode* right;  /* Subtree containing all larger keys  */
-        int bf;          /* AVL balance factor                  */
-    };
+    typedef MapNode<KeyType, ValueType> BSTNode;
+    typedef NodePool<BSTNode> Pool;
 
     /*
      * Implementation notes: Comparator
@@ -256,6 +418,7 @@ private:
         }
 
         virtual bool lessThan(const KeyType& k1, const KeyType& k2) = 0;
+        virtual bool isDefaultOrder() = 0;
         virtual Comparator* clone() = 0;
     };
 
@@ -274,6 +437,10 @@ private:
             return (*cmp)(k1, k2);
         }
 
+        virtual bool isDefaultOrder() {
+            return std::is_same<CompareType, std::less<KeyType>>::value;
+        }
+
         virtual Comparator* clone() {
             return new TemplateComparator<CompareType>(*cmp);
         }
@@ -286,11 +453,18 @@ private:
         return *cmpp;
     }
 
+    /* FlatMap shares the comparator classes and reads the tree directly */
+
+    template <typename K, typename V>
+    friend class FlatMap;
+
     /* Instance variables */
 
-    BSTNode* root;    /* Pointer to the root of the tree */
-    int nodeCount;    /* Number of entries in the map    */
-    Comparator* cmpp; /* Pointer to the comparator       */
+    BSTNode* root;                              /* Pointer to the root of the tree */
+    int nodeCount;                              /* Number of entries in the map    */
+    Comparator* cmpp;                           /* Pointer to the comparator       */
+    std::shared_ptr<Pool> pool;                 /* Source of new nodes             */
+    Vector<std::shared_ptr<Pool>> adoptedPools; /* Pools of nodes from other maps  */
 
     /* Private methods */
 
@@ -317,25 +491,134 @@ private:
     }
 
     /*
-     * Implementation notes: addNode(t, key, heightFlag)
-     * -------------------------------------------------
+     * Implementation notes: findLookupKey(key)
+     * ----------------------------------------
+     * Finds the value cell for a lookup key of a type other than KeyType.
+     * When the map uses the default ordering, the lookup key is compared
+     * directly against the stored keys with the < operator, so no KeyType
+     * value is built.  A map with a client comparator can only compare
+     * KeyType values, so in that case the key is converted once.
+     */
+
+    template <typename K>
+    ValueType* findLookupKey(const K& key) const {
+        if (!cmpp->isDefaultOrder())
+            return findNode(root, KeyType(key));
+        BSTNode* t = root;
+        while (t != nullptr) {
+            if (key < t->key) {
+                t = t->left;
+            } else if (t->key < key) {
+                t = t->right;
+            } else {
+                return &t->value;
+            }
+        }
+        return nullptr;
+    }
+
+    /*
+     * Implementation notes: leftmost, rightmost, successor, predecessor
+     * -----------------------------------------------------------------
+     * These methods step through the tree in order using the parent
+     * pointers.  The successor of a node is the leftmost node in its right
+     * subtree if there is one; otherwise it is the first ancestor reached
+     * from a left child.  A step takes amortized constant time.
+     */
+
+    static BSTNode* leftmost(BSTNode* t) {
+        if (t != nullptr) {
+            while (t->left != nullptr) {
+                t = t->left;
+            }
+        }
+        return t;
+    }
+
+    static BSTNode* rightmost(BSTNode* t) {
+        if (t != nullptr) {
+            while (t->right != nullptr) {
+                t = t->right;
+            }
+        }
+        return t;
+    }
+
+    static BSTNode* successor(BSTNode* np) {
+        if (np->right != nullptr)
+            return leftmost(np->right);
+        while (np->parent != nullptr && np == np->parent->right) {
+            np = np->parent;
+        }
+        return np->parent;
+    }
+
+    static BSTNode* predecessor(BSTNode* np) {
+        if (np->left != nullptr)
+            return rightmost(np->left);
+        while (np->parent != nullptr && np == np->parent->left) {
+            np = np->parent;
+        }
+        return np->parent;
+    }
+
+    /*
+     * Implementation notes: findBound(key, strict), findFloor(key)
+     * ------------------------------------------------------------
+     * The findBound method descends from the root and returns the first
+     * node whose key is greater than or equal to key, or strictly greater
+     * if strict is true.  The findFloor method is its mirror image and
+     * returns the last node whose key is less than or equal to key.
+     */
+
+    BSTNode* findBound(const KeyType& key, bool strict) const {
+        BSTNode* best = nullptr;
+        BSTNode* t = root;
+        while (t != nullptr) {
+            bool above = strict ? cmpp->lessThan(key, t->key) : !cmpp->lessThan(t->key, key);
+            if (above) {
+                best = t;
+                t = t->left;
+            } else {
+                t = t->right;
+            }
+        }
+        return best;
+    }
+
+    BSTNode* findFloor(const KeyType& key) const {
+        BSTNode* best = nullptr;
+        BSTNode* t = root;
+        while (t != nullptr) {
+            if (cmpp->lessThan(key, t->key)) {
+                t = t->left;
+            } else {
+                best = t;
+                t = t->right;
+            }
+        }
+        return best;
+    }
+
+    /*
+     * Implementation notes: addNode(t, key, heightFlag, args...)
+     * ----------------------------------------------------------
      * Searches the tree rooted at t to find the specified key, searching
      * in the left or right subtree, as approriate.  If a matching node
      * is found, addNode returns a pointer to the value cell in that node,
      * just like findNode.  If no matching node exists in the tree, addNode
-     * creates a new node with a default value.  The heightFlag reference
-     * parameter returns a bool indicating whether the height of the tree
-     * was changed by this operation.
+     * creates a new node whose value is constructed from the remaining
+     * arguments, which produces the default value if there are none.  The
+     * arguments are used only when a node is created.  The heightFlag
+     * reference parameter returns a bool indicating whether the height of
+     * the tree was changed by this operation.
      */
 
-    ValueType* addNode(BSTNode*& t, const KeyType& key, bool& heightFlag) {
+    template <typename... Args>
+    ValueType* addNode(BSTNode*& t, const KeyType& key, bool& heightFlag, Args&&... args) {
         heightFlag = false;
         if (t == nullptr) {
-            t = new BSTNode();
-            t->key = key;
-            t->value = ValueType();
-            t->bf = BST_IN_BALANCE;
-            t->left = t->right = nullptr;
+            t = makeNode(key, std::forward<Args>(args)...);
             heightFlag = true;
             nodeCount++;
             return &t->value;
@@ -346,11 +629,13 @@ private:
         ValueType* vp = nullptr;
         int bfDelta = BST_IN_BALANCE;
         if (sign < 0) {
-            vp = addNode(t->left, key, heightFlag);
+            vp = addNode(t->left, key, heightFlag, std::forward<Args>(args)...);
+            t->left->parent = t;
             if (heightFlag)
                 bfDelta = BST_LEFT_HEAVY;
         } else {
-            vp = addNode(t->right, key, heightFlag);
+            vp = addNode(t->right, key, heightFlag, std::forward<Args>(args)...);
+            t->right->parent = t;
             if (heightFlag)
                 bfDelta = BST_RIGHT_HEAVY;
         }
@@ -360,25 +645,27 @@ private:
     }
 
     /*
-     * Implementation notes: removeNode(t, key)
-     * ----------------------------------------
-     * Removes the node containing the specified key from the tree rooted
-     * at t.  The return value is true if the height of this subtree
-     * changes.  The removeTargetNode method does the actual deletion.
+     * Implementation notes: removeNode(t, key, removed)
+     * -------------------------------------------------
+     * Unlinks the node containing the specified key from the tree rooted
+     * at t and stores it in removed, which is left unchanged if there is
+     * no such node.  The node itself is not destroyed.  The return value
+     * is true if the height of this subtree changes.  The removeTargetNode
+     * method does the actual unlinking.
      */
 
-    bool removeNode(BSTNode*& t, const KeyType& key) {
+    bool removeNode(BSTNode*& t, const KeyType& key, BSTNode*& removed) {
         if (t == nullptr)
             return false;
         int sign = compareKeys(key, t->key);
         if (sign == 0)
-            return removeTargetNode(t);
+            return removeTargetNode(t, removed);
         int bfDelta = BST_IN_BALANCE;
         if (sign < 0) {
-            if (removeNode(t->left, key))
+            if (removeNode(t->left, key, removed))
                 bfDelta = BST_RIGHT_HEAVY;
         } else {
-            if (removeNode(t->right, key))
+            if (removeNode(t->right, key, removed))
                 bfDelta = BST_LEFT_HEAVY;
         }
         updateBF(t, bfDelta);
@@ -386,37 +673,39 @@ private:
     }
 
     /*
-     * Implementation notes: removeTargetNode(t)
-     * -----------------------------------------
-     * Removes the node which is passed by reference as t.  The easy case
+     * Implementation notes: removeTargetNode(t, removed)
+     * --------------------------------------------------
+     * Unlinks the node which is passed by reference as t.  The easy case
      * occurs when either (or both) of the children is nullptr; all you need
      * to do is replace the node with its non-nullptr child, if any.  If both
-     * children are non-nullptr, this code finds the rightmost descendent of
-     * the left child; this node may not be a leaf, but will have no right
-     * child.  Its left child replaces it in the tree, after which the
-     * replacement data is moved to the position occupied by the target node.
-     */
-
-    bool removeTargetNode(BSTNode*& t) {
-        BSTNode* toDelete = t;
-        if (t->left == nullptr) {
-            t = t->right;
-            delete toDelete;
-            nodeCount--;
-            return true;
-        } else if (t->right == nullptr) {
-            t = t->left;
-            delete toDelete;
-            nodeCount--;
+     * children are non-nullptr, this code detaches the rightmost descendent
+     * of the left child, which has no right child, and links that node into
+     * the position occupied by the target node.  Relinking the nodes rather
+     * than copying the replacement's key and value leaves the target node
+     * intact, which is what extract needs.
+     */
+
+    bool removeTargetNode(BSTNode*& t, BSTNode*& removed) {
+        removed = t;
+        nodeCount--;
+        if (t->left == nullptr || t->right == nullptr) {
+            BSTNode* parent = t->parent;
+            t = (t->left == nullptr) ? t->right : t->left;
+            if (t != nullptr)
+                t->parent = parent;
             return true;
         } else {
-            BSTNode* successor = t->left;
-            while (successor->right != nullptr) {
-                successor = successor->right;
-            }
-            t->key = successor->key;
-            t->value = successor->value;
-            if (removeNode(t->left, successor->key)) {
+            bool heightFlag = false;
+            BSTNode* replacement = detachRightmost(t->left, heightFlag);
+            replacement->left = t->left;
+            if (replacement->left != nullptr)
+                replacement->left->parent = replacement;
+            replacement->right = t->right;
+            replacement->right->parent = replacement;
+            replacement->parent = t->parent;
+            replacement->bf = t->bf;
+            t = replacement;
+            if (heightFlag) {
                 updateBF(t, BST_RIGHT_HEAVY);
                 return (t->bf == BST_IN_BALANCE);
             }
@@ -424,6 +713,31 @@ private:
         }
     }
 
+    /*
+     * Implementation notes: detachRightmost(t, heightFlag)
+     * ----------------------------------------------------
+     * Unlinks and returns the rightmost node of the nonempty tree rooted
+     * at t, rebalancing on the way back up.  The heightFlag reference
+     * parameter returns whether the height of the tree decreased.
+     */
+
+    BSTNode* detachRightmost(BSTNode*& t, bool& heightFlag) {
+        if (t->right == nullptr) {
+            BSTNode* np = t;
+            t = t->left;
+            if (t != nullptr)
+                t->parent = np->parent;
+            heightFlag = true;
+            return np;
+        }
+        BSTNode* np = detachRightmost(t->right, heightFlag);
+        if (heightFlag) {
+            updateBF(t, BST_LEFT_HEAVY);
+            heightFlag = (t->bf == BST_IN_BALANCE);
+        }
+        return np;
+    }
+
     /*
      * Implementation notes: updateBF(t, bfDelta)
      * ------------------------------------------
@@ -491,7 +805,11 @@ private:
     void rotateLeft(BSTNode*& t) {
         BSTNode* child = t->right;
         t->right = child->left;
+        if (t->right != nullptr)
+            t->right->parent = t;
         child->left = t;
+        child->parent = t->parent;
+        t->parent = child;
         t = child;
     }
 
@@ -546,22 +864,80 @@ private:
     void rotateRight(BSTNode*& t) {
         BSTNode* child = t->left;
         t->left = child->right;
+        if (t->left != nullptr)
+            t->left->parent = t;
         child->right = t;
+        child->parent = t->parent;
+        t->parent = child;
         t = child;
     }
 
     /*
-     * Implementation notes: deleteTree(t)
-     * -----------------------------------
-     * Deletes all the nodes in the tree.
+     * Implementation notes: makeNode, freeNode, poolOf
+     * ------------------------------------------------
+     * The makeNode method constructs a node in storage from the pool.
+     * Its second form links in the node held by a handle instead.  The
+     * freeNode method destroys a single node and gives its storage back
+     * to the pool; storage that belongs to an adopted pool is simply left
+     * there until the map is cleared.  The poolOf method finds the pool
+     * that a node belongs to.
      */
 
-    void deleteTree(BSTNode* t) {
+    template <typename... Args>
+    BSTNode* makeNode(const KeyType& key, Args&&... args) {
+        if (!pool)
+            pool = std::make_shared<Pool>();
+        return new (pool->allocate()) BSTNode(key, std::forward<Args>(args)...);
+    }
+
+    BSTNode* makeNode(const KeyType&, NodeHandle& node) {
+        BSTNode* np = node.np;
+        node.np = nullptr;
+        return np;
+    }
+
+    void freeNode(BSTNode* np) {
+        np->~BSTNode();
+        if (adoptedPools.isEmpty() || (pool && pool->owns(np)))
+            pool->deallocate(np);
+    }
+
+    std::shared_ptr<Pool> poolOf(BSTNode* np) const {
+        for (const std::shared_ptr<Pool>& pp : adoptedPools) {
+            if (pp->owns(np))
+                return pp;
+        }
+        return pool;
+    }
+
+    /*
+     * Implementation notes: destroyTree(t), releaseNodes()
+     * ----------------------------------------------------
+     * The destroyTree method runs the destructors of all the nodes in the
+     * tree but leaves their storage in the pool.  If the nodes have trivial
+     * destructors, there is nothing to do, and the tree is not even walked.
+     * The releaseNodes method then frees the storage of every node at once.
+     * If a node handle still shares the pool, the map lets go of the pool
+     * and starts a new one the next time it needs a node.
+     */
+
+    void destroyTree(BSTNode* t) {
+        if (std::is_trivially_destructible<BSTNode>::value)
+            return;
         if (t != nullptr) {
-            deleteTree(t->left);
-            deleteTree(t->right);
-            delete t;
+            destroyTree(t->left);
+            destroyTree(t->right);
+            t->~BSTNode();
+        }
+    }
+
+    void releaseNodes() {
+        if (pool && pool.use_count() == 1) {
+            pool->release();
+        } else {
+            pool = nullptr;
         }
+        adoptedPools.clear();
     }
 
     /*
@@ -601,15 +977,48 @@ private:
         cmpp = other.cmpp->clone();
     }
 
+    /*
+     * Implementation notes: buildTree(start, finish, keyAt, height)
+     * -------------------------------------------------------------
+     * Builds a balanced tree from the keys keyAt(start) through
+     * keyAt(finish - 1) by making the middle key the root.  The left
+     * subtree is built first, so the nodes are allocated in key order.
+     * The height reference parameter returns the height of the new tree,
+     * from which the caller computes its balance factor.
+     */
+
+    template <typename KeyFn>
+    BSTNode* buildTree(int start, int finish, KeyFn& keyAt, int& height) {
+        if (start == finish) {
+            height = 0;
+            return nullptr;
+        }
+        int mid = start + (finish - start) / 2;
+        int leftHeight, rightHeight;
+        BSTNode* left = buildTree(start, mid, keyAt, leftHeight);
+        BSTNode* np = makeNode(keyAt(mid));
+        np->left = left;
+        if (left != nullptr)
+            left->parent = np;
+        np->right = buildTree(mid + 1, finish, keyAt, rightHeight);
+        if (np->right != nullptr)
+            np->right->parent = np;
+        np->bf = rightHeight - leftHeight;
+        height = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+        return np;
+    }
+
     BSTNode* copyTree(BSTNode* const t) {
         if (t == nullptr)
             return nullptr;
-        BSTNode* np = new BSTNode();
-        np->key = t->key;
-        np->value = t->value;
+        BSTNode* np = makeNode(t->key, t->value);
         np->bf = t->bf;
         np->left = copyTree(t->left);
+        if (np->left != nullptr)
+            np->left->parent = np;
         np->right = copyTree(t->right);
+        if (np->right != nullptr)
+            np->right->parent = np;
         return np;
     }
 
@@ -668,60 +1077,147 @@ public:
         deepCopy(src);
     }
 
+    /*
+     * Move support
+     * ------------
+     * Moving a map transfers its tree without copying any nodes.  The
+     * source map is left empty but keeps a usable comparator.
+     */
+
+    Map(Map&& src) : pool(std::move(src.pool)), adoptedPools(std::move(src.adoptedPools)) {
+        root = src.root;
+        nodeCount = src.nodeCount;
+        cmpp = src.cmpp->clone();
+        src.root = nullptr;
+        src.nodeCount = 0;
+    }
+
+    Map& operator=(Map&& src) {
+        if (this != &src) {
+            std::swap(root, src.root);
+            std::swap(nodeCount, src.nodeCount);
+            std::swap(cmpp, src.cmpp);
+            std::swap(pool, src.pool);
+            std::swap(adoptedPools, src.adoptedPools);
+            src.clear();
+        }
+        return *this;
+    }
+
+    /*
+     * Bulk construction support
+     * -------------------------
+     * The buildSorted method replaces the contents of this map with n
+     * entries whose keys are keyAt(0) through keyAt(n - 1) and whose values
+     * are the default for ValueType.  The keys must be in strictly
+     * increasing order and must not refer to entries of this map.  The map
+     * takes its comparator from order, which may be the map itself.  Since
+     * the order is known in advance, the balanced tree is built directly in
+     * linear time, with no comparisons or rotations.
+     */
+
+    template <typename KeyFn>
+    void buildSorted(const Map& order, int n, KeyFn keyAt) {
+        clear();
+        if (&order != this) {
+            delete cmpp;
+            cmpp = order.cmpp->clone();
+        }
+        int height;
+        root = buildTree(0, n, keyAt, height);
+        nodeCount = n;
+    }
+
+    /*
+     * Node handle support
+     * -------------------
+     * A NodeHandle holds a node together with a reference to the pool that
+     * contains it, so that the node stays valid even if its map is cleared
+     * or destroyed.
+     */
+
+    class NodeHandle {
+    public:
+        NodeHandle() : np(nullptr) {
+            /* Empty */
+        }
+
+        NodeHandle(NodeHandle&& src) : np(src.np), pool(std::move(src.pool)) {
+            src.np = nullptr;
+        }
+
+        NodeHandle& operator=(NodeHandle&& src) {
+            if (this != &src) {
+                reset();
+                np = src.np;
+                pool = std::move(src.pool);
+                src.np = nullptr;
+            }
+            return *this;
+        }
+
+        NodeHandle(const NodeHandle&) = delete;
+        NodeHandle& operator=(const NodeHandle&) = delete;
+
+        ~NodeHandle() {
+            reset();
+        }
+
+        bool isEmpty() const {
+            return np == nullptr;
+        }
+
+        KeyType& key() const {
+            return np->key;
+        }
+
+        ValueType& value() const {
+            return np->value;
+        }
+
+    private:
+        BSTNode* np;                /* The node, or nullptr if empty   */
+        std::shared_ptr<Pool> pool; /* The pool that contains the node */
+
+        void reset() {
+            if (np != nullptr) {
+                np->~BSTNode();
+                pool->deallocate(np);
+                np = nullptr;
+            }
+            pool = nullptr;
+        }
+
+        friend class Map;
+    };
+
     /*
      * Iterator support
      * ----------------
-     * The classes in the StanfordCPPLib collection implement input
-     * iterators so that they work symmetrically with respect to the
-     * corresponding STL classes.
+     * The map iterator is bidirectional, so it also works with the STL
+     * reverse_iterator adapter, which is what rbegin and rend return.
+     * The past-the-end iterator holds a null node pointer; decrementing
+     * it moves to the last key.
      */
 
     class iterator {
     public:
-        using iterator_category = std::input_iterator_tag;
+        using iterator_category = std::bidirectional_iterator_tag;
         using value_type = KeyType;
         using difference_type = std::ptrdiff_t;
-        using pointer = KeyType*;
-        using reference = KeyType&;
+        using pointer = const KeyType*;
+        using reference = const KeyType&;
 
-        iterator() {
+        iterator() : mp(nullptr), np(nullptr) {
             /* Empty */
         }
 
-        iterator(const Map* mp, bool end) {
-            this->mp = mp;
-            if (end || mp->nodeCount == 0) {
-                index = mp->nodeCount;
-            } else {
-                index = 0;
-                NodeMarker marker = {mp->root, false};
-                stack.push(marker);
-                findLeftmostChild();
-            }
-        }
-
-        iterator(const iterator& it) {
-            mp = it.mp;
-            index = it.index;
-            stack = it.stack;
+        iterator(const Map* mp, BSTNode* np) : mp(mp), np(np) {
+            /* Empty */
         }
 
         iterator& operator++() {
-            NodeMarker marker = stack.pop();
-            BSTNode* np = marker.np;
-            if (np->right == nullptr) {
-                while (!stack.isEmpty() && stack.peek().processed) {
-                    stack.pop();
-                }
-            } else {
-                marker.processed = true;
-                stack.push(marker);
-                marker.np = np->right;
-                marker.processed = false;
-                stack.push(marker);
-                findLeftmostChild();
-            }
-            index++;
+            np = successor(np);
             return *this;
         }
 
@@ -731,52 +1227,56 @@ public:
             return copy;
         }
 
-        bool operator==(const iterator& rhs) {
-            return mp == rhs.mp && index == rhs.index;
+        iterator& operator--() {
+            np = (np == nullptr) ? rightmost(mp->root) : predecessor(np);
+            return *this;
+        }
+
+        iterator operator--(int) {
+            iterator copy(*this);
+            operator--();
+            return copy;
+        }
+
+        bool operator==(const iterator& rhs) const {
+            return mp == rhs.mp && np == rhs.np;
         }
 
-        bool operator!=(const iterator& rhs) {
+        bool operator!=(const iterator& rhs) const {
             return !(*this == rhs);
         }
 
-        KeyType operator*() {
-            return stack.peek().np->key;
+        const KeyType& operator*() const {
+            return np->key;
         }
 
-        KeyType* operator->() {
-            return &stack.peek().np->key;
+        const KeyType* operator->() const {
+            return &np->key;
         }
 
         friend class Map;
 
     private:
-        struct NodeMarker {
-            BSTNode* np;
-            bool processed;
-        };
-
-        const Map* mp;           /* Pointer to the map         */
-        int index;               /* Index of current element   */
-        Stack<NodeMarker> stack; /* Stack of unprocessed nodes */
-
-        void findLeftmostChild() {
-            BSTNode* np = stack.peek().np;
-            if (np == nullptr)
-                return;
-            while (np->left != nullptr) {
-                NodeMarker marker = {np->left, false};
-                stack.push(marker);
-                np = np->left;
-            }
-        }
+        const Map* mp; /* Pointer to the map                 */
+        BSTNode* np;   /* Current node, or nullptr at the end */
     };
 
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+
     iterator begin() const {
-        return iterator(this, false);
+        return iterator(this, leftmost(root));
     }
 
     iterator end() const {
-        return iterator(this, true);
+        return iterator(this, nullptr);
+    }
+
+    reverse_iterator rbegin() const {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() const {
+        return reverse_iterator(begin());
     }
 };
 
@@ -799,7 +1299,7 @@ Map<KeyType, ValueType>::Map(std::initializer_list<std::pair<KeyType, ValueType>
 template <typename KeyType, typename ValueType>
 Map<KeyType, ValueType>::~Map() {
     delete cmpp;
-    deleteTree(root);
+    destroyTree(root);
 }
 
 template <typename KeyType, typename ValueType>
@@ -815,7 +1315,28 @@ bool Map<KeyType, ValueType>::isEmpty() const {
 template <typename KeyType, typename ValueType>
 void Map<KeyType, ValueType>::put(const KeyType& key, const ValueType& value) {
     bool dummy;
-    *addNode(root, key, dummy) = value;
+    int oldCount = nodeCount;
+    ValueType* vp = addNode(root, key, dummy, value);
+    if (nodeCount == oldCount)
+        *vp = value;
+}
+
+template <typename KeyType, typename ValueType>
+void Map<KeyType, ValueType>::put(const KeyType& key, ValueType&& value) {
+    bool dummy;
+    int oldCount = nodeCount;
+    ValueType* vp = addNode(root, key, dummy, std::move(value));
+    if (nodeCount == oldCount)
+        *vp = std::move(value);
+}
+
+template <typename KeyType, typename ValueType>
+template <typename... Args>
+bool Map<KeyType, ValueType>::tryEmplace(const KeyType& key, Args&&... args) {
+    bool dummy;
+    int oldCount = nodeCount;
+    addNode(root, key, dummy, std::forward<Args>(args)...);
+    return nodeCount != oldCount;
 }
 
 template <typename KeyType, typename ValueType>
@@ -826,23 +1347,116 @@ ValueType Map<KeyType, ValueType>::get(const KeyType& key) const {
     return *vp;
 }
 
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, ValueType> Map<KeyType, ValueType>::get(const K& key) const {
+    ValueType* vp = findLookupKey(key);
+    if (vp == nullptr)
+        return ValueType();
+    return *vp;
+}
+
 template <typename KeyType, typename ValueType>
 void Map<KeyType, ValueType>::remove(const KeyType& key) {
-    removeNode(root, key);
+    BSTNode* removed = nullptr;
+    removeNode(root, key, removed);
+    if (removed != nullptr)
+        freeNode(removed);
+}
+
+/*
+ * Implementation notes: remove(key) for lookup keys
+ * -------------------------------------------------
+ * The search runs without building a KeyType value, which is therefore
+ * created only when there is actually a node to remove.
+ */
+
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, void> Map<KeyType, ValueType>::remove(const K& key) {
+    if (findLookupKey(key) != nullptr)
+        remove(KeyType(key));
 }
 
 template <typename KeyType, typename ValueType>
 void Map<KeyType, ValueType>::clear() {
-    deleteTree(root);
+    destroyTree(root);
+    releaseNodes();
     root = nullptr;
     nodeCount = 0;
 }
 
+template <typename KeyType, typename ValueType>
+typename Map<KeyType, ValueType>::NodeHandle Map<KeyType, ValueType>::extract(const KeyType& key) {
+    NodeHandle node;
+    BSTNode* removed = nullptr;
+    removeNode(root, key, removed);
+    if (removed != nullptr) {
+        removed->left = removed->right = removed->parent = nullptr;
+        removed->bf = BST_IN_BALANCE;
+        node.pool = poolOf(removed);
+        node.np = removed;
+    }
+    return node;
+}
+
+template <typename KeyType, typename ValueType>
+bool Map<KeyType, ValueType>::insert(NodeHandle&& node) {
+    if (node.isEmpty())
+        return false;
+    std::shared_ptr<Pool> origin = node.pool;
+    bool dummy;
+    int oldCount = nodeCount;
+    addNode(root, node.np->key, dummy, node);
+    if (nodeCount == oldCount)
+        return false;
+    node.pool = nullptr;
+    if (origin != pool) {
+        bool known = false;
+        for (const std::shared_ptr<Pool>& pp : adoptedPools) {
+            if (pp == origin)
+                known = true;
+        }
+        if (!known)
+            adoptedPools.add(origin);
+    }
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+typename Map<KeyType, ValueType>::iterator
+Map<KeyType, ValueType>::lowerBound(const KeyType& key) const {
+    return iterator(this, findBound(key, false));
+}
+
+template <typename KeyType, typename ValueType>
+typename Map<KeyType, ValueType>::iterator
+Map<KeyType, ValueType>::upperBound(const KeyType& key) const {
+    return iterator(this, findBound(key, true));
+}
+
+template <typename KeyType, typename ValueType>
+typename Map<KeyType, ValueType>::iterator Map<KeyType, ValueType>::floor(const KeyType& key) const {
+    return iterator(this, findFloor(key));
+}
+
+template <typename KeyType, typename ValueType>
+typename Map<KeyType, ValueType>::iterator
+Map<KeyType, ValueType>::ceiling(const KeyType& key) const {
+    return iterator(this, findBound(key, false));
+}
+
 template <typename KeyType, typename ValueType>
 bool Map<KeyType, ValueType>::containsKey(const KeyType& key) const {
     return findNode(root, key) != nullptr;
 }
 
+template <typename KeyType, typename ValueType>
+template <typename K>
+EnableIfTransparent<KeyType, K, bool> Map<KeyType, ValueType>::containsKey(const K& key) const {
+    return findLookupKey(key) != nullptr;
+}
+
 template <typename KeyType, typename ValueType>
 ValueType& Map<KeyType, ValueType>::operator[](const KeyType& key) {
     bool dummy;
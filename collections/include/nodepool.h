@@ -0,0 +1,143 @@
+/*
+ * File: nodepool.h
+ * ----------------
+ * This file exports the <code>NodePool</code> class, a slab allocator
+ * that the tree-based collections use to allocate their nodes.
+ */
+
+#ifndef _nodepool_h
+#define _nodepool_h
+
+#include <cstddef>
+
+/*
+ * Class: NodePool<NodeType>
+ * -------------------------
+ * This class hands out uninitialized storage for objects of a single
+ * node type.  Storage is carved out of large slabs, so allocating a node
+ * usually just advances a pointer, and storage that is given back is
+ * kept on a free list for reuse.  The slabs are returned to the heap all
+ * at once by <code>release</code> or by the destructor, which do not run
+ * any node destructors; the client must destroy its nodes first.
+ */
+
+template <typename NodeType>
+class NodePool {
+public:
+    NodePool() : slabs(nullptr), freeList(nullptr), next(nullptr), limit(nullptr),
+                 nextSlabSize(INITIAL_SLAB_SIZE) {
+        /* Empty */
+    }
+
+    ~NodePool() {
+        release();
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /*
+     * Method: allocate
+     * Usage: void* mem = pool.allocate();
+     * -----------------------------------
+     * Returns uninitialized storage large enough for one node.
+     */
+
+    void* allocate() {
+        if (freeList != nullptr) {
+            Chunk* cp = freeList;
+            freeList = cp->next;
+            return cp;
+        }
+        if (next == limit)
+            addSlab();
+        return next++;
+    }
+
+    /*
+     * Method: deallocate
+     * Usage: pool.deallocate(mem);
+     * ----------------------------
+     * Returns the storage for one node, whose object must already have
+     * been destroyed, to the pool for reuse.
+     */
+
+    void deallocate(void* mem) {
+        Chunk* cp = static_cast<Chunk*>(mem);
+        cp->next = freeList;
+        freeList = cp;
+    }
+
+    /*
+     * Method: owns
+     * Usage: if (pool.owns(mem)) ...
+     * ------------------------------
+     * Returns <code>true</code> if mem points into one of the slabs of
+     * this pool.  The slabs grow geometrically, so there are few of them.
+     */
+
+    bool owns(const void* mem) const {
+        const Chunk* cp = static_cast<const Chunk*>(mem);
+        for (Slab* sp = slabs; sp != nullptr; sp = sp->next) {
+            if (cp >= sp->chunks && cp < sp->chunks + sp->size)
+                return true;
+        }
+        return false;
+    }
+
+    /*
+     * Method: release
+     * Usage: pool.release();
+     * ----------------------
+     * Frees every slab at once, which invalidates all storage obtained
+     * from this pool.  The pool may be used again afterwards.
+     */
+
+    void release() {
+        while (slabs != nullptr) {
+            Slab* sp = slabs;
+            slabs = sp->next;
+            delete[] sp->chunks;
+            delete sp;
+        }
+        freeList = next = limit = nullptr;
+        nextSlabSize = INITIAL_SLAB_SIZE;
+    }
+
+private:
+    /* Each chunk holds either a node or a link in the free list */
+
+    union Chunk {
+        Chunk* next;
+        alignas(NodeType) unsigned char storage[sizeof(NodeType)];
+    };
+
+    struct Slab {
+        Chunk* chunks; /* Array of chunks in this slab */
+        int size;      /* Number of chunks             */
+        Slab* next;    /* Next older slab              */
+    };
+
+    static const int INITIAL_SLAB_SIZE = 16;
+    static const int MAX_SLAB_BYTES = 64 * 1024;
+
+    Slab* slabs;      /* Linked list of slabs, newest first   */
+    Chunk* freeList;  /* Chunks that have been given back     */
+    Chunk* next;      /* Next unused chunk in the newest slab */
+    Chunk* limit;     /* End of the newest slab               */
+    int nextSlabSize; /* Number of chunks in the next slab    */
+
+    void addSlab() {
+        Slab* sp = new Slab;
+        sp->size = nextSlabSize;
+        sp->chunks = new Chunk[sp->size];
+        sp->next = slabs;
+        slabs = sp;
+        next = sp->chunks;
+        limit = sp->chunks + sp->size;
+        if (size_t(nextSlabSize) * sizeof(Chunk) * 2 <= size_t(MAX_SLAB_BYTES))
+            nextSlabSize *= 2;
+    }
+};
+
+#endif  // _nodepool_h
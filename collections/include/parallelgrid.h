@@ -0,0 +1,222 @@
+/*
+ * File: parallelgrid.h
+ * --------------------
+ * This file exports functions that process the elements of a
+ * <code>Grid</code> on the threads of a <code>ThreadPool</code>:
+ * <code>parallelMapAll</code> and <code>parallelTransform</code>, which
+ * apply a function to every element, and the stencil sweeps
+ * <code>neighbors4</code> and <code>neighbors8</code>.  They live in their
+ * own interface so that clients of <code>Grid</code> that never run in
+ * parallel do not depend on the threading library.
+ */
+
+#ifndef _parallelgrid_h
+#define _parallelgrid_h
+
+#include <algorithm>
+#include <string>
+
+#include "grid.h"
+#include "threadpool.h"
+#include "vector.h"
+
+/*
+ * Function: parallelMapAll
+ * Usage: parallelMapAll(grid, fn);
+ *        parallelMapAll(grid, fn, pool);
+ * --------------------------------------
+ * Calls the specified function on each element of the grid, dividing
+ * the rows into blocks that are processed by the threads of
+ * <code>pool</code> or, if it is omitted, of the default pool.  The
+ * blocks are processed in no particular order, and the function must
+ * be safe to call from several threads at once.
+ */
+
+template <typename ValueType, typename FunctorType>
+void parallelMapAll(const Grid<ValueType>& grid, FunctorType fn,
+                    ThreadPool& pool = ThreadPool::getDefault());
+
+/*
+ * Function: parallelTransform
+ * Usage: parallelTransform(grid, fn);
+ *        parallelTransform(grid, fn, pool);
+ * -----------------------------------------
+ * Replaces each element <code>x</code> of the grid with
+ * <code>fn(x)</code>, dividing the rows among the threads of the pool
+ * as <code>parallelMapAll</code> does.
+ */
+
+template <typename ValueType, typename FunctorType>
+void parallelTransform(Grid<ValueType>& grid, FunctorType fn,
+                       ThreadPool& pool = ThreadPool::getDefault());
+
+/*
+ * Functions: neighbors4, neighbors8
+ * Usage: neighbors4(src, dst, fn);
+ *        neighbors8(src, dst, fn, halo, pool);
+ * --------------------------------------------
+ * Computes every element of <code>dst</code> from the element at the
+ * same position in <code>src</code> and its neighbors, which is the
+ * inner step of cellular automata, image filters, and many dynamic
+ * programming recurrences.  For <code>neighbors4</code>, the new
+ * element is <code>fn(center, north, south, west, east)</code>.  For
+ * <code>neighbors8</code>, it is <code>fn(window)</code>, where
+ * <code>window</code> is a 3x3 array of values whose middle element
+ * <code>window[1][1]</code> is the center.  Neighbors that fall
+ * outside the grid have the value <code>halo</code>, which defaults
+ * to the default value of the type.  The destination is resized to
+ * match the source if necessary and must be a different grid.  The
+ * rows are divided among the threads of the pool, and each thread
+ * sweeps its rows from left to right.
+ */
+
+template <typename ValueType, typename ResultType, typename FunctorType>
+void neighbors4(const Grid<ValueType>& src, Grid<ResultType>& dst, FunctorType fn,
+                const ValueType& halo = ValueType(), ThreadPool& pool = ThreadPool::getDefault());
+
+template <typename ValueType, typename ResultType, typename FunctorType>
+void neighbors8(const Grid<ValueType>& src, Grid<ResultType>& dst, FunctorType fn,
+                const ValueType& halo = ValueType(), ThreadPool& pool = ThreadPool::getDefault());
+
+/* Private section */
+
+/**********************************************************************/
+/* Note: Everything below this point in the file is logically part    */
+/* of the implementation and should not be of interest to clients.    */
+/**********************************************************************/
+
+/*
+ * Implementation notes: parallel grid operations
+ * ----------------------------------------------
+ * The functions split the grid into blocks of whole rows holding about
+ * PARALLEL_GRAIN elements, so each thread walks a contiguous part of
+ * the array.  The stencil sweeps read the rows above and below from the
+ * source, or from a row of halo values at the top and bottom edges, and
+ * handle the first and last columns separately so that the loop over
+ * the interior columns has no edge tests.  Because they read only from
+ * the source and write only to the destination, the blocks are
+ * independent.
+ */
+
+namespace internal {
+
+const int PARALLEL_GRAIN = 16384; /* Elements per parallel chunk */
+
+inline int rowsPerChunk(int nCols) {
+    return std::max(1, PARALLEL_GRAIN / std::max(1, nCols));
+}
+
+template <typename ValueType, typename ResultType>
+void prepareDestination(const Grid<ValueType>& src, Grid<ResultType>& dst, const char* prefix) {
+    if (static_cast<const void*>(&dst) == static_cast<const void*>(&src))
+        error(std::string(prefix) + ": Destination must be a different grid");
+    if (dst.numRows() != src.numRows() || dst.numCols() != src.numCols())
+        dst.resize(src.numRows(), src.numCols());
+}
+
+}
+
+template <typename ValueType, typename FunctorType>
+void parallelMapAll(const Grid<ValueType>& grid, FunctorType fn, ThreadPool& pool) {
+    const ValueType* array = grid.data();
+    int width = grid.numCols();
+    pool.parallelFor(grid.numRows(), internal::rowsPerChunk(width),
+                     [array, width, &fn](int start, int end) {
+        for (int i = start * width; i < end * width; i++) {
+            fn(array[i]);
+        }
+    });
+}
+
+template <typename ValueType, typename FunctorType>
+void parallelTransform(Grid<ValueType>& grid, FunctorType fn, ThreadPool& pool) {
+    ValueType* array = grid.data();
+    int width = grid.numCols();
+    pool.parallelFor(grid.numRows(), internal::rowsPerChunk(width),
+                     [array, width, &fn](int start, int end) {
+        for (int i = start * width; i < end * width; i++) {
+            array[i] = fn(array[i]);
+        }
+    });
+}
+
+template <typename ValueType, typename ResultType, typename FunctorType>
+void neighbors4(const Grid<ValueType>& src, Grid<ResultType>& dst, FunctorType fn,
+                const ValueType& halo, ThreadPool& pool) {
+    internal::prepareDestination(src, dst, "neighbors4");
+    int nRows = src.numRows();
+    int nCols = src.numCols();
+    if (nCols == 0)
+        return;
+    Vector<ValueType> haloRow(nCols, halo);
+    const ValueType* edge = haloRow.data();
+    const ValueType* elements = src.data();
+    ResultType* results = dst.data();
+    pool.parallelFor(nRows, internal::rowsPerChunk(nCols),
+                     [=, &fn, &halo](int start, int end) {
+        int last = nCols - 1;
+        for (int r = start; r < end; r++) {
+            const ValueType* mid = elements + r * nCols;
+            const ValueType* up = (r > 0) ? mid - nCols : edge;
+            const ValueType* down = (r < nRows - 1) ? mid + nCols : edge;
+            ResultType* out = results + r * nCols;
+            if (last == 0) {
+                out[0] = fn(mid[0], up[0], down[0], halo, halo);
+                continue;
+            }
+            out[0] = fn(mid[0], up[0], down[0], halo, mid[1]);
+            for (int c = 1; c < last; c++) {
+                out[c] = fn(mid[c], up[c], down[c], mid[c - 1], mid[c + 1]);
+            }
+            out[last] = fn(mid[last], up[last], down[last], mid[last - 1], halo);
+        }
+    });
+}
+
+/*
+ * Implementation notes: neighbors8
+ * --------------------------------
+ * The 3x3 window slides along each row: after every element, its
+ * columns shift left by one and the next column is loaded, so each
+ * value is read from the grid only once per row.
+ */
+
+template <typename ValueType, typename ResultType, typename FunctorType>
+void neighbors8(const Grid<ValueType>& src, Grid<ResultType>& dst, FunctorType fn,
+                const ValueType& halo, ThreadPool& pool) {
+    internal::prepareDestination(src, dst, "neighbors8");
+    int nRows = src.numRows();
+    int nCols = src.numCols();
+    if (nCols == 0)
+        return;
+    Vector<ValueType> haloRow(nCols, halo);
+    const ValueType* edge = haloRow.data();
+    const ValueType* elements = src.data();
+    ResultType* results = dst.data();
+    pool.parallelFor(nRows, internal::rowsPerChunk(nCols),
+                     [=, &fn, &halo](int start, int end) {
+        ValueType window[3][3];
+        for (int r = start; r < end; r++) {
+            const ValueType* rows[3];
+            rows[1] = elements + r * nCols;
+            rows[0] = (r > 0) ? rows[1] - nCols : edge;
+            rows[2] = (r < nRows - 1) ? rows[1] + nCols : edge;
+            ResultType* out = results + r * nCols;
+            for (int k = 0; k < 3; k++) {
+                window[k][0] = halo;
+                window[k][1] = rows[k][0];
+                window[k][2] = (nCols > 1) ? rows[k][1] : halo;
+            }
+            for (int c = 0; c < nCols; c++) {
+                out[c] = fn(static_cast<const ValueType(&)[3][3]>(window));
+                for (int k = 0; k < 3; k++) {
+                    window[k][0] = window[k][1];
+                    window[k][1] = window[k][2];
+                    window[k][2] = (c + 2 < nCols) ? rows[k][c + 2] : halo;
+                }
+            }
+        }
+    });
+}
+
+#endif  // _parallelgrid_h
@@ -0,0 +1,77 @@
+/*
+ * File: parallelvector.h
+ * ----------------------
+ * This file exports the functions <code>parallelMapAll</code> and
+ * <code>parallelTransform</code>, which apply a function to every element
+ * of a <code>Vector</code> using the threads of a <code>ThreadPool</code>.
+ * They live in their own interface so that clients of <code>Vector</code>
+ * that never run in parallel do not depend on the threading library.
+ */
+
+#ifndef _parallelvector_h
+#define _parallelvector_h
+
+#include "threadpool.h"
+#include "vector.h"
+
+/*
+ * Function: parallelMapAll
+ * Usage: parallelMapAll(vec, fn);
+ *        parallelMapAll(vec, fn, pool);
+ * -------------------------------------
+ * Calls the specified function on each element of the vector, using
+ * the threads of <code>pool</code> or, if it is omitted, of the
+ * default pool.  Each thread works through a contiguous block of
+ * elements, and the blocks are processed in no particular order.  The
+ * function is called from several threads at once, so it must be safe
+ * to call concurrently.
+ */
+
+template <typename ValueType, typename FunctorType>
+void parallelMapAll(const Vector<ValueType>& vec, FunctorType fn,
+                    ThreadPool& pool = ThreadPool::getDefault());
+
+/*
+ * Function: parallelTransform
+ * Usage: parallelTransform(vec, fn);
+ *        parallelTransform(vec, fn, pool);
+ * ----------------------------------------
+ * Replaces each element <code>x</code> of the vector with
+ * <code>fn(x)</code>, dividing the work among the threads of the pool
+ * as <code>parallelMapAll</code> does.
+ */
+
+template <typename ValueType, typename FunctorType>
+void parallelTransform(Vector<ValueType>& vec, FunctorType fn,
+                       ThreadPool& pool = ThreadPool::getDefault());
+
+/*
+ * Implementation notes: parallelMapAll, parallelTransform
+ * -------------------------------------------------------
+ * The pool hands each thread chunks of 16384 consecutive elements, which
+ * is enough work to hide the cost of claiming a chunk.  The loop inside
+ * each chunk runs over the raw array, so the compiler is free to
+ * vectorize it.
+ */
+
+template <typename ValueType, typename FunctorType>
+void parallelMapAll(const Vector<ValueType>& vec, FunctorType fn, ThreadPool& pool) {
+    const ValueType* array = vec.data();
+    pool.parallelFor(vec.size(), 16384, [array, &fn](int start, int end) {
+        for (int i = start; i < end; i++) {
+            fn(array[i]);
+        }
+    });
+}
+
+template <typename ValueType, typename FunctorType>
+void parallelTransform(Vector<ValueType>& vec, FunctorType fn, ThreadPool& pool) {
+    ValueType* array = vec.data();
+    pool.parallelFor(vec.size(), 16384, [array, &fn](int start, int end) {
+        for (int i = start; i < end; i++) {
+            array[i] = fn(array[i]);
+        }
+    });
+}
+
+#endif  // _parallelvector_h
@@ -26,7 +26,10 @@
 #ifndef _pqueue_h
 #define _pqueue_h
 
+#include <algorithm>
 #include <initializer_list>
+#include <iterator>
+#include <utility>
 
 #include "vector.h"
 
@@ -43,6 +46,32 @@
 template <typename ValueType>
 class PriorityQueue {
 public:
+    /*
+     * Type: Handle
+     * ------------
+     * A handle identifies one entry in the queue.  It is returned by
+     * <code>enqueue</code> and can be passed to <code>changePriority</code>,
+     * <code>decreaseKey</code>, and <code>remove</code> until that entry
+     * leaves the queue.  A default-constructed handle refers to no entry.
+     */
+
+    class Handle {
+    public:
+        Handle() : slot(-1), sequence(-1) {
+            /* Empty */
+        }
+
+    private:
+        Handle(int slot, long sequence) : slot(slot), sequence(sequence) {
+            /* Empty */
+        }
+
+        int slot;      /* Index of the entry's value in the value array */
+        long sequence; /* Enqueue number of the entry                   */
+
+        friend class PriorityQueue;
+    };
+
     /*
      * Constructor: PriorityQueue
      * Usage: PriorityQueue<ValueType> pq;
@@ -53,6 +82,20 @@ public:
     PriorityQueue();
     PriorityQueue(std::initializer_list<std::pair<double, ValueType>> list);
 
+    /*
+     * Constructor: PriorityQueue
+     * Usage: PriorityQueue<ValueType> pq(first, last);
+     * ------------------------------------------------
+     * Initializes a priority queue from a range of
+     * <code>(priority,&nbsp;value)</code> pairs.  The queue is built in
+     * linear time, and entries of equal priority are dequeued in the order
+     * in which they appear in the range.
+     */
+
+    template <typename IteratorType,
+              typename = typename std::iterator_traits<IteratorType>::iterator_category>
+    PriorityQueue(IteratorType first, IteratorType last);
+
     /*
      * Destructor: ~PriorityQueue
      * --------------------------
@@ -91,14 +134,30 @@ public:
     /*
      * Method: enqueue
      * Usage: pq.enqueue(value, priority);
-     * -----------------------------------
+     *        PriorityQueue<ValueType>::Handle h = pq.enqueue(value, priority);
+     * ------------------------------------------------------------------------
      * Adds <code>value</code> to the queue with the specified priority.
      * Lower priority numbers correspond to higher priorities, which
      * means that all priority 1 elements are dequeued before any
-     * priority 2 elements.
+     * priority 2 elements.  The result is a handle for the new entry,
+     * which callers that never change priorities can ignore.
+     */
+
+    Handle enqueue(ValueType value, double priority);
+
+    /*
+     * Method: enqueueAll
+     * Usage: pq.enqueueAll(first, last);
+     * ----------------------------------
+     * Adds every <code>(priority,&nbsp;value)</code> pair in a range to
+     * the queue, in the same order as that many calls to
+     * <code>enqueue</code> would.  If the range is at least as long as the
+     * queue, the heap is rebuilt in linear time instead.  No handles are
+     * returned for the new entries.
      */
 
-    void enqueue(ValueType value, double priority);
+    template <typename IteratorType>
+    void enqueueAll(IteratorType first, IteratorType last);
 
     /*
      * Method: dequeue
@@ -111,6 +170,18 @@ public:
 
     ValueType dequeue();
 
+    /*
+     * Method: dequeueTopK
+     * Usage: Vector<ValueType> best = pq.dequeueTopK(k);
+     * --------------------------------------------------
+     * Removes the <code>k</code> highest priority values and returns them
+     * in the order in which <code>dequeue</code> would have returned them.
+     * If the queue holds fewer than <code>k</code> values, all of them are
+     * returned.
+     */
+
+    Vector<ValueType> dequeueTopK(int k);
+
     /*
      * Method: peek
      * Usage: ValueType first = pq.peek();
@@ -149,6 +220,52 @@ public:
 
     ValueType& back();
 
+    /*
+     * Method: contains
+     * Usage: if (pq.contains(handle)) ...
+     * -----------------------------------
+     * Returns <code>true</code> if the entry identified by
+     * <code>handle</code> is still in the queue.
+     */
+
+    bool contains(Handle handle) const;
+
+    /*
+     * Method: changePriority
+     * Usage: pq.changePriority(handle, priority);
+     * -------------------------------------------
+     * Gives the entry identified by <code>handle</code> a new priority,
+     * which may be higher or lower than the old one.  The entry keeps its
+     * place among entries of equal priority that were enqueued before or
+     * after it.  If the entry is no longer in the queue,
+     * <code>changePriority</code> generates an error.
+     */
+
+    void changePriority(Handle handle, double priority);
+
+    /*
+     * Method: decreaseKey
+     * Usage: pq.decreaseKey(handle, priority);
+     * ----------------------------------------
+     * Lowers the priority number of the entry identified by
+     * <code>handle</code>, which moves it toward the front of the queue.
+     * It is an error for the new priority number to be greater than the
+     * old one.
+     */
+
+    void decreaseKey(Handle handle, double priority);
+
+    /*
+     * Method: remove
+     * Usage: ValueType value = pq.remove(handle);
+     * -------------------------------------------
+     * Removes the entry identified by <code>handle</code> from the queue
+     * and returns its value.  If the entry is no longer in the queue,
+     * <code>remove</code> generates an error.
+     */
+
+    ValueType remove(Handle handle);
+
     /*
      * Method: toString
      * Usage: string str = pq.toString();
@@ -169,47 +286,90 @@ public:
      * Implementation notes: PriorityQueue data structure
      * --------------------------------------------------
      * The PriorityQueue class is implemented using a data structure called
-     * a heap.
+     * a heap.  The heap is 4-ary rather than binary, which halves its
+     * depth, and each node's children sit next to each other in memory.
+     * The heap itself holds only small entries of priority, sequence
+     * number, and slot; the values live in a separate array indexed by
+     * slot and are moved once on the way in and once on the way out.
+     * The position array maps each slot to the heap index of its entry,
+     * which is how a handle finds its entry, and holds -1 for slots that
+     * are on the free list.
      */
 
 private:
     /* Type used for each heap entry */
 
     struct HeapEntry {
-        ValueType value;
         double priority;
         long sequence;
+        int slot;
     };
 
+    /* Constants */
+
+    static const int ARITY = 4;
+
+    /*
+     * dequeueTopK dequeues one entry at a time when it takes fewer than
+     * one entry in this many; otherwise it selects and sorts the entries
+     * it takes and rebuilds the heap from the rest.
+     */
+
+    static const int TOP_K_RATIO = 16;
+
     /* Instance variables */
 
-    Vector<HeapEntry> heap;
-    long enqueueCount;
-    int backIndex;
-    int count;
-    int capacity;
+    Vector<HeapEntry> heap;    /* Heap-ordered entries               */
+    Vector<ValueType> values;  /* Values, indexed by slot            */
+    Vector<int> position;      /* Heap index for each slot, or -1    */
+    Vector<int> freeSlots;     /* Slots available for reuse          */
+    long enqueueCount;         /* Sequence number for the next entry */
+    int backSlot;              /* Slot of the last entry, or -1      */
 
     /* Private function prototypes */
 
-    void enqueueHeap(ValueType& value, double priority);
-    ValueType dequeueHeap();
-    bool takesPriority(int i1, int i2);
-    void swapHeapEntries(int i1, int i2);
+    static bool takesPriority(const HeapEntry& e1, const HeapEntry& e2);
+    void placeEntry(int index, const HeapEntry& entry);
+    void siftUp(int index);
+    void siftDown(int index);
+    int addEntry(ValueType value, double priority);
+    void heapify();
+    int findEntry(Handle handle, const std::string& caller) const;
+    ValueType removeEntry(int index);
+
+public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * Copying a priority queue copies its heap.  Moving one transfers
+     * the heap to the destination and leaves the source queue empty.
+     */
+
+    PriorityQueue(const PriorityQueue& src) = default;
+    PriorityQueue& operator=(const PriorityQueue& src) = default;
+    PriorityQueue(PriorityQueue&& src);
+    PriorityQueue& operator=(PriorityQueue&& src);
 };
 
 extern void error(std::string msg);
 
 template <typename ValueType>
-PriorityQueue<ValueType>::PriorityQueue() {
+PriorityQueue<ValueType>::PriorityQueue() : enqueueCount(0) {
     clear();
 }
 
 template <typename ValueType>
-PriorityQueue<ValueType>::PriorityQueue(std::initializer_list<std::pair<double, ValueType>> list) {
+PriorityQueue<ValueType>::PriorityQueue(std::initializer_list<std::pair<double, ValueType>> list)
+    : PriorityQueue(list.begin(), list.end()) {
+    /* Empty */
+}
+
+template <typename ValueType>
+template <typename IteratorType, typename>
+PriorityQueue<ValueType>::PriorityQueue(IteratorType first, IteratorType last)
+    : enqueueCount(0) {
     clear();
-    for (std::pair<double, ValueType> pair : list) {
-        enqueue(pair.second, pair.first);
-    }
+    enqueueAll(first, last);
 }
 
 /*
@@ -224,38 +384,97 @@ PriorityQueue<ValueType>::~PriorityQueue() {
     /* Empty */
 }
 
+template <typename ValueType>
+PriorityQueue<ValueType>::PriorityQueue(PriorityQueue&& src)
+    : heap(std::move(src.heap)),
+      values(std::move(src.values)),
+      position(std::move(src.position)),
+      freeSlots(std::move(src.freeSlots)),
+      enqueueCount(src.enqueueCount),
+      backSlot(src.backSlot) {
+    src.clear();
+}
+
+template <typename ValueType>
+PriorityQueue<ValueType>& PriorityQueue<ValueType>::operator=(PriorityQueue&& src) {
+    if (this != &src) {
+        heap = std::move(src.heap);
+        values = std::move(src.values);
+        position = std::move(src.position);
+        freeSlots = std::move(src.freeSlots);
+        enqueueCount = src.enqueueCount;
+        backSlot = src.backSlot;
+        src.clear();
+    }
+    return *this;
+}
+
 template <typename ValueType>
 int PriorityQueue<ValueType>::size() const {
-    return count;
+    return heap.size();
 }
 
 template <typename ValueType>
 bool PriorityQueue<ValueType>::isEmpty() const {
-    return count == 0;
+    return heap.isEmpty();
 }
 
+/*
+ * Implementation notes: clear
+ * ---------------------------
+ * The sequence counter is not reset, so that a handle from before the
+ * call can never match an entry added after it.
+ */
+
 template <typename ValueType>
 void PriorityQueue<ValueType>::clear() {
     heap.clear();
-    count = 0;
+    values.clear();
+    position.clear();
+    freeSlots.clear();
+    backSlot = -1;
 }
 
 template <typename ValueType>
-void PriorityQueue<ValueType>::enqueue(ValueType value, double priority) {
-    if (count == heap.size())
-        heap.add(HeapEntry());
-    int index = count++;
-    heap[index].value = value;
-    heap[index].priority = priority;
-    heap[index].sequence = enqueueCount++;
-    if (index == 0 || takesPriority(backIndex, index))
-        backIndex = index;
-    while (index > 0) {
-        int parent = (index - 1) / 2;
-        if (takesPriority(parent, index))
-            break;
-        swapHeapEntries(parent, index);
-        index = parent;
+typename PriorityQueue<ValueType>::Handle
+PriorityQueue<ValueType>::enqueue(ValueType value, double priority) {
+    int index = addEntry(std::move(value), priority);
+    HeapEntry entry = heap[index];
+    if (index == 0) {
+        backSlot = entry.slot;
+    } else if (backSlot != -1 && takesPriority(heap[position[backSlot]], entry)) {
+        backSlot = entry.slot;
+    }
+    siftUp(index);
+    return Handle(entry.slot, entry.sequence);
+}
+
+/*
+ * Implementation notes: enqueueAll
+ * --------------------------------
+ * The new entries are appended to the end of the heap.  A short range is
+ * then sifted up one entry at a time, as enqueue would do; a range at
+ * least as long as the existing queue is cheaper to absorb by rebuilding
+ * the whole heap bottom-up.  When the range yields rvalues, as a
+ * std::move_iterator does, the values are moved rather than copied.
+ */
+
+template <typename ValueType>
+template <typename IteratorType>
+void PriorityQueue<ValueType>::enqueueAll(IteratorType first, IteratorType last) {
+    int start = heap.size();
+    for (; first != last; ++first) {
+        auto&& pair = *first;
+        addEntry(std::forward<decltype(pair)>(pair).second, pair.first);
+    }
+    if (heap.size() - start >= start) {
+        heapify();
+    } else {
+        for (int i = start; i < heap.size(); i++) {
+            if (backSlot != -1 && takesPriority(heap[position[backSlot]], heap[i]))
+                backSlot = heap[i].slot;
+            siftUp(i);
+        }
     }
 }
 
@@ -268,73 +487,274 @@ void PriorityQueue<ValueType>::enqueue(ValueType value, double priority) {
 
 template <typename ValueType>
 ValueType PriorityQueue<ValueType>::dequeue() {
-    if (count == 0)
+    if (heap.isEmpty())
         error("dequeue: Attempting to dequeue an empty queue");
-    count--;
-    bool wasBack = (backIndex == count);
-    ValueType value = heap[0].value;
-    swapHeapEntries(0, count);
-    int index = 0;
-    while (true) {
-        int left = 2 * index + 1;
-        int right = 2 * index + 2;
-        if (left >= count)
-            break;
-        int child = left;
-        if (right < count && takesPriority(right, left))
-            child = right;
-        if (takesPriority(index, child))
-            break;
-        swapHeapEntries(index, child);
-        index = child;
+    return removeEntry(0);
+}
+
+/*
+ * Implementation notes: dequeueTopK
+ * ---------------------------------
+ * Taking k entries one at a time costs k sifts down the full depth of
+ * the heap.  When k is a sizable fraction of the queue, it is cheaper to
+ * select the k best entries with std::nth_element, sort just those, and
+ * rebuild the heap from the remaining entries, all of which takes
+ * O(n + k log k) time.
+ */
+
+template <typename ValueType>
+Vector<ValueType> PriorityQueue<ValueType>::dequeueTopK(int k) {
+    if (k < 0)
+        error("dequeueTopK: k cannot be negative");
+    int n = heap.size();
+    if (k > n)
+        k = n;
+    Vector<ValueType> result;
+    result.reserve(k);
+    if (k * TOP_K_RATIO < n) {
+        for (int i = 0; i < k; i++) {
+            result.add(removeEntry(0));
+        }
+        return result;
+    }
+    std::nth_element(heap.begin(), heap.begin() + k, heap.end(), takesPriority);
+    std::sort(heap.begin(), heap.begin() + k, takesPriority);
+    for (int i = 0; i < k; i++) {
+        int slot = heap[i].slot;
+        result.add(std::move(values[slot]));
+        position[slot] = -1;
+        freeSlots.add(slot);
+    }
+    for (int i = k; i < n; i++) {
+        heap[i - k] = heap[i];
     }
-    if (wasBack)
-        backIndex = index;
-    return value;
+    heap.resize(n - k);
+    heapify();
+    return result;
 }
 
 template <typename ValueType>
 ValueType PriorityQueue<ValueType>::peek() const {
-    if (count == 0)
+    if (heap.isEmpty())
         error("peek: Attempting to peek at an empty queue");
-    return heap.get(0).value;
+    return values.get(heap.get(0).slot);
 }
 
 template <typename ValueType>
 double PriorityQueue<ValueType>::peekPriority() const {
-    if (count == 0)
+    if (heap.isEmpty())
         error("peekPriority: Attempting to peek at an empty queue");
     return heap.get(0).priority;
 }
 
 template <typename ValueType>
 ValueType& PriorityQueue<ValueType>::front() {
-    if (count == 0)
+    if (heap.isEmpty())
         error("front: Attempting to read front of an empty queue");
-    return heap.get(0).value;
+    return values[heap[0].slot];
 }
 
+/*
+ * Implementation notes: back
+ * --------------------------
+ * The slot of the last entry is kept up to date by enqueue, but an
+ * operation that removes that entry or moves it forward just forgets
+ * it.  In that case back finds it again by scanning the leaves of the
+ * heap, which is the only place the last entry can be.
+ */
+
 template <typename ValueType>
 ValueType& PriorityQueue<ValueType>::back() {
-    if (count == 0)
+    if (heap.isEmpty())
         error("back: Attempting to read back of an empty queue");
-    return heap.get(backIndex).value;
+    if (backSlot == -1) {
+        int n = heap.size();
+        int last = (n + ARITY - 2) / ARITY;
+        for (int i = last + 1; i < n; i++) {
+            if (takesPriority(heap[last], heap[i]))
+                last = i;
+        }
+        backSlot = heap[last].slot;
+    }
+    return values[backSlot];
 }
 
 template <typename ValueType>
-bool PriorityQueue<ValueType>::takesPriority(int i1, int i2) {
-    if (heap[i1].priority < heap[i2].priority)
+bool PriorityQueue<ValueType>::contains(Handle handle) const {
+    if (handle.slot < 0 || handle.slot >= position.size())
+        return false;
+    int index = position[handle.slot];
+    return index != -1 && heap[index].sequence == handle.sequence;
+}
+
+template <typename ValueType>
+void PriorityQueue<ValueType>::changePriority(Handle handle, double priority) {
+    int index = findEntry(handle, "changePriority");
+    double oldPriority = heap[index].priority;
+    heap[index].priority = priority;
+    if (priority < oldPriority) {
+        siftUp(index);
+        if (handle.slot == backSlot)
+            backSlot = -1;
+    } else {
+        siftDown(index);
+        if (backSlot != -1 && takesPriority(heap[position[backSlot]], heap[position[handle.slot]]))
+            backSlot = handle.slot;
+    }
+}
+
+template <typename ValueType>
+void PriorityQueue<ValueType>::decreaseKey(Handle handle, double priority) {
+    int index = findEntry(handle, "decreaseKey");
+    if (priority > heap[index].priority)
+        error("decreaseKey: New priority is greater than the current priority");
+    changePriority(handle, priority);
+}
+
+template <typename ValueType>
+ValueType PriorityQueue<ValueType>::remove(Handle handle) {
+    return removeEntry(findEntry(handle, "remove"));
+}
+
+template <typename ValueType>
+bool PriorityQueue<ValueType>::takesPriority(const HeapEntry& e1, const HeapEntry& e2) {
+    if (e1.priority < e2.priority)
         return true;
-    if (heap[i1].priority > heap[i2].priority)
+    if (e1.priority > e2.priority)
         return false;
-    return (heap[i1].sequence < heap[i2].sequence);
+    return (e1.sequence < e2.sequence);
 }
 
 template <typename ValueType>
-void PriorityQueue<ValueType>::swapHeapEntries(int i1, int i2) {
-    HeapEntry entry = heap[i1];
-    heap[i1] = heap[i2];
-    heap[i2] = entry;
+void PriorityQueue<ValueType>::placeEntry(int index, const HeapEntry& entry) {
+    heap[index] = entry;
+    position[entry.slot] = index;
+}
+
+/*
+ * Implementation notes: siftUp, siftDown
+ * --------------------------------------
+ * Both methods lift the moving entry out of the heap and shift the
+ * entries along its path into the hole, so that each step copies one
+ * entry instead of swapping two.  The entry is stored once at the end.
+ */
+
+template <typename ValueType>
+void PriorityQueue<ValueType>::siftUp(int index) {
+    HeapEntry entry = heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / ARITY;
+        if (!takesPriority(entry, heap[parent]))
+            break;
+        placeEntry(index, heap[parent]);
+        index = parent;
+    }
+    placeEntry(index, entry);
+}
+
+template <typename ValueType>
+void PriorityQueue<ValueType>::siftDown(int index) {
+    HeapEntry entry = heap[index];
+    int n = heap.size();
+    while (true) {
+        int first = ARITY * index + 1;
+        if (first >= n)
+            break;
+        int last = (first + ARITY < n) ? first + ARITY : n;
+        int child = first;
+        for (int i = first + 1; i < last; i++) {
+            if (takesPriority(heap[i], heap[child]))
+                child = i;
+        }
+        if (!takesPriority(heap[child], entry))
+            break;
+        placeEntry(index, heap[child]);
+        index = child;
+    }
+    placeEntry(index, entry);
+}
+
+/*
+ * Implementation notes: addEntry
+ * ------------------------------
+ * This method stores the value in a free slot and appends its entry to
+ * the end of the heap, without restoring the heap order.  It returns the
+ * index of the new entry.
+ */
+
+template <typename ValueType>
+int PriorityQueue<ValueType>::addEntry(ValueType value, double priority) {
+    int slot;
+    if (freeSlots.isEmpty()) {
+        slot = values.size();
+        values.add(std::move(value));
+        position.add(-1);
+    } else {
+        slot = freeSlots[freeSlots.size() - 1];
+        freeSlots.remove(freeSlots.size() - 1);
+        values[slot] = std::move(value);
+    }
+    HeapEntry entry = { priority, enqueueCount++, slot };
+    heap.add(entry);
+    position[slot] = heap.size() - 1;
+    return heap.size() - 1;
+}
+
+/*
+ * Implementation notes: heapify
+ * -----------------------------
+ * This method restores the heap order of the whole array with Floyd's
+ * bottom-up method, sifting down each internal node from the last one to
+ * the root, which takes linear time.  The last entry is found again by
+ * back when it is next needed.
+ */
+
+template <typename ValueType>
+void PriorityQueue<ValueType>::heapify() {
+    int n = heap.size();
+    for (int i = 0; i < n; i++) {
+        position[heap[i].slot] = i;
+    }
+    for (int i = (n - 2) / ARITY; n > 1 && i >= 0; i--) {
+        siftDown(i);
+    }
+    backSlot = -1;
+}
+
+template <typename ValueType>
+int PriorityQueue<ValueType>::findEntry(Handle handle, const std::string& caller) const {
+    if (!contains(handle))
+        error(caller + ": Handle does not refer to an entry in the queue");
+    return position[handle.slot];
+}
+
+/*
+ * Implementation notes: removeEntry
+ * ---------------------------------
+ * The last entry of the heap fills the hole left by the removed entry
+ * and is then sifted in whichever direction restores the heap order.
+ * The removed entry's slot goes on the free list.
+ */
+
+template <typename ValueType>
+ValueType PriorityQueue<ValueType>::removeEntry(int index) {
+    int slot = heap[index].slot;
+    int n = heap.size() - 1;
+    HeapEntry last = heap[n];
+    heap.remove(n);
+    if (index < n) {
+        placeEntry(index, last);
+        if (index > 0 && takesPriority(last, heap[(index - 1) / ARITY])) {
+            siftUp(index);
+        } else {
+            siftDown(index);
+        }
+    }
+    if (slot == backSlot)
+        backSlot = -1;
+    position[slot] = -1;
+    freeSlots.add(slot);
+    return std::move(values[slot]);
 }
 
 template <typename ValueType>
@@ -365,6 +785,7 @@ std::istream& operator>>(std::istream& is, PriorityQueue<ValueType>& pq) {
     if (ch != '{')
         error("operator >>: Missing {");
     pq.clear();
+    Vector<std::pair<double, ValueType>> entries;
     is >> ch;
     if (ch != '}') {
         is.unget();
@@ -375,7 +796,7 @@ std::istream& operator>>(std::istream& is, PriorityQueue<ValueType>& pq) {
                 error("operator >>: Missing colon after priority");
             ValueType value;
             readGenericValue(is, value);
-            pq.enqueue(value, priority);
+            entries.add(std::make_pair(priority, std::move(value)));
             is >> ch;
             if (ch == '}')
                 break;
@@ -384,6 +805,7 @@ std::istream& operator>>(std::istream& is, PriorityQueue<ValueType>& pq) {
             }
         }
     }
+    pq.enqueueAll(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
     return is;
 }
 
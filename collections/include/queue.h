@@ -28,6 +28,8 @@
 #define _queue_h
 
 #include <initializer_list>
+#include <type_traits>
+#include <utility>
 
 #include "vector.h"
 
@@ -83,7 +85,8 @@ public:
      * Method: clear
      * Usage: queue.clear();
      * ---------------------
-     * Removes all elements from the queue.
+     * Removes all elements from the queue.  The queue keeps its storage,
+     * so refilling it to the same size allocates nothing.
      */
 
     void clear();
@@ -97,6 +100,17 @@ public:
 
     void enqueue(ValueType value);
 
+    /*
+     * Method: emplace
+     * Usage: queue.emplace(args...);
+     * ------------------------------
+     * Constructs a new value from the specified arguments, adds it to
+     * the end of the queue, and returns a reference to it.
+     */
+
+    template <typename... Args>
+    ValueType& emplace(Args&&... args);
+
     /*
      * Method: dequeue
      * Usage: ValueType first = queue.dequeue();
@@ -118,6 +132,16 @@ public:
 
     ValueType peek() const;
 
+    /*
+     * Method: reserve
+     * Usage: queue.reserve(n);
+     * ------------------------
+     * Ensures that the queue can hold at least <code>n</code> values
+     * without allocating more storage.
+     */
+
+    void reserve(int n);
+
     /*
      * Method: toString
      * Usage: string str = queue.toString();
@@ -137,10 +161,15 @@ public:
     /*
      * Implementation notes: Queue data structure
      * ------------------------------------------
-     * The Queue class is implemented using a ring buffer.
+     * The Queue class is implemented using a ring buffer whose capacity
+     * is zero or a power of two, so that indices wrap with a mask.
      */
 
 private:
+    /* Constants */
+
+    static const int INITIAL_CAPACITY = 16;
+
     /* Instance variables */
 
     Vector<ValueType> ringBuffer;
@@ -151,7 +180,21 @@ private:
 
     /* Private functions */
 
-    void expandRingBufferCapacity();
+    void expandRingBufferCapacity(int newCapacity);
+
+public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * Copying a queue copies its ring buffer.  Moving a queue transfers
+     * the ring buffer to the destination and leaves the source queue
+     * empty, with no storage.
+     */
+
+    Queue(const Queue& src) = default;
+    Queue& operator=(const Queue& src) = default;
+    Queue(Queue&& src);
+    Queue& operator=(Queue&& src);
 };
 
 extern void error(std::string msg);
@@ -174,23 +217,21 @@ extern void error(std::string msg);
  * to form a circle.  This representation is called a ring buffer.
  */
 
-const int INITIAL_CAPACITY = 10;
-
 /*
  * Implementation notes: Queue constructor
  * ---------------------------------------
- * The constructor must allocate the array storage for the queue
- * elements and initialize the fields of the object.
+ * The constructor initializes the fields of the object.  The ring
+ * buffer is not allocated until the first value is enqueued.
  */
 
 template <typename ValueType>
-Queue<ValueType>::Queue() {
-    clear();
+Queue<ValueType>::Queue() : count(0), capacity(0), head(0), tail(0) {
+    /* Empty */
 }
 
 template <typename ValueType>
-Queue<ValueType>::Queue(std::initializer_list<ValueType> list) {
-    clear();
+Queue<ValueType>::Queue(std::initializer_list<ValueType> list) : Queue() {
+    reserve(int(list.size()));
     for (const ValueType& value : list) {
         enqueue(value);
     }
@@ -208,6 +249,31 @@ Queue<ValueType>::~Queue() {
     /* Empty */
 }
 
+template <typename ValueType>
+Queue<ValueType>::Queue(Queue&& src)
+    : ringBuffer(std::move(src.ringBuffer)),
+      count(src.count),
+      capacity(src.capacity),
+      head(src.head),
+      tail(src.tail) {
+    src.ringBuffer.clear();
+    src.count = src.capacity = src.head = src.tail = 0;
+}
+
+template <typename ValueType>
+Queue<ValueType>& Queue<ValueType>::operator=(Queue&& src) {
+    if (this != &src) {
+        ringBuffer = std::move(src.ringBuffer);
+        count = src.count;
+        capacity = src.capacity;
+        head = src.head;
+        tail = src.tail;
+        src.ringBuffer.clear();
+        src.count = src.capacity = src.head = src.tail = 0;
+    }
+    return *this;
+}
+
 template <typename ValueType>
 int Queue<ValueType>::size() const {
     return count;
@@ -218,10 +284,20 @@ bool Queue<ValueType>::isEmpty() const {
     return count == 0;
 }
 
+/*
+ * Implementation notes: clear
+ * ---------------------------
+ * The ring buffer is kept.  Values that own resources are reset so that
+ * those resources are released now rather than when the slot is reused.
+ */
+
 template <typename ValueType>
 void Queue<ValueType>::clear() {
-    capacity = INITIAL_CAPACITY;
-    ringBuffer = Vector<ValueType>(capacity);
+    if constexpr (!std::is_trivially_destructible<ValueType>::value) {
+        for (int i = 0; i < count; i++) {
+            ringBuffer[(head + i) & (capacity - 1)] = ValueType();
+        }
+    }
     head = 0;
     tail = 0;
     count = 0;
@@ -229,11 +305,24 @@ void Queue<ValueType>::clear() {
 
 template <typename ValueType>
 void Queue<ValueType>::enqueue(ValueType value) {
-    if (count >= capacity - 1)
-        expandRingBufferCapacity();
-    ringBuffer[tail] = value;
-    tail = (tail + 1) % capacity;
+    if (count == capacity)
+        expandRingBufferCapacity((capacity == 0) ? INITIAL_CAPACITY : 2 * capacity);
+    ringBuffer[tail] = std::move(value);
+    tail = (tail + 1) & (capacity - 1);
+    count++;
+}
+
+template <typename ValueType>
+template <typename... Args>
+ValueType& Queue<ValueType>::emplace(Args&&... args) {
+    ValueType value(std::forward<Args>(args)...);
+    if (count == capacity)
+        expandRingBufferCapacity((capacity == 0) ? INITIAL_CAPACITY : 2 * capacity);
+    ValueType& slot = ringBuffer[tail];
+    slot = std::move(value);
+    tail = (tail + 1) & (capacity - 1);
     count++;
+    return slot;
 }
 
 /*
@@ -247,8 +336,8 @@ template <typename ValueType>
 ValueType Queue<ValueType>::dequeue() {
     if (count == 0)
         error("dequeue: Attempting to dequeue an empty queue");
-    ValueType result = ringBuffer[head];
-    head = (head + 1) % capacity;
+    ValueType result = std::move(ringBuffer[head]);
+    head = (head + 1) & (capacity - 1);
     count--;
     return result;
 }
@@ -260,24 +349,49 @@ ValueType Queue<ValueType>::peek() const {
     return ringBuffer.get(head);
 }
 
+template <typename ValueType>
+void Queue<ValueType>::reserve(int n) {
+    if (n > capacity) {
+        int newCapacity = (capacity == 0) ? INITIAL_CAPACITY : 2 * capacity;
+        while (newCapacity < n) {
+            newCapacity *= 2;
+        }
+        expandRingBufferCapacity(newCapacity);
+    }
+}
+
 /*
  * Implementation notes: expandRingBufferCapacity
  * ----------------------------------------------
- * This private method doubles the capacity of the ringBuffer vector.
- * Note that this implementation also shifts all the elements back to
- * the beginning of the vector.
+ * This private method grows the ringBuffer vector in place to the new
+ * capacity, which is a power of two and at least twice the old one.
+ * Growing the vector relocates its elements in index order, with a
+ * single memcpy for trivially copyable types.  If the live elements
+ * wrapped around the end of the old buffer, they now form two segments
+ * with a gap between them, and the shorter segment is moved across the
+ * gap: either the segment at the start of the buffer moves up to follow
+ * the old end, or the segment at the old end moves up to the new end.
  */
 
 template <typename ValueType>
-void Queue<ValueType>::expandRingBufferCapacity() {
-    Vector<ValueType> copy = ringBuffer;
-    ringBuffer = Vector<ValueType>(2 * capacity);
-    for (int i = 0; i < count; i++) {
-        ringBuffer[i] = copy[(head + i) % capacity];
+void Queue<ValueType>::expandRingBufferCapacity(int newCapacity) {
+    int oldCapacity = capacity;
+    ringBuffer.resize(newCapacity);
+    capacity = newCapacity;
+    if (head + count <= oldCapacity) {
+        tail = (head + count) & (capacity - 1);
+        return;
+    }
+    ValueType* array = &ringBuffer[0];
+    int front = oldCapacity - head;
+    int back = count - front;
+    if (back <= front) {
+        std::move(array, array + back, array + oldCapacity);
+        tail = oldCapacity + back;
+    } else {
+        std::move(array + head, array + oldCapacity, array + newCapacity - front);
+        head = newCapacity - front;
     }
-    head = 0;
-    tail = count;
-    capacity *= 2;
 }
 
 template <typename ValueType>
@@ -0,0 +1,433 @@
+/*
+ * File: radixpqueue.h
+ * -------------------
+ * This file exports the <code>RadixPriorityQueue</code> class, a
+ * priority queue for nonnegative integer priorities that are processed
+ * in nondecreasing order.
+ */
+
+#ifndef _radixpqueue_h
+#define _radixpqueue_h
+
+#include <climits>
+#include <initializer_list>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#include "vector.h"
+
+/*
+ * Class: RadixPriorityQueue<ValueType>
+ * ------------------------------------
+ * This class exports the same <code>enqueue</code>, <code>dequeue</code>,
+ * <code>peek</code>, and <code>peekPriority</code> operations as
+ * <code>PriorityQueue</code>, for the common case in which priorities
+ * are nonnegative integers and no value is ever enqueued with a priority
+ * lower than that of the last value dequeued.  Searches such as
+ * Dijkstra's algorithm with integer edge costs have this property.  In
+ * return, every operation takes amortized constant time.  As in
+ * <code>PriorityQueue</code>, lower numbers are dequeued first, and values
+ * of equal priority are dequeued in the order in which they were enqueued.
+ */
+
+template <typename ValueType>
+class RadixPriorityQueue {
+public:
+    /*
+     * Constructor: RadixPriorityQueue
+     * Usage: RadixPriorityQueue<ValueType> pq;
+     * ----------------------------------------
+     * Initializes a new priority queue, which is initially empty.
+     */
+
+    RadixPriorityQueue();
+    RadixPriorityQueue(std::initializer_list<std::pair<long, ValueType>> list);
+
+    /*
+     * Destructor: ~RadixPriorityQueue
+     * -------------------------------
+     * Frees any heap storage associated with this priority queue.
+     */
+
+    virtual ~RadixPriorityQueue();
+
+    /*
+     * Method: size
+     * Usage: int n = pq.size();
+     * -------------------------
+     * Returns the number of values in the priority queue.
+     */
+
+    int size() const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (pq.isEmpty()) ...
+     * ----------------------------
+     * Returns <code>true</code> if the priority queue contains no elements.
+     */
+
+    bool isEmpty() const;
+
+    /*
+     * Method: clear
+     * Usage: pq.clear();
+     * ------------------
+     * Removes all elements from the priority queue.  Afterwards, any
+     * nonnegative priority may be enqueued again.
+     */
+
+    void clear();
+
+    /*
+     * Method: enqueue
+     * Usage: pq.enqueue(value, priority);
+     * -----------------------------------
+     * Adds <code>value</code> to the queue with the specified priority.
+     * It is an error for the priority to be negative or lower than the
+     * priority of the last value dequeued.
+     */
+
+    void enqueue(ValueType value, long priority);
+
+    /*
+     * Method: dequeue
+     * Usage: ValueType first = pq.dequeue();
+     * --------------------------------------
+     * Removes and returns the value with the lowest priority number.
+     */
+
+    ValueType dequeue();
+
+    /*
+     * Method: peek
+     * Usage: ValueType first = pq.peek();
+     * -----------------------------------
+     * Returns the value that <code>dequeue</code> would return, without
+     * removing it.
+     */
+
+    ValueType peek() const;
+
+    /*
+     * Method: peekPriority
+     * Usage: long priority = pq.peekPriority();
+     * -----------------------------------------
+     * Returns the priority of the first element in the queue, without
+     * removing it.
+     */
+
+    long peekPriority() const;
+
+    /*
+     * Method: toString
+     * Usage: string str = pq.toString();
+     * ----------------------------------
+     * Converts the queue to a printable string representation.
+     */
+
+    std::string toString();
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: RadixPriorityQueue data structure
+     * -------------------------------------------------------
+     * The queue is a radix heap.  Entries are kept in buckets according
+     * to the highest bit in which their priority differs from last, the
+     * priority of the last value dequeued: bucket 0 holds the entries whose
+     * priority equals last, and bucket i holds those whose priorities
+     * first differ from last in bit i - 1.  Because no priority may fall
+     * below last, the buckets are in increasing order of priority.
+     *
+     * When bucket 0 runs out, dequeue takes the lowest nonempty bucket,
+     * makes its smallest priority the new value of last, and redistributes
+     * its entries.  Each of them lands in a strictly lower bucket, so an
+     * entry moves at most once per bit of the priority type.  The entries
+     * of a bucket are moved in order, so values of equal priority stay in
+     * the order in which they were enqueued.
+     */
+
+private:
+    /* Type used for each entry */
+
+    struct Entry {
+        long priority;
+        ValueType value;
+    };
+
+    /* Type used for each bucket */
+
+    struct Bucket {
+        Vector<Entry> entries; /* Entries in the order they arrived      */
+        int minIndex;          /* Index of the first lowest-priority one */
+    };
+
+    /* Constants */
+
+    static const int BUCKET_COUNT = int(sizeof(long) * CHAR_BIT);
+
+    /* Instance variables */
+
+    Bucket buckets[BUCKET_COUNT];
+    int head;  /* Index of the next entry in bucket 0   */
+    long last; /* Priority of the last value dequeued   */
+    int count; /* Number of values in the queue         */
+
+    /* Private function prototypes */
+
+    int bucketIndex(long priority) const;
+    void addEntry(Entry& entry);
+    int firstBucket() const;
+    const Entry& firstEntry() const;
+
+public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * Copying a priority queue copies its buckets.  Moving one transfers
+     * the buckets to the destination and leaves the source queue empty.
+     */
+
+    RadixPriorityQueue(const RadixPriorityQueue& src) = default;
+    RadixPriorityQueue& operator=(const RadixPriorityQueue& src) = default;
+    RadixPriorityQueue(RadixPriorityQueue&& src);
+    RadixPriorityQueue& operator=(RadixPriorityQueue&& src);
+};
+
+extern void error(std::string msg);
+
+template <typename ValueType>
+RadixPriorityQueue<ValueType>::RadixPriorityQueue() {
+    clear();
+}
+
+template <typename ValueType>
+RadixPriorityQueue<ValueType>::RadixPriorityQueue(std::initializer_list<std::pair<long, ValueType>> list) {
+    clear();
+    for (const std::pair<long, ValueType>& pair : list) {
+        enqueue(pair.second, pair.first);
+    }
+}
+
+template <typename ValueType>
+RadixPriorityQueue<ValueType>::~RadixPriorityQueue() {
+    /* Empty */
+}
+
+template <typename ValueType>
+RadixPriorityQueue<ValueType>::RadixPriorityQueue(RadixPriorityQueue&& src)
+    : head(src.head), last(src.last), count(src.count) {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i].entries = std::move(src.buckets[i].entries);
+        buckets[i].minIndex = src.buckets[i].minIndex;
+    }
+    src.clear();
+}
+
+template <typename ValueType>
+RadixPriorityQueue<ValueType>& RadixPriorityQueue<ValueType>::operator=(RadixPriorityQueue&& src) {
+    if (this != &src) {
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            buckets[i].entries = std::move(src.buckets[i].entries);
+            buckets[i].minIndex = src.buckets[i].minIndex;
+        }
+        head = src.head;
+        last = src.last;
+        count = src.count;
+        src.clear();
+    }
+    return *this;
+}
+
+template <typename ValueType>
+int RadixPriorityQueue<ValueType>::size() const {
+    return count;
+}
+
+template <typename ValueType>
+bool RadixPriorityQueue<ValueType>::isEmpty() const {
+    return count == 0;
+}
+
+template <typename ValueType>
+void RadixPriorityQueue<ValueType>::clear() {
+    for (Bucket& bucket : buckets) {
+        bucket.entries.clear();
+        bucket.minIndex = 0;
+    }
+    head = 0;
+    last = 0;
+    count = 0;
+}
+
+template <typename ValueType>
+void RadixPriorityQueue<ValueType>::enqueue(ValueType value, long priority) {
+    if (priority < 0)
+        error("enqueue: Priority cannot be negative");
+    if (priority < last)
+        error("enqueue: Priority is lower than that of the last value dequeued");
+    Entry entry = { priority, std::move(value) };
+    addEntry(entry);
+    count++;
+}
+
+/*
+ * Implementation notes: dequeue
+ * -----------------------------
+ * Bucket 0 is consumed from the front by advancing head, and is cleared
+ * once it is used up, so no entry is ever shifted within a bucket.
+ */
+
+template <typename ValueType>
+ValueType RadixPriorityQueue<ValueType>::dequeue() {
+    if (count == 0)
+        error("dequeue: Attempting to dequeue an empty queue");
+    Bucket& front = buckets[0];
+    if (head == front.entries.size()) {
+        front.entries.clear();
+        head = 0;
+        Bucket& bucket = buckets[firstBucket()];
+        last = bucket.entries[bucket.minIndex].priority;
+        for (Entry& entry : bucket.entries) {
+            addEntry(entry);
+        }
+        bucket.entries.clear();
+    }
+    ValueType value = std::move(front.entries[head++].value);
+    if (head == front.entries.size()) {
+        front.entries.clear();
+        head = 0;
+    }
+    count--;
+    return value;
+}
+
+/*
+ * Implementation notes: peek, peekPriority
+ * ----------------------------------------
+ * These methods must check for an empty queue and report an error if
+ * there is no first element.  They do not redistribute any entries, so
+ * that peeking never raises the lowest priority that may be enqueued.
+ */
+
+template <typename ValueType>
+ValueType RadixPriorityQueue<ValueType>::peek() const {
+    if (count == 0)
+        error("peek: Attempting to peek at an empty queue");
+    return firstEntry().value;
+}
+
+template <typename ValueType>
+long RadixPriorityQueue<ValueType>::peekPriority() const {
+    if (count == 0)
+        error("peekPriority: Attempting to peek at an empty queue");
+    return firstEntry().priority;
+}
+
+template <typename ValueType>
+std::string RadixPriorityQueue<ValueType>::toString() {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+/*
+ * Implementation notes: bucketIndex
+ * ---------------------------------
+ * The bucket index is the number of significant bits in the exclusive
+ * or of the priority and last, which GCC and Clang compute with a single
+ * count-leading-zeros instruction.
+ */
+
+template <typename ValueType>
+int RadixPriorityQueue<ValueType>::bucketIndex(long priority) const {
+    unsigned long diff = (unsigned long) (priority ^ last);
+#ifdef __GNUC__
+    return (diff == 0) ? 0 : BUCKET_COUNT - __builtin_clzl(diff);
+#else
+    int index = 0;
+    while (diff != 0) {
+        diff >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+template <typename ValueType>
+void RadixPriorityQueue<ValueType>::addEntry(Entry& entry) {
+    Bucket& bucket = buckets[bucketIndex(entry.priority)];
+    int n = bucket.entries.size();
+    if (n == 0 || entry.priority < bucket.entries[bucket.minIndex].priority)
+        bucket.minIndex = n;
+    bucket.entries.add(std::move(entry));
+}
+
+template <typename ValueType>
+int RadixPriorityQueue<ValueType>::firstBucket() const {
+    int index = 1;
+    while (buckets[index].entries.isEmpty()) {
+        index++;
+    }
+    return index;
+}
+
+template <typename ValueType>
+const typename RadixPriorityQueue<ValueType>::Entry& RadixPriorityQueue<ValueType>::firstEntry() const {
+    if (head < buckets[0].entries.size())
+        return buckets[0].entries[head];
+    const Bucket& bucket = buckets[firstBucket()];
+    return bucket.entries[bucket.minIndex];
+}
+
+template <typename ValueType>
+std::ostream& operator<<(std::ostream& os, const RadixPriorityQueue<ValueType>& pq) {
+    os << "{";
+    RadixPriorityQueue<ValueType> copy = pq;
+    int len = pq.size();
+    for (int i = 0; i < len; i++) {
+        if (i > 0)
+            os << ", ";
+        os << copy.peekPriority() << ":";
+        writeGenericValue(os, copy.dequeue(), true);
+    }
+    return os << "}";
+}
+
+template <typename ValueType>
+std::istream& operator>>(std::istream& is, RadixPriorityQueue<ValueType>& pq) {
+    char ch;
+    is >> ch;
+    if (ch != '{')
+        error("operator >>: Missing {");
+    pq.clear();
+    is >> ch;
+    if (ch != '}') {
+        is.unget();
+        while (true) {
+            long priority;
+            is >> priority >> ch;
+            if (ch != ':')
+                error("operator >>: Missing colon after priority");
+            ValueType value;
+            readGenericValue(is, value);
+            pq.enqueue(value, priority);
+            is >> ch;
+            if (ch == '}')
+                break;
+            if (ch != ',') {
+                error(std::string("operator >>: Unexpected character ") + ch);
+            }
+        }
+    }
+    return is;
+}
+
+#endif  // _radixpqueue_h
@@ -26,13 +26,24 @@
 #ifndef _set_h
 #define _set_h
 
+#include <algorithm>
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
 
 #include "compare.h"
 #include "map.h"
 #include "vector.h"
 
+/*
+ * Type: SetMarker
+ * ---------------
+ * The value type of the map that implements Set.  Because it is an
+ * empty class, the nodes of that map store nothing but the element.
+ */
+
+struct SetMarker {};
+
 /*
  * Class: Set<ValueType>
  * ---------------------
@@ -52,6 +63,20 @@ public:
     Set();
     Set(std::initializer_list<ValueType> list);
 
+    /*
+     * Constructor: Set
+     * Usage: Set<ValueType> set(first, last);
+     * ---------------------------------------
+     * Creates a set containing the values in the range between two
+     * iterators.  The values are sorted if necessary, and the set is then
+     * built in a single pass, which takes linear time when the values are
+     * already in ascending order.
+     */
+
+    template <typename IteratorType,
+              typename = typename std::iterator_traits<IteratorType>::iterator_category>
+    Set(IteratorType first, IteratorType last);
+
     /*
      * Destructor: ~Set
      * ----------------
@@ -100,6 +125,8 @@ public:
      */
 
     void remove(const ValueType& value);
+    template <typename K>
+    EnableIfTransparent<ValueType, K, void> remove(const K& value);
 
     /*
      * Method: contains
@@ -109,6 +136,40 @@ public:
      */
 
     bool contains(const ValueType& value) const;
+    template <typename K>
+    EnableIfTransparent<ValueType, K, bool> contains(const K& value) const;
+
+    /*
+     * Type: Set<ValueType>::NodeHandle
+     * --------------------------------
+     * A node handle owns one element that has been taken out of a set
+     * with <code>extract</code>.  The element is available through the
+     * handle's <code>key</code> method, and <code>insert</code> puts it
+     * into this or another set of the same type without allocating.
+     */
+
+    typedef typename Map<ValueType, SetMarker>::NodeHandle NodeHandle;
+
+    /*
+     * Method: extract
+     * Usage: Set<ValueType>::NodeHandle node = set.extract(value);
+     * ------------------------------------------------------------
+     * Removes <code>value</code> from this set and returns it in a node
+     * handle, which is empty if the value was not in the set.
+     */
+
+    NodeHandle extract(const ValueType& value);
+
+    /*
+     * Method: insert
+     * Usage: if (set.insert(std::move(node))) ...
+     * -------------------------------------------
+     * Adds the element held by <code>node</code> to this set, unless it is
+     * already present.  The method returns <code>true</code> and leaves
+     * the handle empty if it adds the element.
+     */
+
+    bool insert(NodeHandle&& node);
 
     /*
      * Method: isSubsetOf
@@ -265,6 +326,25 @@ public:
 
     ValueType first() const;
 
+    /*
+     * Methods: lowerBound, upperBound, floor, ceiling
+     * Usage: for (auto it = set.lowerBound(lo); it != set.upperBound(hi); ++it) ...
+     * -----------------------------------------------------------------------------
+     * Return iterators positioned at the first value not less than
+     * <code>value</code> (<code>lowerBound</code> and <code>ceiling</code>),
+     * the first value greater than <code>value</code>
+     * (<code>upperBound</code>), or the last value not greater than
+     * <code>value</code> (<code>floor</code>).  If there is no such value,
+     * the result is <code>end()</code>.
+     */
+
+    class iterator;
+
+    iterator lowerBound(const ValueType& value) const;
+    iterator upperBound(const ValueType& value) const;
+    iterator floor(const ValueType& value) const;
+    iterator ceiling(const ValueType& value) const;
+
     /*
      * Method: toString
      * Usage: string str = set.toString();
@@ -297,7 +377,10 @@ public:
      *
      *   - Stream I/O using the << and >> operators
      *   - Deep copying for the copy constructor and assignment operator
-     *   - Iteration using the range-based for statement and STL iterators
+     *   - Iteration using the range-based for statement and STL iterators,
+     *     in either direction using rbegin and rend
+     *   - Lookup by std::string_view or C string in a set of strings,
+     *     using contains and remove, without building a temporary string
      *
      * The iteration forms process the Set in ascending order.
      */
@@ -310,8 +393,24 @@ public:
     /**********************************************************************/
 
 private:
-    Map<ValueType, bool> map; /* Map used to store the element     */
-    bool removeFlag;          /* Flag to differentiate += and -=   */
+    Map<ValueType, SetMarker> map; /* Map used to store the element   */
+    bool removeFlag;               /* Flag to differentiate += and -= */
+
+    /*
+     * Lookups in the larger set are used instead of a merge when one set
+     * is smaller than the other by at least this factor.
+     */
+
+    static const int LOOKUP_RATIO = 16;
+
+    Set buildFrom(const Vector<const ValueType*>& keys) const;
+    bool findMatch(const ValueType& value, const ValueType*& match) const;
+    bool sharesOrder(const Set& set2) const;
+
+    /* FlatSet freezes a set by reading its map directly */
+
+    template <typename V>
+    friend class FlatSet;
 
 public:
     /*
@@ -326,10 +425,35 @@ public:
     /* Extended constructors */
 
     template <typename CompareType>
-    explicit Set(CompareType cmp) : map(Map<ValueType, bool>(cmp)) {
+    explicit Set(CompareType cmp) : map(Map<ValueType, SetMarker>(cmp)), removeFlag(false) {
         /* Empty */
     }
 
+    /*
+     * Bulk construction support
+     * -------------------------
+     * Replaces the contents of this set with the n values starting at
+     * values, which must be in strictly increasing order under the
+     * comparator of this set.  As in the range constructor, the tree is
+     * built in linear time, but the set keeps its own comparator.
+     */
+
+    void assignSorted(const ValueType* values, int n) {
+        map.buildSorted(map, n, [values](int i) -> const ValueType& { return values[i]; });
+    }
+
+    /*
+     * Copying and moving support
+     * --------------------------
+     * A set copies or moves its underlying map.  Moving a set leaves
+     * the source set empty.
+     */
+
+    Set(const Set& src) = default;
+    Set(Set&& src) = default;
+    Set& operator=(const Set& src) = default;
+    Set& operator=(Set&& src) = default;
+
     Set& operator,(const ValueType& value) {
         if (this->removeFlag) {
             this->remove(value);
@@ -342,31 +466,26 @@ public:
     /*
      * Iterator support
      * ----------------
-     * The classes in the StanfordCPPLib collection implement input
-     * iterators so that they work symmetrically with respect to the
-     * corresponding STL classes.
+     * The set iterator is a thin wrapper around the bidirectional
+     * iterator of the underlying map.
      */
 
     class iterator {
     public:
-        using iterator_category = std::input_iterator_tag;
+        using iterator_category = std::bidirectional_iterator_tag;
         using value_type = ValueType;
         using difference_type = std::ptrdiff_t;
-        using pointer = ValueType*;
-        using reference = ValueType&;
+        using pointer = const ValueType*;
+        using reference = const ValueType&;
 
         iterator() {
             /* Empty */
         }
 
-        iterator(typename Map<ValueType, bool>::iterator it) : mapit(it) {
+        iterator(typename Map<ValueType, SetMarker>::iterator it) : mapit(it) {
             /* Empty */
         }
 
-        iterator(const iterator& it) {
-            mapit = it.mapit;
-        }
-
         iterator& operator++() {
             ++mapit;
             return *this;
@@ -378,26 +497,39 @@ public:
             return copy;
         }
 
-        bool operator==(const iterator& rhs) {
+        iterator& operator--() {
+            --mapit;
+            return *this;
+        }
+
+        iterator operator--(int) {
+            iterator copy(*this);
+            operator--();
+            return copy;
+        }
+
+        bool operator==(const iterator& rhs) const {
             return mapit == rhs.mapit;
         }
 
-        bool operator!=(const iterator& rhs) {
+        bool operator!=(const iterator& rhs) const {
             return !(*this == rhs);
         }
 
-        ValueType operator*() {
+        const ValueType& operator*() const {
             return *mapit;
         }
 
-        ValueType* operator->() {
-            return mapit;
+        const ValueType* operator->() const {
+            return &*mapit;
         }
 
     private:
-        typename Map<ValueType, bool>::iterator mapit; /* Iterator for the map */
+        typename Map<ValueType, SetMarker>::iterator mapit; /* Iterator for the map */
     };
 
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+
     iterator begin() const {
         return iterator(map.begin());
     }
@@ -405,20 +537,55 @@ public:
     iterator end() const {
         return iterator(map.end());
     }
+
+    reverse_iterator rbegin() const {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() const {
+        return reverse_iterator(begin());
+    }
 };
 
 extern void error(std::string msg);
 
 template <typename ValueType>
-Set<ValueType>::Set() {
+Set<ValueType>::Set() : removeFlag(false) {
     /* Empty */
 }
 
 template <typename ValueType>
-Set<ValueType>::Set(std::initializer_list<ValueType> list) {
-    for (const ValueType& value : list) {
-        this->add(value);
+Set<ValueType>::Set(std::initializer_list<ValueType> list) : Set(list.begin(), list.end()) {
+    /* Empty */
+}
+
+/*
+ * Implementation notes: Set(first, last)
+ * --------------------------------------
+ * The values are copied into a vector, which is sorted only if it is out
+ * of order.  Duplicates are then skipped while collecting the keys for
+ * buildSorted.
+ */
+
+template <typename ValueType>
+template <typename IteratorType, typename>
+Set<ValueType>::Set(IteratorType first, IteratorType last) : removeFlag(false) {
+    Vector<ValueType> values;
+    for (; first != last; ++first) {
+        values.add(*first);
+    }
+    auto lessThan = [this](const ValueType& v1, const ValueType& v2) {
+        return map.compareKeys(v1, v2) < 0;
+    };
+    if (!std::is_sorted(values.begin(), values.end(), lessThan))
+        std::sort(values.begin(), values.end(), lessThan);
+    Vector<const ValueType*> keys;
+    keys.reserve(values.size());
+    for (const ValueType& value : values) {
+        if (keys.isEmpty() || lessThan(*keys[keys.size() - 1], value))
+            keys.add(&value);
     }
+    map.buildSorted(map, keys.size(), [&keys](int i) -> const ValueType& { return *keys[i]; });
 }
 
 template <typename ValueType>
@@ -438,12 +605,12 @@ bool Set<ValueType>::isEmpty() const {
 
 template <typename ValueType>
 void Set<ValueType>::add(const ValueType& value) {
-    map.put(value, true);
+    map.put(value, SetMarker());
 }
 
 template <typename ValueType>
 void Set<ValueType>::insert(const ValueType& value) {
-    map.put(value, true);
+    map.put(value, SetMarker());
 }
 
 template <typename ValueType>
@@ -451,35 +618,127 @@ void Set<ValueType>::remove(const ValueType& value) {
     map.remove(value);
 }
 
+template <typename ValueType>
+template <typename K>
+EnableIfTransparent<ValueType, K, void> Set<ValueType>::remove(const K& value) {
+    map.remove(value);
+}
+
 template <typename ValueType>
 bool Set<ValueType>::contains(const ValueType& value) const {
     return map.containsKey(value);
 }
 
+template <typename ValueType>
+template <typename K>
+EnableIfTransparent<ValueType, K, bool> Set<ValueType>::contains(const K& value) const {
+    return map.containsKey(value);
+}
+
+template <typename ValueType>
+typename Set<ValueType>::NodeHandle Set<ValueType>::extract(const ValueType& value) {
+    return map.extract(value);
+}
+
+template <typename ValueType>
+bool Set<ValueType>::insert(NodeHandle&& node) {
+    return map.insert(std::move(node));
+}
+
 template <typename ValueType>
 void Set<ValueType>::clear() {
     map.clear();
 }
 
+/*
+ * Implementation notes: set operators
+ * -----------------------------------
+ * When both sets keep their elements in the same sorted order, union,
+ * intersection, difference, and the subset test walk the two sets in
+ * step, as in the merge phase of mergesort.  The walk collects pointers
+ * to the elements of the result, which buildFrom then copies into a
+ * balanced tree in a single pass.  Each operation therefore takes
+ * O(n + m) time and allocates one node per element of the result.  If
+ * one set is smaller than the other by at least LOOKUP_RATIO, looking up
+ * each of its m elements in the larger set costs O(m log n), which is
+ * less, so intersection and the subset test use lookups in that case.
+ * Two sets created with different comparators may keep their elements
+ * in different orders, so the merges are used only after sharesOrder has
+ * checked that the elements of set2 are in the order of this set; if
+ * not, the operators look up each element instead.  The compound
+ * assignment operators build the result the same way and move it into
+ * place, except when the right operand is small enough that updating the
+ * tree one element at a time is cheaper.
+ */
+
 template <typename ValueType>
-bool Set<ValueType>::isSubsetOf(const Set& set2) const {
-    iterator it = begin();
-    iterator end = this->end();
-    while (it != end) {
-        if (!set2.map.containsKey(*it))
-            return false;
-        ++it;
-    }
+Set<ValueType> Set<ValueType>::buildFrom(const Vector<const ValueType*>& keys) const {
+    Set<ValueType> set;
+    set.map.buildSorted(map, keys.size(), [&keys](int i) -> const ValueType& { return *keys[i]; });
+    return set;
+}
+
+/*
+ * Implementation notes: findMatch(value, match)
+ * ---------------------------------------------
+ * Looks up a value from another set and, if this set contains an equal
+ * element, stores a pointer to that element in match.  The result of an
+ * operation always takes its elements from the left operand.
+ */
+
+template <typename ValueType>
+bool Set<ValueType>::findMatch(const ValueType& value, const ValueType*& match) const {
+    iterator it = lowerBound(value);
+    if (it == end() || map.compareKeys(value, *it) != 0)
+        return false;
+    match = &*it;
     return true;
 }
 
 /*
- * Implementation notes: set operators
- * -----------------------------------
- * The implementations for the set operators use iteration to walk
- * over the elements in one or both sets.
+ * Implementation notes: sharesOrder(set2)
+ * ---------------------------------------
+ * Returns true if the elements of set2 are in strictly ascending order
+ * under the comparator of this set, which is always the case when the
+ * two sets share a comparator.  The check takes O(m) time, which the
+ * merges and the lookups over set2 spend anyway.
  */
 
+template <typename ValueType>
+bool Set<ValueType>::sharesOrder(const Set& set2) const {
+    const ValueType* previous = nullptr;
+    for (const ValueType& value : set2) {
+        if (previous != nullptr && map.compareKeys(*previous, value) >= 0)
+            return false;
+        previous = &value;
+    }
+    return true;
+}
+
+template <typename ValueType>
+bool Set<ValueType>::isSubsetOf(const Set& set2) const {
+    if (size() > set2.size())
+        return false;
+    if (size() < set2.size() / LOOKUP_RATIO || !sharesOrder(set2)) {
+        for (const ValueType& value : *this) {
+            if (!set2.map.containsKey(value))
+                return false;
+        }
+        return true;
+    }
+    iterator it2 = set2.begin();
+    iterator end2 = set2.end();
+    for (const ValueType& value : *this) {
+        while (it2 != end2 && map.compareKeys(*it2, value) < 0) {
+            ++it2;
+        }
+        if (it2 == end2 || map.compareKeys(*it2, value) != 0)
+            return false;
+        ++it2;
+    }
+    return true;
+}
+
 template <typename ValueType>
 bool Set<ValueType>::operator==(const Set& set2) const {
     if (size() != set2.map.size())
@@ -523,11 +782,38 @@ bool Set<ValueType>::operator>=(const Set& set2) const {
 
 template <typename ValueType>
 Set<ValueType> Set<ValueType>::operator+(const Set& set2) const {
-    Set<ValueType> set = *this;
-    for (const ValueType& value : set2) {
-        set.add(value);
+    if (!sharesOrder(set2)) {
+        Set<ValueType> set = *this;
+        for (const ValueType& value : set2) {
+            set.add(value);
+        }
+        return set;
     }
-    return set;
+    Vector<const ValueType*> keys;
+    keys.reserve(size() + set2.size());
+    iterator it1 = begin();
+    iterator end1 = end();
+    iterator it2 = set2.begin();
+    iterator end2 = set2.end();
+    while (it1 != end1 && it2 != end2) {
+        int sign = map.compareKeys(*it1, *it2);
+        if (sign <= 0) {
+            keys.add(&*it1);
+            ++it1;
+            if (sign == 0)
+                ++it2;
+        } else {
+            keys.add(&*it2);
+            ++it2;
+        }
+    }
+    for (; it1 != end1; ++it1) {
+        keys.add(&*it1);
+    }
+    for (; it2 != end2; ++it2) {
+        keys.add(&*it2);
+    }
+    return buildFrom(keys);
 }
 
 template <typename ValueType>
@@ -539,22 +825,60 @@ Set<ValueType> Set<ValueType>::operator+(const ValueType& element) const {
 
 template <typename ValueType>
 Set<ValueType> Set<ValueType>::operator*(const Set& set2) const {
-    Set<ValueType> set = *this;
-    set.clear();
-    for (const ValueType& value : *this) {
-        if (set2.contains(value))
-            set.add(value);
+    Vector<const ValueType*> keys;
+    if (size() < set2.size() / LOOKUP_RATIO || !sharesOrder(set2)) {
+        for (const ValueType& value : *this) {
+            if (set2.map.containsKey(value))
+                keys.add(&value);
+        }
+    } else if (set2.size() < size() / LOOKUP_RATIO) {
+        const ValueType* match;
+        for (const ValueType& value : set2) {
+            if (findMatch(value, match))
+                keys.add(match);
+        }
+    } else {
+        iterator it1 = begin();
+        iterator end1 = end();
+        iterator it2 = set2.begin();
+        iterator end2 = set2.end();
+        while (it1 != end1 && it2 != end2) {
+            int sign = map.compareKeys(*it1, *it2);
+            if (sign < 0) {
+                ++it1;
+            } else if (sign > 0) {
+                ++it2;
+            } else {
+                keys.add(&*it1);
+                ++it1;
+                ++it2;
+            }
+        }
     }
-    return set;
+    return buildFrom(keys);
 }
 
 template <typename ValueType>
 Set<ValueType> Set<ValueType>::operator-(const Set& set2) const {
-    Set<ValueType> set = *this;
-    for (const ValueType& value : set2) {
-        set.remove(value);
+    Vector<const ValueType*> keys;
+    keys.reserve(size());
+    if (!sharesOrder(set2)) {
+        for (const ValueType& value : *this) {
+            if (!set2.map.containsKey(value))
+                keys.add(&value);
+        }
+        return buildFrom(keys);
     }
-    return set;
+    iterator it2 = set2.begin();
+    iterator end2 = set2.end();
+    for (const ValueType& value : *this) {
+        while (it2 != end2 && map.compareKeys(*it2, value) < 0) {
+            ++it2;
+        }
+        if (it2 == end2 || map.compareKeys(*it2, value) != 0)
+            keys.add(&value);
+    }
+    return buildFrom(keys);
 }
 
 template <typename ValueType>
@@ -566,8 +890,12 @@ Set<ValueType> Set<ValueType>::operator-(const ValueType& element) const {
 
 template <typename ValueType>
 Set<ValueType>& Set<ValueType>::operator+=(const Set& set2) {
-    for (const ValueType& value : set2) {
-        this->add(value);
+    if (set2.size() < size() / LOOKUP_RATIO) {
+        for (const ValueType& value : set2) {
+            this->add(value);
+        }
+    } else if (this != &set2) {
+        map = std::move((*this + set2).map);
     }
     return *this;
 }
@@ -581,26 +909,21 @@ Set<ValueType>& Set<ValueType>::operator+=(const ValueType& value) {
 
 template <typename ValueType>
 Set<ValueType>& Set<ValueType>::operator*=(const Set& set2) {
-    Vector<ValueType> toRemove;
-    for (const ValueType& value : *this) {
-        if (!set2.map.containsKey(value))
-            toRemove.add(value);
-    }
-    for (const ValueType& value : toRemove) {
-        this->remove(value);
-    }
+    if (this != &set2)
+        map = std::move((*this * set2).map);
     return *this;
 }
 
 template <typename ValueType>
 Set<ValueType>& Set<ValueType>::operator-=(const Set& set2) {
-    Vector<ValueType> toRemove;
-    for (const ValueType& value : *this) {
-        if (set2.map.containsKey(value))
-            toRemove.add(value);
-    }
-    for (const ValueType& value : toRemove) {
-        this->remove(value);
+    if (this == &set2) {
+        clear();
+    } else if (set2.size() < size() / LOOKUP_RATIO) {
+        for (const ValueType& value : set2) {
+            this->remove(value);
+        }
+    } else {
+        map = std::move((*this - set2).map);
     }
     return *this;
 }
@@ -619,6 +942,26 @@ ValueType Set<ValueType>::first() const {
     return *begin();
 }
 
+template <typename ValueType>
+typename Set<ValueType>::iterator Set<ValueType>::lowerBound(const ValueType& value) const {
+    return iterator(map.lowerBound(value));
+}
+
+template <typename ValueType>
+typename Set<ValueType>::iterator Set<ValueType>::upperBound(const ValueType& value) const {
+    return iterator(map.upperBound(value));
+}
+
+template <typename ValueType>
+typename Set<ValueType>::iterator Set<ValueType>::floor(const ValueType& value) const {
+    return iterator(map.floor(value));
+}
+
+template <typename ValueType>
+typename Set<ValueType>::iterator Set<ValueType>::ceiling(const ValueType& value) const {
+    return iterator(map.ceiling(value));
+}
+
 template <typename ValueType>
 std::string Set<ValueType>::toString() {
     std::ostringstream os;
@@ -628,18 +971,24 @@ std::string Set<ValueType>::toString() {
 
 template <typename ValueType>
 void Set<ValueType>::mapAll(void (*fn)(ValueType)) const {
-    map.mapAll(fn);
+    for (const ValueType& value : *this) {
+        fn(value);
+    }
 }
 
 template <typename ValueType>
 void Set<ValueType>::mapAll(void (*fn)(const ValueType&)) const {
-    map.mapAll(fn);
+    for (const ValueType& value : *this) {
+        fn(value);
+    }
 }
 
 template <typename ValueType>
 template <typename FunctorType>
 void Set<ValueType>::mapAll(FunctorType fn) const {
-    map.mapAll(fn);
+    for (const ValueType& value : *this) {
+        fn(value);
+    }
 }
 
 template <typename ValueType>
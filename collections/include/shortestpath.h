@@ -0,0 +1,566 @@
+/*
+ * File: shortestpath.h
+ * --------------------
+ * This file exports the <code>ShortestPaths</code> class, which finds
+ * shortest paths in a <code>Graph</code> using Dijkstra's algorithm,
+ * A* search, or bidirectional search.
+ */
+
+#ifndef _shortestpath_h
+#define _shortestpath_h
+
+#include <climits>
+#include <limits>
+#include <string>
+
+#include "graph.h"
+#include "pqueue.h"
+#include "vector.h"
+
+/*
+ * Class: ShortestPaths<NodeType,ArcType>
+ * --------------------------------------
+ * This class finds shortest paths in a graph, measuring each arc by its
+ * <code>cost</code> field.  An object of this class is a search context:
+ * it takes a snapshot of the graph when it is created and keeps its
+ * per-node arrays and priority queues from one search to the next, so a
+ * program that answers many queries creates one context and reuses it:
+ *
+ *<pre>
+ *    ShortestPaths&lt;NodeType,ArcType&gt; paths(g);
+ *    for (...) {
+ *        Vector&lt;ArcType *&gt; route = paths.findPath(n1, n2);
+ *        ...
+ *    }
+ *</pre>
+ *
+ * Each search starts in time proportional to the work it does rather
+ * than to the size of the graph.  Because the context searches its
+ * snapshot, a client that changes the graph must call <code>update</code>
+ * before the next search.  Arc costs must not be negative.
+ */
+
+template <typename NodeType, typename ArcType>
+class ShortestPaths {
+public:
+    /*
+     * Constructor: ShortestPaths
+     * Usage: ShortestPaths<NodeType,ArcType> paths(g);
+     * ------------------------------------------------
+     * Creates a search context for the specified graph.
+     */
+
+    explicit ShortestPaths(const Graph<NodeType, ArcType>& graph);
+
+    /*
+     * Destructor: ~ShortestPaths
+     * --------------------------
+     * Frees the storage used by the context.
+     */
+
+    virtual ~ShortestPaths();
+
+    /*
+     * Method: update
+     * Usage: paths.update(g);
+     * -----------------------
+     * Takes a new snapshot of the graph, which must be done after the
+     * graph changes.  The results of the previous search are discarded.
+     */
+
+    void update(const Graph<NodeType, ArcType>& graph);
+
+    /*
+     * Method: searchFrom
+     * Usage: paths.searchFrom(start);
+     *        paths.searchFrom(start, limit);
+     * --------------------------------------
+     * Runs Dijkstra's algorithm from <code>start</code>, finding the
+     * distance to every node that can be reached.  If <code>limit</code>
+     * is specified, the search stops once the remaining nodes are
+     * farther away than that.  The results are available through
+     * <code>getDistance</code> and <code>getPath</code>.
+     */
+
+    void searchFrom(NodeType* start, double limit = std::numeric_limits<double>::infinity());
+
+    /*
+     * Method: findPath
+     * Usage: Vector<ArcType *> path = paths.findPath(start, finish);
+     *        Vector<ArcType *> path = paths.findPath(start, finish, heuristic);
+     * --------------------------------------------------------------------
+     * Returns the arcs of a shortest path from <code>start</code> to
+     * <code>finish</code>, or an empty vector if there is no such path.
+     * The search stops as soon as it knows the distance to
+     * <code>finish</code>.  The second form runs A* search, which visits
+     * fewer nodes by exploring first the nodes whose estimated total
+     * distance is smallest.  The <code>heuristic</code> function takes a
+     * node and returns an estimate of its distance to <code>finish</code>,
+     * which must never be larger than the true distance if the path is
+     * to be a shortest one.
+     */
+
+    Vector<ArcType*> findPath(NodeType* start, NodeType* finish);
+
+    template <typename HeuristicType>
+    Vector<ArcType*> findPath(NodeType* start, NodeType* finish, HeuristicType heuristic);
+
+    /*
+     * Method: findPathBidirectional
+     * Usage: Vector<ArcType *> path = paths.findPathBidirectional(start, finish);
+     * --------------------------------------------------------------------------
+     * Returns the same result as <code>findPath(start, finish)</code>,
+     * but searches forward from <code>start</code> and backward from
+     * <code>finish</code> at the same time, which usually visits far fewer
+     * nodes in large graphs.  The first call builds a reversed copy of the
+     * snapshot, which later calls reuse.
+     */
+
+    Vector<ArcType*> findPathBidirectional(NodeType* start, NodeType* finish);
+
+    /*
+     * Method: getDistance
+     * Usage: double distance = paths.getDistance(node);
+     * -------------------------------------------------
+     * Returns the length of the shortest path from the start of the most
+     * recent search to <code>node</code>, or infinity if the search did
+     * not determine it.  A search that stops early determines the
+     * distance only to the nodes it has finished with, which always
+     * include the finish node if a path exists.
+     */
+
+    double getDistance(NodeType* node) const;
+
+    /*
+     * Method: getPath
+     * Usage: Vector<ArcType *> path = paths.getPath(node);
+     * ----------------------------------------------------
+     * Returns the arcs of a shortest path from the start of the most
+     * recent search to <code>node</code>, or an empty vector if the
+     * search did not determine one.
+     */
+
+    Vector<ArcType*> getPath(NodeType* node) const;
+
+    /*
+     * Method: getSettledCount
+     * Usage: int n = paths.getSettledCount();
+     * ---------------------------------------
+     * Returns the number of nodes whose distance the most recent search
+     * determined, counting both directions of a bidirectional search.
+     * This number measures how much work the search did.
+     */
+
+    int getSettledCount() const;
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: ShortestPaths data structure
+     * --------------------------------------------------
+     * The searches run on a CompactGraph snapshot, using its node ids to
+     * index the arrays of a Frontier, which holds the state of a search
+     * in one direction.  Instead of resetting those arrays before each
+     * search, the context numbers its searches and stamps each entry
+     * with the number of the search that wrote it, so an entry with an
+     * old stamp reads as unreached.  The backward search of
+     * findPathBidirectional follows the arcs of the graph in reverse,
+     * using arrays built from the snapshot on first use.  Paths are
+     * recorded as arc positions in the snapshot, which are the same in
+     * both directions, and arcStarts maps each position back to the node
+     * it leaves.
+     */
+
+private:
+    typedef typename PriorityQueue<int>::Handle Handle;
+
+    struct Frontier {
+        Vector<double> distance; /* Best known distance to each node      */
+        Vector<int> parent;      /* Arc position that reached each node   */
+        Vector<int> reached;     /* Search that last set the distance     */
+        Vector<int> settled;     /* Search that finished with the node    */
+        Vector<Handle> handle;   /* Queue entry of each node              */
+        PriorityQueue<int> queue;
+    };
+
+    CompactGraph<NodeType, ArcType> csr; /* The snapshot being searched     */
+    Vector<int> reverseOffsets;          /* First incoming arc of each node */
+    Vector<int> reverseArcs;             /* Incoming arcs, by position      */
+    Vector<int> arcStarts;               /* The start node of each arc      */
+    Frontier forward;                    /* Search state from the start     */
+    Frontier backward;                   /* Search state from the finish    */
+    int round;                           /* Number of the current search    */
+    int settledCount;                    /* Nodes settled by this search    */
+
+    void resetFrontier(Frontier& frontier);
+    void beginSearch();
+    int checkNode(NodeType* node, const char* prefix) const;
+    bool isReached(const Frontier& frontier, int id) const;
+    bool isSettled(const Frontier& frontier, int id) const;
+    void relax(Frontier& frontier, int id, double distance, int arc, double priority);
+    void buildReverseArcs();
+    void joinBackwardPath(int meet, int target);
+    Vector<ArcType*> tracePath(int id) const;
+
+    ShortestPaths(const ShortestPaths&) = delete;
+    ShortestPaths& operator=(const ShortestPaths&) = delete;
+};
+
+extern void error(std::string msg);
+
+template <typename NodeType, typename ArcType>
+ShortestPaths<NodeType, ArcType>::ShortestPaths(const Graph<NodeType, ArcType>& graph) {
+    update(graph);
+}
+
+template <typename NodeType, typename ArcType>
+ShortestPaths<NodeType, ArcType>::~ShortestPaths() {
+    /* Empty */
+}
+
+/*
+ * Implementation notes: update
+ * ----------------------------
+ * Taking a new snapshot sizes the search arrays to the new graph,
+ * records the start node of each arc, and discards the reverse arcs,
+ * which are rebuilt only if a bidirectional search needs them.
+ */
+
+template <typename NodeType, typename ArcType>
+void ShortestPaths<NodeType, ArcType>::update(const Graph<NodeType, ArcType>& graph) {
+    csr = graph.freeze();
+    for (double cost : csr.getCosts()) {
+        if (cost < 0)
+            error("ShortestPaths: Arc costs must not be negative");
+    }
+    const Vector<int>& offsets = csr.getOffsets();
+    arcStarts = Vector<int>(csr.arcCount());
+    for (int id = 0; id < csr.idLimit(); id++) {
+        for (int arc = offsets[id]; arc < offsets[id + 1]; arc++) {
+            arcStarts[arc] = id;
+        }
+    }
+    reverseOffsets.clear();
+    reverseArcs.clear();
+    round = 0;
+    settledCount = 0;
+    resetFrontier(forward);
+    resetFrontier(backward);
+}
+
+template <typename NodeType, typename ArcType>
+void ShortestPaths<NodeType, ArcType>::searchFrom(NodeType* start, double limit) {
+    int source = checkNode(start, "searchFrom");
+    beginSearch();
+    relax(forward, source, 0, -1, 0);
+    while (!forward.queue.isEmpty() && forward.queue.peekPriority() <= limit) {
+        int id = forward.queue.dequeue();
+        forward.settled[id] = round;
+        settledCount++;
+        const Vector<int>& offsets = csr.getOffsets();
+        const Vector<int>& targets = csr.getTargets();
+        const Vector<double>& costs = csr.getCosts();
+        for (int arc = offsets[id]; arc < offsets[id + 1]; arc++) {
+            double distance = forward.distance[id] + costs[arc];
+            relax(forward, targets[arc], distance, arc, distance);
+        }
+    }
+}
+
+/*
+ * Implementation notes: findPath
+ * ------------------------------
+ * Dijkstra's algorithm is A* search with a heuristic of zero.  The A*
+ * loop orders nodes by distance plus estimate and stops when it takes
+ * the finish node from the queue.  Because an estimate that never
+ * overstates a distance may still be inconsistent from one node to the
+ * next, a node that is reached again by a shorter path after it has
+ * been settled goes back into the queue.
+ */
+
+template <typename NodeType, typename ArcType>
+Vector<ArcType*> ShortestPaths<NodeType, ArcType>::findPath(NodeType* start, NodeType* finish) {
+    return findPath(start, finish, [](NodeType*) { return 0.0; });
+}
+
+template <typename NodeType, typename ArcType>
+template <typename HeuristicType>
+Vector<ArcType*> ShortestPaths<NodeType, ArcType>::findPath(NodeType* start, NodeType* finish,
+                                                             HeuristicType heuristic) {
+    int source = checkNode(start, "findPath");
+    int target = checkNode(finish, "findPath");
+    beginSearch();
+    relax(forward, source, 0, -1, heuristic(start));
+    const Vector<int>& offsets = csr.getOffsets();
+    const Vector<int>& targets = csr.getTargets();
+    const Vector<double>& costs = csr.getCosts();
+    while (!forward.queue.isEmpty()) {
+        int id = forward.queue.dequeue();
+        if (forward.settled[id] != round) {
+            forward.settled[id] = round;
+            settledCount++;
+        }
+        if (id == target)
+            return tracePath(target);
+        for (int arc = offsets[id]; arc < offsets[id + 1]; arc++) {
+            int next = targets[arc];
+            double distance = forward.distance[id] + costs[arc];
+            if (!isReached(forward, next) || distance < forward.distance[next]) {
+                relax(forward, next, distance, arc, distance + heuristic(csr.getNode(next)));
+            }
+        }
+    }
+    return Vector<ArcType*>();
+}
+
+/*
+ * Implementation notes: findPathBidirectional
+ * -------------------------------------------
+ * The two searches take turns settling the node at the front of
+ * whichever queue has the smaller priority.  Every time a node gets a
+ * new distance from one side and has a distance from the other, the sum
+ * of the two is the length of some path, and the shortest of these is
+ * remembered along with the node where the sides meet.  Once the two
+ * queue fronts add up to at least that length, no shorter path can be
+ * found.  The path is then the forward path to the meeting node followed
+ * by the backward path from there to the finish, which is copied into
+ * the forward arrays so that getPath and getDistance see the whole path.
+ */
+
+template <typename NodeType, typename ArcType>
+Vector<ArcType*> ShortestPaths<NodeType, ArcType>::findPathBidirectional(NodeType* start,
+                                                                         NodeType* finish) {
+    int source = checkNode(start, "findPathBidirectional");
+    int target = checkNode(finish, "findPathBidirectional");
+    if (reverseOffsets.isEmpty())
+        buildReverseArcs();
+    beginSearch();
+    relax(forward, source, 0, -1, 0);
+    relax(backward, target, 0, -1, 0);
+    double best = std::numeric_limits<double>::infinity();
+    int meet = (source == target) ? source : -1;
+    if (meet >= 0)
+        best = 0;
+    const Vector<int>& offsets = csr.getOffsets();
+    const Vector<int>& targets = csr.getTargets();
+    const Vector<double>& costs = csr.getCosts();
+    while (!forward.queue.isEmpty() && !backward.queue.isEmpty()) {
+        double frontF = forward.queue.peekPriority();
+        double frontB = backward.queue.peekPriority();
+        if (frontF + frontB >= best)
+            break;
+        bool goForward = frontF <= frontB;
+        Frontier& side = goForward ? forward : backward;
+        Frontier& other = goForward ? backward : forward;
+        int id = side.queue.dequeue();
+        side.settled[id] = round;
+        settledCount++;
+        int first = goForward ? offsets[id] : reverseOffsets[id];
+        int last = goForward ? offsets[id + 1] : reverseOffsets[id + 1];
+        for (int i = first; i < last; i++) {
+            int arc = goForward ? i : reverseArcs[i];
+            int next = goForward ? targets[arc] : arcStarts[arc];
+            double distance = side.distance[id] + costs[arc];
+            if (isReached(side, next) && distance >= side.distance[next])
+                continue;
+            relax(side, next, distance, arc, distance);
+            if (isReached(other, next) && distance + other.distance[next] < best) {
+                best = distance + other.distance[next];
+                meet = next;
+            }
+        }
+    }
+    if (meet < 0)
+        return Vector<ArcType*>();
+    joinBackwardPath(meet, target);
+    return tracePath(target);
+}
+
+template <typename NodeType, typename ArcType>
+double ShortestPaths<NodeType, ArcType>::getDistance(NodeType* node) const {
+    int id = checkNode(node, "getDistance");
+    if (!isSettled(forward, id))
+        return std::numeric_limits<double>::infinity();
+    return forward.distance[id];
+}
+
+template <typename NodeType, typename ArcType>
+Vector<ArcType*> ShortestPaths<NodeType, ArcType>::getPath(NodeType* node) const {
+    int id = checkNode(node, "getPath");
+    if (!isSettled(forward, id) || !isReached(forward, id))
+        return Vector<ArcType*>();
+    return tracePath(id);
+}
+
+template <typename NodeType, typename ArcType>
+int ShortestPaths<NodeType, ArcType>::getSettledCount() const {
+    return settledCount;
+}
+
+/*
+ * Private method: resetFrontier
+ * -----------------------------
+ * Sizes the arrays of a frontier to the snapshot and marks every node
+ * as unreached.  This happens only when the snapshot changes or the
+ * search counter wraps around.
+ */
+
+template <typename NodeType, typename ArcType>
+void ShortestPaths<NodeType, ArcType>::resetFrontier(Frontier& frontier) {
+    int n = csr.idLimit();
+    frontier.distance = Vector<double>(n, 0);
+    frontier.parent = Vector<int>(n, -1);
+    frontier.reached = Vector<int>(n, -1);
+    frontier.settled = Vector<int>(n, -1);
+    frontier.handle = Vector<Handle>(n);
+    frontier.queue.clear();
+}
+
+/*
+ * Private method: beginSearch
+ * ---------------------------
+ * Starts a new search by advancing the search number and emptying the
+ * queues left over from a search that stopped early.  The queues are
+ * emptied by dequeuing so that they keep their storage.
+ */
+
+template <typename NodeType, typename ArcType>
+void ShortestPaths<NodeType, ArcType>::beginSearch() {
+    if (round == INT_MAX) {
+        round = 0;
+        resetFrontier(forward);
+        resetFrontier(backward);
+    }
+    round++;
+    settledCount = 0;
+    while (!forward.queue.isEmpty()) {
+        forward.queue.dequeue();
+    }
+    while (!backward.queue.isEmpty()) {
+        backward.queue.dequeue();
+    }
+}
+
+template <typename NodeType, typename ArcType>
+int ShortestPaths<NodeType, ArcType>::checkNode(NodeType* node, const char* prefix) const {
+    int id = csr.getId(node);
+    if (id < 0)
+        error(std::string("ShortestPaths::") + prefix + ": Node is not in the graph");
+    return id;
+}
+
+template <typename NodeType, typename ArcType>
+bool ShortestPaths<NodeType, ArcType>::isReached(const Frontier& frontier, int id) const {
+    return frontier.reached[id] == round;
+}
+
+template <typename NodeType, typename ArcType>
+bool ShortestPaths<NodeType, ArcType>::isSettled(const Frontier& frontier, int id) const {
+    return frontier.settled[id] == round;
+}
+
+/*
+ * Private method: relax
+ * ---------------------
+ * Records a new best distance to a node and the arc that achieves it,
+ * and gives the node the specified priority in the queue, adding it to
+ * the queue if it is not already there.  The caller has checked that
+ * the distance is an improvement.
+ */
+
+template <typename NodeType, typename ArcType>
+void ShortestPaths<NodeType, ArcType>::relax(Frontier& frontier, int id, double distance, int arc,
+                                             double priority) {
+    if (isReached(frontier, id) && distance >= frontier.distance[id])
+        return;
+    bool queued = isReached(frontier, id) && frontier.queue.contains(frontier.handle[id]);
+    frontier.distance[id] = distance;
+    frontier.parent[id] = arc;
+    frontier.reached[id] = round;
+    if (queued) {
+        frontier.queue.changePriority(frontier.handle[id], priority);
+    } else {
+        frontier.handle[id] = frontier.queue.enqueue(id, priority);
+    }
+}
+
+/*
+ * Private method: buildReverseArcs
+ * --------------------------------
+ * Groups the arc positions of the snapshot by finish node with a
+ * counting sort, which gives each node a contiguous list of incoming
+ * arcs in the same form as the snapshot's outgoing ones.
+ */
+
+template <typename NodeType, typename ArcType>
+void ShortestPaths<NodeType, ArcType>::buildReverseArcs() {
+    int n = csr.idLimit();
+    int m = csr.arcCount();
+    const Vector<int>& targets = csr.getTargets();
+    reverseOffsets = Vector<int>(n + 1, 0);
+    for (int arc = 0; arc < m; arc++) {
+        reverseOffsets[targets[arc] + 1]++;
+    }
+    for (int id = 0; id < n; id++) {
+        reverseOffsets[id + 1] += reverseOffsets[id];
+    }
+    reverseArcs = Vector<int>(m);
+    Vector<int> next = reverseOffsets;
+    for (int arc = 0; arc < m; arc++) {
+        reverseArcs[next[targets[arc]]++] = arc;
+    }
+}
+
+/*
+ * Private method: joinBackwardPath
+ * --------------------------------
+ * Walks the backward parent arcs from the meeting node to the finish,
+ * giving each node along the way its forward parent and distance.  Every
+ * part of a shortest path is itself a shortest path, so the distances
+ * written here are final.
+ */
+
+template <typename NodeType, typename ArcType>
+void ShortestPaths<NodeType, ArcType>::joinBackwardPath(int meet, int target) {
+    const Vector<int>& targets = csr.getTargets();
+    const Vector<double>& costs = csr.getCosts();
+    forward.settled[meet] = round;
+    for (int id = meet; id != target;) {
+        int arc = backward.parent[id];
+        int next = targets[arc];
+        forward.distance[next] = forward.distance[id] + costs[arc];
+        forward.parent[next] = arc;
+        forward.reached[next] = round;
+        forward.settled[next] = round;
+        id = next;
+    }
+}
+
+/*
+ * Private method: tracePath
+ * -------------------------
+ * Follows the forward parent arcs back from a node to the start of the
+ * search and returns the arcs in order from the start.  The first pass
+ * counts the arcs so that the second can fill the vector from the end.
+ */
+
+template <typename NodeType, typename ArcType>
+Vector<ArcType*> ShortestPaths<NodeType, ArcType>::tracePath(int id) const {
+    int length = 0;
+    for (int arc = forward.parent[id]; arc >= 0; arc = forward.parent[arcStarts[arc]]) {
+        length++;
+    }
+    Vector<ArcType*> path(length);
+    const Vector<ArcType*>& arcs = csr.getArcs();
+    for (int arc = forward.parent[id]; arc >= 0; arc = forward.parent[arcStarts[arc]]) {
+        path[--length] = arcs[arc];
+    }
+    return path;
+}
+
+#endif  // _shortestpath_h
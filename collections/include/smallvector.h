@@ -0,0 +1,237 @@
+/*
+ * File: smallvector.h
+ * -------------------
+ * This file exports the <code>SmallVector</code> class, a
+ * <code>Vector</code> that keeps its first few elements inside the
+ * object itself instead of on the heap.
+ */
+
+#ifndef _smallvector_h
+#define _smallvector_h
+
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include "vector.h"
+
+/*
+ * Class: SmallVector<ValueType, N>
+ * --------------------------------
+ * This class is a <code>Vector</code> with room for <code>N</code>
+ * elements inside the object.  As long as it holds no more than
+ * <code>N</code> elements, it allocates no heap storage at all, which
+ * makes it a good choice for short-lived or numerous lists that are
+ * usually small, such as a local worklist or the neighbors of a node.
+ * Once it outgrows its inline array, it moves its elements to the heap
+ * and behaves exactly like a <code>Vector</code>.  Because
+ * <code>SmallVector</code> is a subclass of <code>Vector</code>, it can
+ * be passed to any function that takes a <code>Vector</code> by
+ * reference.
+ */
+
+template <typename ValueType, int N>
+class SmallVector : public Vector<ValueType> {
+public:
+    /*
+     * Constructor: SmallVector
+     * Usage: SmallVector<ValueType, N> vec;
+     *        SmallVector<ValueType, N> vec(n, value);
+     * -----------------------------------------------
+     * Initializes a new vector.  The default constructor creates an
+     * empty vector.  The second form creates a vector with
+     * <code>n</code> copies of the specified value.
+     */
+
+    SmallVector();
+    explicit SmallVector(int n, ValueType value = ValueType());
+    SmallVector(std::initializer_list<ValueType> list);
+
+    /*
+     * Destructor: ~SmallVector
+     * ------------------------
+     * Frees any heap storage allocated by this vector.
+     */
+
+    virtual ~SmallVector();
+
+    /*
+     * Method: isInline
+     * Usage: if (vec.isInline()) ...
+     * ------------------------------
+     * Returns <code>true</code> if the elements of this vector are stored
+     * inside the object rather than on the heap.
+     */
+
+    bool isInline() const;
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: SmallVector data structure
+     * ------------------------------------------------
+     * The inline array is raw storage for N elements.  A new SmallVector
+     * points its elements at that array, and Vector obtains every later
+     * array through the acquireArray hook, which hands the inline array
+     * back out whenever the requested capacity fits in it.  The inline
+     * array is never in use when that happens: Vector only requests a
+     * capacity of N or less after it has released its elements, since it
+     * neither grows into a smaller array nor shrinks an inline one.
+     */
+
+private:
+    static_assert(N > 0, "SmallVector: inline capacity must be positive");
+
+    alignas(ValueType) unsigned char buffer[N * sizeof(ValueType)];
+
+    ValueType* inlineArray();
+    void useInlineArray();
+
+    virtual ValueType* acquireArray(int& n);
+    virtual void releaseArray(ValueType* array, int n);
+    virtual bool isInlineArray(const ValueType* array) const;
+
+public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * A SmallVector can be copied or moved from another SmallVector or
+     * from any Vector.  Moving from a vector whose elements are on the heap
+     * takes over that storage; elements in an inline array are moved one
+     * at a time.
+     */
+
+    SmallVector(const SmallVector& src);
+    SmallVector(const Vector<ValueType>& src);
+    SmallVector(SmallVector&& src) noexcept;
+    SmallVector(Vector<ValueType>&& src) noexcept;
+    SmallVector& operator=(const SmallVector& src);
+    SmallVector& operator=(const Vector<ValueType>& src);
+    SmallVector& operator=(SmallVector&& src) noexcept;
+    SmallVector& operator=(Vector<ValueType>&& src) noexcept;
+};
+
+/*
+ * Implementation notes: SmallVector constructors and destructor
+ * -------------------------------------------------------------
+ * Virtual calls made by the Vector constructors and destructor do not
+ * reach the overrides in this class, so each constructor starts from an
+ * empty Vector and does its own filling, and the destructor releases the
+ * elements before the Vector destructor runs.
+ */
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::SmallVector() {
+    useInlineArray();
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::SmallVector(int n, ValueType value) {
+    useInlineArray();
+    this->reserve(n);
+    std::uninitialized_fill_n(this->elements, n, value);
+    this->count = n;
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::SmallVector(std::initializer_list<ValueType> list) {
+    useInlineArray();
+    this->reserve(list.size());
+    std::uninitialized_copy(list.begin(), list.end(), this->elements);
+    this->count = list.size();
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::SmallVector(const SmallVector& src)
+        : Vector<ValueType>() {
+    this->deepCopy(src);
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::SmallVector(const Vector<ValueType>& src)
+        : Vector<ValueType>() {
+    this->deepCopy(src);
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::SmallVector(SmallVector&& src) noexcept
+        : Vector<ValueType>() {
+    this->takeElements(src);
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::SmallVector(Vector<ValueType>&& src) noexcept
+        : Vector<ValueType>() {
+    this->takeElements(src);
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>::~SmallVector() {
+    this->clear();
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>& SmallVector<ValueType, N>::operator=(const SmallVector& src) {
+    Vector<ValueType>::operator=(src);
+    return *this;
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>& SmallVector<ValueType, N>::operator=(const Vector<ValueType>& src) {
+    Vector<ValueType>::operator=(src);
+    return *this;
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>& SmallVector<ValueType, N>::operator=(SmallVector&& src) noexcept {
+    Vector<ValueType>::operator=(std::move(src));
+    return *this;
+}
+
+template <typename ValueType, int N>
+SmallVector<ValueType, N>& SmallVector<ValueType, N>::operator=(Vector<ValueType>&& src) noexcept {
+    Vector<ValueType>::operator=(std::move(src));
+    return *this;
+}
+
+template <typename ValueType, int N>
+bool SmallVector<ValueType, N>::isInline() const {
+    return isInlineArray(this->elements);
+}
+
+template <typename ValueType, int N>
+ValueType* SmallVector<ValueType, N>::inlineArray() {
+    return reinterpret_cast<ValueType*>(buffer);
+}
+
+template <typename ValueType, int N>
+void SmallVector<ValueType, N>::useInlineArray() {
+    this->elements = inlineArray();
+    this->capacity = N;
+}
+
+template <typename ValueType, int N>
+ValueType* SmallVector<ValueType, N>::acquireArray(int& n) {
+    if (n > N)
+        return Vector<ValueType>::allocate(n);
+    n = N;
+    return inlineArray();
+}
+
+template <typename ValueType, int N>
+void SmallVector<ValueType, N>::releaseArray(ValueType* array, int n) {
+    if (!isInlineArray(array))
+        Vector<ValueType>::deallocate(array, n);
+}
+
+template <typename ValueType, int N>
+bool SmallVector<ValueType, N>::isInlineArray(const ValueType* array) const {
+    return array == reinterpret_cast<const ValueType*>(buffer);
+}
+
+#endif  // _smallvector_h
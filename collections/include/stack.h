@@ -27,7 +27,10 @@
 #define _stack_h
 
 #include <initializer_list>
+#include <type_traits>
+#include <utility>
 
+#include "smallvector.h"
 #include "vector.h"
 
 /*
@@ -39,9 +42,14 @@
  * that is the defining feature of stacks.  The fundamental stack
  * operations are <code>push</code> (add to top) and <code>pop</code>
  * (remove from top).
+ *
+ * The optional second template parameter gives the stack room for that
+ * many values inside the object, as in <code>SmallVector</code>.  A
+ * <code>Stack&lt;ValueType,&nbsp;8&gt;</code> used as a local worklist
+ * touches the heap only if it ever holds more than eight values.
  */
 
-template <typename ValueType>
+template <typename ValueType, int N = 0>
 class Stack {
 public:
     /*
@@ -98,6 +106,17 @@ public:
 
     void push(ValueType value);
 
+    /*
+     * Method: emplace
+     * Usage: stack.emplace(args...);
+     * ------------------------------
+     * Constructs a new value from the specified arguments, pushes it onto
+     * this stack, and returns a reference to it.
+     */
+
+    template <typename... Args>
+    ValueType& emplace(Args&&... args);
+
     /*
      * Method: pop
      * Usage: ValueType top = stack.pop();
@@ -144,11 +163,27 @@ public:
      * The easiest way to implement a stack is to store the elements in a
      * Vector.  Doing so means that the problems of dynamic memory allocation
      * and copy assignment are already solved by the implementation of the
-     * underlying Vector class.
+     * underlying Vector class.  A stack with inline capacity uses a
+     * SmallVector instead.
      */
 
 private:
-    Vector<ValueType> elements;
+    typename std::conditional<N == 0, Vector<ValueType>, SmallVector<ValueType, N>>::type elements;
+
+public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * Copying a stack copies the underlying vector.  Moving a stack
+     * transfers the vector's storage and leaves the source stack empty.
+     * These operations are declared explicitly because the virtual
+     * destructor would otherwise suppress the move operations.
+     */
+
+    Stack(const Stack& src) = default;
+    Stack(Stack&& src) = default;
+    Stack& operator=(const Stack& src) = default;
+    Stack& operator=(Stack&& src) = default;
 };
 
 extern void error(std::string msg);
@@ -161,78 +196,84 @@ extern void error(std::string msg);
  * methods can be implemented in as single line.
  */
 
-template <typename ValueType>
-Stack<ValueType>::Stack() {
+template <typename ValueType, int N>
+Stack<ValueType, N>::Stack() {
     /* Empty */
 }
 
-template <typename ValueType>
-Stack<ValueType>::Stack(std::initializer_list<ValueType> list) {
+template <typename ValueType, int N>
+Stack<ValueType, N>::Stack(std::initializer_list<ValueType> list) {
     for (const ValueType& element : list) {
         push(element);
     }
 }
 
-template <typename ValueType>
-Stack<ValueType>::~Stack() {
+template <typename ValueType, int N>
+Stack<ValueType, N>::~Stack() {
     /* Empty */
 }
 
-template <typename ValueType>
-int Stack<ValueType>::size() const {
+template <typename ValueType, int N>
+int Stack<ValueType, N>::size() const {
     return elements.size();
 }
 
-template <typename ValueType>
-bool Stack<ValueType>::isEmpty() const {
+template <typename ValueType, int N>
+bool Stack<ValueType, N>::isEmpty() const {
     return size() == 0;
 }
 
-template <typename ValueType>
-void Stack<ValueType>::push(ValueType value) {
-    elements.add(value);
+template <typename ValueType, int N>
+void Stack<ValueType, N>::push(ValueType value) {
+    elements.add(std::move(value));
+}
+
+template <typename ValueType, int N>
+template <typename... Args>
+ValueType& Stack<ValueType, N>::emplace(Args&&... args) {
+    return elements.emplace(std::forward<Args>(args)...);
 }
 
-template <typename ValueType>
-ValueType Stack<ValueType>::pop() {
+template <typename ValueType, int N>
+ValueType Stack<ValueType, N>::pop() {
     if (isEmpty())
         error("pop: Attempting to pop an empty stack");
-    ValueType top = elements[elements.size() - 1];
+    ValueType top = std::move(elements[elements.size() - 1]);
     elements.remove(elements.size() - 1);
     return top;
 }
 
-template <typename ValueType>
-ValueType Stack<ValueType>::peek() const {
+template <typename ValueType, int N>
+ValueType Stack<ValueType, N>::peek() const {
     if (isEmpty())
         error("peek: Attempting to peek at an empty stack");
     return elements.get(elements.size() - 1);
 }
 
-template <typename ValueType>
-ValueType& Stack<ValueType>::top() {
+template <typename ValueType, int N>
+ValueType& Stack<ValueType, N>::top() {
     if (isEmpty())
         error("top: Attempting to read top of an empty stack");
     return elements[elements.size() - 1];
 }
 
-template <typename ValueType>
-void Stack<ValueType>::clear() {
+template <typename ValueType, int N>
+void Stack<ValueType, N>::clear() {
     elements.clear();
 }
 
-template <typename ValueType>
-std::string Stack<ValueType>::toString() {
+template <typename ValueType, int N>
+std::string Stack<ValueType, N>::toString() {
     std::ostringstream os;
     os << *this;
     return os.str();
 }
 
-template <typename ValueType>
-std::ostream& operator<<(std::ostream& os, const Stack<ValueType>& stack) {
+template <typename ValueType, int N>
+std::ostream& operator<<(std::ostream& os, const Stack<ValueType, N>& stack) {
     os << "{";
-    Stack<ValueType> copy = stack;
-    Stack<ValueType> reversed;
+    Stack<ValueType, N> copy = stack;
+    Stack<ValueType, N> reversed;
     while (!copy.isEmpty()) {
         reversed.push(copy.pop());
     }
@@ -245,8 +286,8 @@ std::ostream& operator<<(std::ostream& os, const Stack<ValueType>& stack) {
     return os << "}";
 }
 
-template <typename ValueType>
-std::istream& operator>>(std::istream& is, Stack<ValueType>& stack) {
+template <typename ValueType, int N>
+std::istream& operator>>(std::istream& is, Stack<ValueType, N>& stack) {
     char ch;
     is >> ch;
     if (ch != '{')
@@ -0,0 +1,54 @@
+/*
+ * File: transparentkey.h
+ * ----------------------
+ * This file exports the <code>IsTransparentKey</code> trait, which tells
+ * the map and set classes which argument types may be used to look up a
+ * key without first converting the argument to the key type.
+ */
+
+#ifndef _transparentkey_h
+#define _transparentkey_h
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/*
+ * Trait: IsTransparentKey<KeyType,LookupType>
+ * -------------------------------------------
+ * Has the value <code>true</code> if a key of type <code>LookupType</code>
+ * can be compared directly against stored keys of type
+ * <code>KeyType</code>.  Such a lookup key must support <code>==</code>
+ * and <code>&lt;</code> with <code>KeyType</code>, and
+ * <code>hashCode64</code> must return the same value for it as for the
+ * equivalent <code>KeyType</code>.  The library enables
+ * <code>std::string_view</code> and C strings as lookup keys for
+ * <code>std::string</code>; clients may add their own specializations.
+ */
+
+template <typename KeyType, typename LookupType>
+struct IsTransparentKey : std::false_type {};
+
+template <>
+struct IsTransparentKey<std::string, std::string_view> : std::true_type {};
+
+template <>
+struct IsTransparentKey<std::string, const char*> : std::true_type {};
+
+template <>
+struct IsTransparentKey<std::string, char*> : std::true_type {};
+
+/*
+ * Type: EnableIfTransparent<KeyType,LookupType,ResultType>
+ * --------------------------------------------------------
+ * Names <code>ResultType</code> if <code>LookupType</code>, after array
+ * and function decay, is a transparent key for <code>KeyType</code>, and
+ * otherwise removes the declaration that uses it from overload resolution.
+ */
+
+template <typename KeyType, typename LookupType, typename ResultType>
+using EnableIfTransparent =
+    typename std::enable_if<IsTransparentKey<KeyType, typename std::decay<LookupType>::type>::value,
+                            ResultType>::type;
+
+#endif  // _transparentkey_h
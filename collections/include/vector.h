@@ -27,14 +27,31 @@
 #define _vector_h
 
 #include <algorithm>
+#include <climits>
+#include <cstring>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <new>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "strlib.h"
 
+/*
+ * Bounds checking
+ * ---------------
+ * Element access through get, set, and the [] operator checks its index
+ * and signals an error if it is out of range.  Defining the symbol
+ * SPL_UNCHECKED_INDEXING compiles those checks out, which lets the
+ * compiler vectorize loops over the elements.  The CMake build defines
+ * it for release configurations.  Methods that change the size of the
+ * vector always check their arguments.
+ */
+
 /*
  * Class: Vector<ValueType>
  * ------------------------
@@ -185,6 +202,78 @@ public:
     void remove(int index);
     void removeAt(int index);
 
+    /*
+     * Method: insertRange
+     * Usage: vec.insertRange(index, v2);
+     *        vec.insertRange(index, first, last);
+     * -------------------------------------------
+     * Inserts copies of all the elements of <code>v2</code>, or of the
+     * elements in the iterator range from <code>first</code> up to but not
+     * including <code>last</code>, before the specified index.  The
+     * subsequent elements are shifted right only once, by the number of
+     * new elements.  This method signals an error if the index is outside
+     * the range from 0 up to and including the length of the vector.  The
+     * iterators may not refer to elements of this vector, but
+     * <code>v2</code> may be this vector itself.
+     */
+
+    void insertRange(int index, const Vector& v2);
+
+    template <typename InputIterator>
+    void insertRange(int index, InputIterator first, InputIterator last);
+
+    /*
+     * Method: appendAll
+     * Usage: vec.appendAll(v2);
+     *        vec.appendAll(first, last);
+     * ----------------------------------
+     * Adds copies of all the elements of <code>v2</code>, or of the
+     * elements in the iterator range, to the end of this vector, growing
+     * the internal array at most once.
+     */
+
+    void appendAll(const Vector& v2);
+
+    template <typename InputIterator>
+    void appendAll(InputIterator first, InputIterator last);
+
+    /*
+     * Method: removeRange
+     * Usage: vec.removeRange(start, length);
+     * --------------------------------------
+     * Removes the <code>length</code> elements starting at index
+     * <code>start</code>, shifting the subsequent elements left only once.
+     * This method signals an error if the range does not lie within the
+     * vector.
+     */
+
+    void removeRange(int start, int length);
+
+    /*
+     * Method: removeIf
+     * Usage: int n = vec.removeIf(pred);
+     * ----------------------------------
+     * Removes every element for which <code>pred</code> returns
+     * <code>true</code> and returns the number of elements removed.  The
+     * remaining elements keep their order and are compacted in a single
+     * pass, so the method runs in linear time however many are removed.
+     */
+
+    template <typename Predicate>
+    int removeIf(Predicate pred);
+
+    /*
+     * Method: swapRemove
+     * Usage: vec.swapRemove(index);
+     * -----------------------------
+     * Removes the element at the specified index in constant time by
+     * moving the last element into its place.  Unlike <code>remove</code>,
+     * this method does not preserve the order of the remaining elements.
+     * It signals an error if the index is outside the array range.
+     */
+
+    void swapRemove(int index);
+
     /*
      * Method: add
      * Usage: vec.add(value);
@@ -197,6 +286,25 @@ public:
     void add(ValueType value);
     void push_back(ValueType value);
 
+    /*
+     * Method: emplace
+     * Usage: vec.emplace(args...);
+     *        vec.emplaceAt(index, args...);
+     * -------------------------------------
+     * Constructs a new element from the specified arguments and adds it
+     * to the end of this vector or, in the second form, inserts it before
+     * the specified index as <code>insert</code> does.  Both methods
+     * return a reference to the new element.  These methods avoid making
+     * a copy of a value that the client would otherwise build only to
+     * pass it to <code>add</code>.
+     */
+
+    template <typename... Args>
+    ValueType& emplace(Args&&... args);
+
+    template <typename... Args>
+    ValueType& emplaceAt(int index, Args&&... args);
+
     /*
      * Operator: []
      * Usage: vec[index]
@@ -212,6 +320,32 @@ public:
     ValueType& operator[](int index);
     const ValueType& operator[](int index) const;
 
+    /*
+     * Method: at_unchecked
+     * Usage: vec.at_unchecked(index)
+     * ------------------------------
+     * Returns a reference to the element at the specified index without
+     * checking the index, even when bounds checking is enabled.  This
+     * method is intended for inner loops whose indices are known to be in
+     * range; an index outside the vector has undefined behavior.
+     */
+
+    ValueType& at_unchecked(int index);
+    const ValueType& at_unchecked(int index) const;
+
+    /*
+     * Method: data
+     * Usage: ValueType* array = vec.data();
+     * -------------------------------------
+     * Returns a pointer to the contiguous array that holds the elements of
+     * this vector, which may be <code>nullptr</code> if the vector is
+     * empty.  The pointer remains valid until the next operation that
+     * changes the size or capacity of the vector.
+     */
+
+    ValueType* data();
+    const ValueType* data() const;
+
     /*
      * Operator: +
      * Usage: v1 + v2
@@ -282,6 +416,54 @@ public:
     template <typename FunctorType>
     void mapAll(FunctorType fn) const;
 
+    /*
+     * Method: reserve
+     * Usage: vec.reserve(n);
+     * ----------------------
+     * Ensures that this vector has room for at least <code>n</code>
+     * elements, so that adding elements up to that size never needs to
+     * reallocate the internal array.  The size of the vector and the
+     * values of its elements are unchanged.
+     */
+
+    void reserve(int n);
+
+    /*
+     * Method: shrinkToFit
+     * Usage: vec.shrinkToFit();
+     * -------------------------
+     * Reduces the internal array to exactly the size of this vector,
+     * releasing any unused capacity.
+     */
+
+    void shrinkToFit();
+
+    /*
+     * Method: resize
+     * Usage: vec.resize(n);
+     *        vec.resize(n, fill);
+     * ---------------------------
+     * Changes the size of this vector to <code>n</code>.  If the vector
+     * grows, the new elements are copies of <code>fill</code>, which
+     * defaults to the default value for the type.  If it shrinks, the
+     * elements at the end are removed.
+     */
+
+    void resize(int n, const ValueType& fill = ValueType());
+
+    /*
+     * Method: setGrowthFactor
+     * Usage: vec.setGrowthFactor(factor);
+     * -----------------------------------
+     * Sets the factor by which the internal array grows when it runs out
+     * of room.  The default of 2 doubles the array, so that appending
+     * takes constant amortized time.  Smaller factors such as 1.5 waste
+     * less memory at the cost of more frequent reallocation.  This
+     * method signals an error unless <code>factor</code> exceeds 1.
+     */
+
+    void setGrowthFactor(double factor);
+
     /*
      * Additional Vector operations
      * ----------------------------
@@ -307,20 +489,52 @@ private:
      * Implementation notes: Vector data structure
      * -------------------------------------------
      * The elements of the Vector are stored in a dynamic array of
-     * the specified element type.  If the space in the array is ever
-     * exhausted, the implementation doubles the array capacity.
+     * the specified element type.  The array is allocated as raw
+     * storage, and only the first count slots hold constructed
+     * elements; the rest are constructed in place as the vector
+     * grows.  If the space in the array is ever exhausted, the
+     * implementation multiplies its capacity by the growth factor.
      */
 
+    /* Constants */
+
+    static constexpr double DEFAULT_GROWTH_FACTOR = 2.0;
+
     /* Instance variables */
 
     ValueType* elements; /* A dynamic array of the elements   */
     int capacity;        /* The allocated size of the array   */
     int count;           /* The number of elements in use     */
+    double growthFactor; /* Capacity multiplier for growth    */
 
     /* Private methods */
 
-    void expandCapacity();
+    static ValueType* allocate(int n);
+    static void deallocate(ValueType* array, int n);
+    static void relocate(ValueType* src, int n, ValueType* dst);
+    void releaseStorage();
+    void reallocate(int newCapacity);
+    int nextCapacity() const;
+    void makeRoom(int index, int n = 1);
     void deepCopy(const Vector& src);
+    void takeElements(Vector& src);
+
+    /*
+     * Storage hooks
+     * -------------
+     * All storage that outlives a constructor is obtained and released
+     * through these virtual methods, which SmallVector overrides to hand
+     * out an array inside the object itself.  acquireArray may raise n
+     * to the size of the array it returns.  isInlineArray tells the move
+     * operations whether an array can be taken over by another vector.
+     */
+
+    virtual ValueType* acquireArray(int& n);
+    virtual void releaseArray(ValueType* array, int n);
+    virtual bool isInlineArray(const ValueType* array) const;
+
+    template <typename T, int N>
+    friend class SmallVector;
 
     /*
      * Hidden features
@@ -343,6 +557,18 @@ public:
     Vector(const Vector& src);
     Vector& operator=(const Vector& src);
 
+    /*
+     * Move support
+     * ------------
+     * The move constructor and move assignment operator transfer the
+     * element array from the source vector, which is left empty.  The
+     * elements of a SmallVector held in its inline array are moved
+     * individually instead.
+     */
+
+    Vector(Vector&& src) noexcept;
+    Vector& operator=(Vector&& src) noexcept;
+
     /*
      * Throws an ErrorException if the given index is not within the range of
      * [min..max] inclusive.
@@ -355,6 +581,7 @@ public:
      * construct and then destroy the prefix with each call.
      */
     void checkIndex(int index, int min, int max, const char* prefix) const;
+    void indexError(int index, int min, int max, const char* prefix) const;
 
     /*
      * Operator: ,
@@ -417,43 +644,43 @@ public:
             return copy;
         }
 
-        bool operator==(const iterator& rhs) {
+        bool operator==(const iterator& rhs) const {
             return vp == rhs.vp && index == rhs.index;
         }
 
-        bool operator!=(const iterator& rhs) {
+        bool operator!=(const iterator& rhs) const {
             return !(*this == rhs);
         }
 
-        bool operator<(const iterator& rhs) {
+        bool operator<(const iterator& rhs) const {
             extern void error(std::string msg);
             if (vp != rhs.vp)
                 error("Iterators are in different vectors");
             return index < rhs.index;
         }
 
-        bool operator<=(const iterator& rhs) {
+        bool operator<=(const iterator& rhs) const {
             extern void error(std::string msg);
             if (vp != rhs.vp)
                 error("Iterators are in different vectors");
             return index <= rhs.index;
         }
 
-        bool operator>(const iterator& rhs) {
+        bool operator>(const iterator& rhs) const {
             extern void error(std::string msg);
             if (vp != rhs.vp)
                 error("Iterators are in different vectors");
             return index > rhs.index;
         }
 
-        bool operator>=(const iterator& rhs) {
+        bool operator>=(const iterator& rhs) const {
             extern void error(std::string msg);
             if (vp != rhs.vp)
                 error("Iterators are in different vectors");
             return index >= rhs.index;
         }
 
-        iterator operator+(const int& rhs) {
+        iterator operator+(const int& rhs) const {
             return iterator(vp, index + rhs);
         }
 
@@ -462,7 +689,7 @@ public:
             return *this;
         }
 
-        iterator operator-(const int& rhs) {
+        iterator operator-(const int& rhs) const {
             return iterator(vp, index - rhs);
         }
 
@@ -471,22 +698,22 @@ public:
             return *this;
         }
 
-        int operator-(const iterator& rhs) {
+        int operator-(const iterator& rhs) const {
             extern void error(std::string msg);
             if (vp != rhs.vp)
                 error("Iterators are in different vectors");
             return index - rhs.index;
         }
 
-        ValueType& operator*() {
+        ValueType& operator*() const {
             return vp->elements[index];
         }
 
-        ValueType* operator->() {
+        ValueType* operator->() const {
             return &vp->elements[index];
         }
 
-        ValueType& operator[](int k) {
+        ValueType& operator[](int k) const {
             return vp->elements[index + k];
         }
 
@@ -520,31 +747,28 @@ template <typename ValueType>
 Vector<ValueType>::Vector() {
     count = capacity = 0;
     elements = nullptr;
+    growthFactor = DEFAULT_GROWTH_FACTOR;
 }
 
 template <typename ValueType>
 Vector<ValueType>::Vector(int n, ValueType value) {
     count = capacity = n;
-    elements = (n == 0) ? nullptr : new ValueType[n];
-    for (int i = 0; i < n; i++) {
-        elements[i] = value;
-    }
+    elements = allocate(n);
+    growthFactor = DEFAULT_GROWTH_FACTOR;
+    std::uninitialized_fill_n(elements, n, value);
 }
 
 template <typename ValueType>
 Vector<ValueType>::Vector(std::initializer_list<ValueType> list) {
-    capacity = list.size();
-    count = 0;
-    elements = new ValueType[capacity];
-    for (const ValueType& value : list) {
-        add(value);
-    }
+    count = capacity = list.size();
+    elements = allocate(capacity);
+    growthFactor = DEFAULT_GROWTH_FACTOR;
+    std::uninitialized_copy(list.begin(), list.end(), elements);
 }
 
 template <typename ValueType>
 Vector<ValueType>::~Vector() {
-    if (elements != nullptr)
-        delete[] elements;
+    releaseStorage();
 }
 
 /*
@@ -585,8 +809,7 @@ bool Vector<ValueType>::isEmpty() const {
 
 template <typename ValueType>
 void Vector<ValueType>::clear() {
-    if (elements != nullptr)
-        delete[] elements;
+    releaseStorage();
     count = capacity = 0;
     elements = nullptr;
 }
@@ -614,13 +837,17 @@ void Vector<ValueType>::sort() {
 
 template <typename ValueType>
 const ValueType& Vector<ValueType>::get(int index) const {
+#ifndef SPL_UNCHECKED_INDEXING
     checkIndex(index, 0, size() - 1, "get");
+#endif
     return elements[index];
 }
 
 template <typename ValueType>
 void Vector<ValueType>::set(int index, const ValueType& value) {
+#ifndef SPL_UNCHECKED_INDEXING
     checkIndex(index, 0, size() - 1, "set");
+#endif
     elements[index] = value;
 }
 
@@ -629,18 +856,19 @@ void Vector<ValueType>::set(int index, const ValueType& value) {
  * -----------------------------------------
  * These methods must shift the existing elements in the array to
  * make room for a new element or to close up the space left by a
- * deleted one.
+ * deleted one.  The elements are moved rather than copied, and the
+ * value parameters are moved into place, so that inserting a string
+ * or a nested collection never duplicates its contents.  The slot
+ * left open by makeRoom is uninitialized, so the new element is
+ * constructed there rather than assigned, and remove destroys the
+ * element it vacates at the end of the array.
  */
 
 template <typename ValueType>
 void Vector<ValueType>::insert(int index, ValueType value) {
-    if (count == capacity)
-        expandCapacity();
     checkIndex(index, 0, size(), "insert");
-    for (int i = count; i > index; i--) {
-        elements[i] = elements[i - 1];
-    }
-    elements[index] = value;
+    makeRoom(index);
+    new (elements + index) ValueType(std::move(value));
     count++;
 }
 
@@ -652,8 +880,11 @@ void Vector<ValueType>::insertAt(int index, ValueType value) {
 template <typename ValueType>
 void Vector<ValueType>::remove(int index) {
     checkIndex(index, 0, size() - 1, "remove");
-    for (int i = index; i < count - 1; i++) {
-        elements[i] = elements[i + 1];
+    if constexpr (std::is_trivially_copyable<ValueType>::value) {
+        std::memmove(elements + index, elements + index + 1, (count - index - 1) * sizeof(ValueType));
+    } else {
+        std::move(elements + index + 1, elements + count, elements + index);
+        elements[count - 1].~ValueType();
     }
     count--;
 }
@@ -665,12 +896,204 @@ void Vector<ValueType>::removeAt(int index) {
 
 template <typename ValueType>
 void Vector<ValueType>::add(ValueType value) {
-    insert(count, value);
+    insert(count, std::move(value));
 }
 
 template <typename ValueType>
 void Vector<ValueType>::push_back(ValueType value) {
-    insert(count, value);
+    insert(count, std::move(value));
+}
+
+/*
+ * Implementation notes: insertRange, appendAll
+ * --------------------------------------------
+ * When the number of new elements is known in advance, makeRoom opens a
+ * gap of exactly that size and the elements are copied straight into
+ * it.  Input iterators that can be traversed only once are first
+ * collected into a temporary vector.  Inserting a vector into itself
+ * copies its elements before any of them move.
+ */
+
+template <typename ValueType>
+void Vector<ValueType>::insertRange(int index, const Vector& v2) {
+    if (this == &v2) {
+        Vector<ValueType> copy = v2;
+        insertRange(index, copy.elements, copy.elements + copy.count);
+    } else {
+        insertRange(index, v2.elements, v2.elements + v2.count);
+    }
+}
+
+template <typename ValueType>
+template <typename InputIterator>
+void Vector<ValueType>::insertRange(int index, InputIterator first, InputIterator last) {
+    checkIndex(index, 0, size(), "insertRange");
+    typedef typename std::iterator_traits<InputIterator>::iterator_category Category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+        int n = int(std::distance(first, last));
+        if (n == 0)
+            return;
+        makeRoom(index, n);
+        std::uninitialized_copy(first, last, elements + index);
+        count += n;
+    } else {
+        Vector<ValueType> values;
+        values.appendAll(first, last);
+        insertRange(index, std::make_move_iterator(values.elements),
+                    std::make_move_iterator(values.elements + values.count));
+    }
+}
+
+template <typename ValueType>
+void Vector<ValueType>::appendAll(const Vector& v2) {
+    insertRange(count, v2);
+}
+
+template <typename ValueType>
+template <typename InputIterator>
+void Vector<ValueType>::appendAll(InputIterator first, InputIterator last) {
+    typedef typename std::iterator_traits<InputIterator>::iterator_category Category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+        insertRange(count, first, last);
+    } else {
+        for (; first != last; ++first) {
+            emplace(*first);
+        }
+    }
+}
+
+/*
+ * Implementation notes: removeRange, removeIf, swapRemove
+ * -------------------------------------------------------
+ * Each of these methods moves every surviving element at most once and
+ * then destroys the vacated slots at the end of the array.  As in
+ * remove, trivially copyable elements are shifted with memmove.
+ */
+
+template <typename ValueType>
+void Vector<ValueType>::removeRange(int start, int length) {
+    if (length < 0) {
+        error("Vector::removeRange: length cannot be negative");
+    }
+    checkIndex(start, 0, size(), "removeRange");
+    checkIndex(start + length, 0, size(), "removeRange");
+    if (length == 0)
+        return;
+    int end = start + length;
+    if constexpr (std::is_trivially_copyable<ValueType>::value) {
+        std::memmove(elements + start, elements + end, (count - end) * sizeof(ValueType));
+    } else {
+        std::move(elements + end, elements + count, elements + start);
+        std::destroy(elements + count - length, elements + count);
+    }
+    count -= length;
+}
+
+template <typename ValueType>
+template <typename Predicate>
+int Vector<ValueType>::removeIf(Predicate pred) {
+    int dst = 0;
+    while (dst < count && !pred(elements[dst])) {
+        dst++;
+    }
+    for (int src = dst + 1; src < count; src++) {
+        if (!pred(elements[src])) {
+            elements[dst++] = std::move(elements[src]);
+        }
+    }
+    int removed = count - dst;
+    std::destroy(elements + dst, elements + count);
+    count = dst;
+    return removed;
+}
+
+template <typename ValueType>
+void Vector<ValueType>::swapRemove(int index) {
+    checkIndex(index, 0, size() - 1, "swapRemove");
+    if (index != count - 1) {
+        elements[index] = std::move(elements[count - 1]);
+    }
+    elements[count - 1].~ValueType();
+    count--;
+}
+
+/*
+ * Implementation notes: emplace, emplaceAt
+ * ----------------------------------------
+ * When the new element goes at the end and the array has room, it is
+ * constructed directly in its slot.  Otherwise, the new element is
+ * constructed before the array is touched, which keeps the arguments
+ * valid even if they refer to elements of this vector that are about
+ * to be shifted or reallocated.
+ */
+
+template <typename ValueType>
+template <typename... Args>
+ValueType& Vector<ValueType>::emplace(Args&&... args) {
+    return emplaceAt(count, std::forward<Args>(args)...);
+}
+
+template <typename ValueType>
+template <typename... Args>
+ValueType& Vector<ValueType>::emplaceAt(int index, Args&&... args) {
+    checkIndex(index, 0, size(), "emplaceAt");
+    if (index == count && count < capacity) {
+        new (elements + index) ValueType(std::forward<Args>(args)...);
+    } else {
+        ValueType value(std::forward<Args>(args)...);
+        makeRoom(index);
+        new (elements + index) ValueType(std::move(value));
+    }
+    count++;
+    return elements[index];
+}
+
+/*
+ * Implementation notes: reserve, shrinkToFit, resize, setGrowthFactor
+ * -------------------------------------------------------------------
+ * These methods adjust the internal array directly.  When resize needs
+ * a larger array, it constructs the new elements from a local copy of
+ * fill, which may be an element of this vector.
+ */
+
+template <typename ValueType>
+void Vector<ValueType>::reserve(int n) {
+    if (n < 0) {
+        error("Vector::reserve: capacity cannot be negative");
+    }
+    if (n > capacity)
+        reallocate(n);
+}
+
+template <typename ValueType>
+void Vector<ValueType>::shrinkToFit() {
+    if (count < capacity && !isInlineArray(elements))
+        reallocate(count);
+}
+
+template <typename ValueType>
+void Vector<ValueType>::resize(int n, const ValueType& fill) {
+    if (n < 0) {
+        error("Vector::resize: size cannot be negative");
+    }
+    if (n <= count) {
+        std::destroy(elements + n, elements + count);
+    } else if (n <= capacity) {
+        std::uninitialized_fill(elements + count, elements + n, fill);
+    } else {
+        ValueType value = fill;
+        reallocate(std::max(n, nextCapacity()));
+        std::uninitialized_fill(elements + count, elements + n, value);
+    }
+    count = n;
+}
+
+template <typename ValueType>
+void Vector<ValueType>::setGrowthFactor(double factor) {
+    if (!(factor > 1.0)) {
+        error("Vector::setGrowthFactor: factor must be greater than 1");
+    }
+    growthFactor = factor;
 }
 
 /*
@@ -682,23 +1105,45 @@ void Vector<ValueType>::push_back(ValueType value) {
 
 template <typename ValueType>
 ValueType& Vector<ValueType>::operator[](int index) {
+#ifndef SPL_UNCHECKED_INDEXING
     checkIndex(index, 0, size() - 1, "operator []");
+#endif
     return elements[index];
 }
 
 template <typename ValueType>
 const ValueType& Vector<ValueType>::operator[](int index) const {
+#ifndef SPL_UNCHECKED_INDEXING
     if (index < 0 || index >= count)
         error("Selection index out of range");
+#endif
+    return elements[index];
+}
+
+template <typename ValueType>
+ValueType& Vector<ValueType>::at_unchecked(int index) {
     return elements[index];
 }
 
+template <typename ValueType>
+const ValueType& Vector<ValueType>::at_unchecked(int index) const {
+    return elements[index];
+}
+
+template <typename ValueType>
+ValueType* Vector<ValueType>::data() {
+    return elements;
+}
+
+template <typename ValueType>
+const ValueType* Vector<ValueType>::data() const {
+    return elements;
+}
+
 template <typename ValueType>
 Vector<ValueType> Vector<ValueType>::operator+(const Vector& v2) const {
     Vector<ValueType> vec = *this;
-    for (const ValueType& value : v2) {
-        vec.add(value);
-    }
+    vec.appendAll(v2);
     return vec;
 }
 
@@ -710,9 +1155,7 @@ Vector<ValueType> Vector<ValueType>::operator+(const ValueType& elem) const {
 
 template <typename ValueType>
 Vector<ValueType>& Vector<ValueType>::operator+=(const Vector& v2) {
-    for (const ValueType& value : v2) {
-        *this += value;
-    }
+    appendAll(v2);
     return *this;
 }
 
@@ -754,40 +1197,91 @@ Vector<ValueType>::Vector(const Vector& src) {
 template <typename ValueType>
 Vector<ValueType>& Vector<ValueType>::operator=(const Vector& src) {
     if (this != &src) {
-        if (elements != nullptr)
-            delete[] elements;
+        releaseStorage();
         deepCopy(src);
     }
     return *this;
 }
 
+template <typename ValueType>
+Vector<ValueType>::Vector(Vector&& src) noexcept {
+    takeElements(src);
+}
+
+template <typename ValueType>
+Vector<ValueType>& Vector<ValueType>::operator=(Vector&& src) noexcept {
+    if (this != &src) {
+        releaseStorage();
+        takeElements(src);
+    }
+    return *this;
+}
+
 template <typename ValueType>
 void Vector<ValueType>::deepCopy(const Vector& src) {
     count = capacity = src.count;
-    elements = (capacity == 0) ? nullptr : new ValueType[capacity];
-    for (int i = 0; i < count; i++) {
-        elements[i] = src.elements[i];
+    elements = acquireArray(capacity);
+    growthFactor = src.growthFactor;
+    std::uninitialized_copy(src.elements, src.elements + count, elements);
+}
+
+/*
+ * Implementation notes: takeElements
+ * ----------------------------------
+ * This method gives this vector, whose storage must already be released,
+ * the elements of src and leaves src empty.  Usually it takes over the
+ * array itself.  If the array lives inside a SmallVector, the elements
+ * are relocated into storage of this vector's own instead, and src keeps
+ * its array.
+ */
+
+template <typename ValueType>
+void Vector<ValueType>::takeElements(Vector& src) {
+    growthFactor = src.growthFactor;
+    if (src.isInlineArray(src.elements)) {
+        count = capacity = src.count;
+        elements = acquireArray(capacity);
+        relocate(src.elements, count, elements);
+        src.count = 0;
+    } else {
+        elements = src.elements;
+        capacity = src.capacity;
+        count = src.count;
+        src.elements = nullptr;
+        src.capacity = src.count = 0;
     }
 }
 
+/*
+ * Implementation notes: checkIndex, indexError
+ * --------------------------------------------
+ * The message is built in a separate method so that the check itself
+ * stays small enough to be inlined into every accessor.
+ */
+
 template <typename ValueType>
 void Vector<ValueType>::checkIndex(int index, int min, int max, const char* prefix) const {
     if (index < min || index > max) {
-        std::ostringstream out;
-        out << "Vector::" << prefix << ": index of " << index << " is outside of valid range ";
-        if (isEmpty()) {
-            out << " (empty vector)";
-        } else {
-            out << "[";
-            if (min < max) {
-                out << min << ".." << max;
-            } else if (min == max) {
-                out << min;
-            }  // else min > max, no range, empty vector
-            out << "]";
-        }
-        error(out.str());
+        indexError(index, min, max, prefix);
+    }
+}
+
+template <typename ValueType>
+void Vector<ValueType>::indexError(int index, int min, int max, const char* prefix) const {
+    std::ostringstream out;
+    out << "Vector::" << prefix << ": index of " << index << " is outside of valid range ";
+    if (isEmpty()) {
+        out << " (empty vector)";
+    } else {
+        out << "[";
+        if (min < max) {
+            out << min << ".." << max;
+        } else if (min == max) {
+            out << min;
+        }  // else min > max, no range, empty vector
+        out << "]";
     }
+    error(out.str());
 }
 
 /*
@@ -834,22 +1328,105 @@ void Vector<ValueType>::mapAll(FunctorType fn) const {
 }
 
 /*
- * Implementation notes: expandCapacity
- * ------------------------------------
- * This function doubles the array capacity, copies the old elements
- * into the new array, and then frees the old one.
+ * Implementation notes: storage management
+ * ----------------------------------------
+ * The allocate and deallocate functions obtain and release raw storage
+ * without constructing anything in it.  The relocate function transfers
+ * elements into uninitialized storage and ends the lifetime of the
+ * originals.  Elements of trivially copyable types are transferred with
+ * a single memcpy; all others are moved, which for strings and
+ * collections transfers ownership of their storage instead of copying
+ * it.  The makeRoom function opens an uninitialized gap of n slots at
+ * the specified index.  When the array is too small, it relocates the
+ * elements on either side of the gap straight into the new array, so
+ * that no element is moved twice.  Otherwise, the elements after the
+ * gap that land in unused slots are move-constructed there, and the
+ * rest are move-assigned.
  */
 
 template <typename ValueType>
-void Vector<ValueType>::expandCapacity() {
-    capacity = std::max(1, capacity * 2);
-    ValueType* array = new ValueType[capacity];
-    for (int i = 0; i < count; i++) {
-        array[i] = elements[i];
+ValueType* Vector<ValueType>::allocate(int n) {
+    return (n == 0) ? nullptr : std::allocator<ValueType>().allocate(n);
+}
+
+template <typename ValueType>
+void Vector<ValueType>::deallocate(ValueType* array, int n) {
+    if (array != nullptr)
+        std::allocator<ValueType>().deallocate(array, n);
+}
+
+template <typename ValueType>
+void Vector<ValueType>::relocate(ValueType* src, int n, ValueType* dst) {
+    if (n == 0)
+        return;
+    if constexpr (std::is_trivially_copyable<ValueType>::value) {
+        std::memcpy(dst, src, n * sizeof(ValueType));
+    } else {
+        std::uninitialized_move(src, src + n, dst);
+        std::destroy(src, src + n);
     }
-    if (elements != nullptr)
-        delete[] elements;
+}
+
+template <typename ValueType>
+ValueType* Vector<ValueType>::acquireArray(int& n) {
+    return allocate(n);
+}
+
+template <typename ValueType>
+void Vector<ValueType>::releaseArray(ValueType* array, int n) {
+    deallocate(array, n);
+}
+
+template <typename ValueType>
+bool Vector<ValueType>::isInlineArray(const ValueType*) const {
+    return false;
+}
+
+template <typename ValueType>
+void Vector<ValueType>::releaseStorage() {
+    std::destroy(elements, elements + count);
+    releaseArray(elements, capacity);
+}
+
+template <typename ValueType>
+void Vector<ValueType>::reallocate(int newCapacity) {
+    ValueType* array = acquireArray(newCapacity);
+    relocate(elements, count, array);
+    releaseArray(elements, capacity);
     elements = array;
+    capacity = newCapacity;
+}
+
+template <typename ValueType>
+int Vector<ValueType>::nextCapacity() const {
+    double grown = capacity * growthFactor;
+    if (grown >= INT_MAX)
+        return INT_MAX;
+    return std::max(capacity + 1, int(grown));
+}
+
+template <typename ValueType>
+void Vector<ValueType>::makeRoom(int index, int n) {
+    if (n > capacity - count) {
+        int newCapacity = std::max(nextCapacity(), count + n);
+        ValueType* array = acquireArray(newCapacity);
+        relocate(elements, index, array);
+        relocate(elements + index, count - index, array + index + n);
+        releaseArray(elements, capacity);
+        elements = array;
+        capacity = newCapacity;
+    } else if (index < count) {
+        if constexpr (std::is_trivially_copyable<ValueType>::value) {
+            std::memmove(elements + index + n, elements + index, (count - index) * sizeof(ValueType));
+        } else if (count - index > n) {
+            std::uninitialized_move(elements + count - n, elements + count, elements + count);
+            std::move_backward(elements + index, elements + count - n, elements + count);
+            std::destroy(elements + index, elements + index + n);
+        } else {
+            std::uninitialized_move(elements + index, elements + count, elements + index + n);
+            std::destroy(elements + index, elements + count);
+        }
+    }
 }
 
 /*
@@ -36,6 +36,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "compare.h"
 #include "error.h"
@@ -43,6 +45,8 @@
 #include "strlib.h"
 
 static uint32_t my_ntohl(uint32_t arg);
+static std::string_view toLowerCaseView(std::string_view str, char* buffer, size_t bufferSize,
+                                        std::string& longStr);
 
 /*
  * The DAWG is stored as an array of edges. Each edge is represented by
@@ -72,6 +76,15 @@ DawgLexicon::DawgLexicon(const DawgLexicon& src) {
     deepCopy(src);
 }
 
+DawgLexicon::DawgLexicon(DawgLexicon&& src) : otherWords(std::move(src.otherWords)) {
+    edges = src.edges;
+    start = src.start;
+    numEdges = src.numEdges;
+    numDawgWords = src.numDawgWords;
+    src.edges = src.start = NULL;
+    src.numEdges = src.numDawgWords = 0;
+}
+
 DawgLexicon::~DawgLexicon() {
     if (edges)
         delete[] edges;
@@ -121,27 +134,39 @@ void DawgLexicon::clear() {
     otherWords.clear();
 }
 
-bool DawgLexicon::contains(const std::string& word) const {
-    std::string copy = word;
-    toLowerCaseInPlace(copy);
-    Edge* lastEdge = traceToLastEdge(copy);
+/*
+ * Implementation notes: contains, containsPrefix
+ * ----------------------------------------------
+ * The DAWG is searched directly, since charToOrd already ignores case.
+ * Only the words in otherWords need a lowercase copy of the argument,
+ * which is built in a stack buffer unless the word is unusually long.
+ */
+
+bool DawgLexicon::contains(std::string_view word) const {
+    Edge* lastEdge = traceToLastEdge(word);
     if (lastEdge && lastEdge->accept) {
         return true;
     }
-    return otherWords.contains(copy);
+    if (otherWords.isEmpty()) {
+        return false;
+    }
+    char buffer[64];
+    std::string longWord;
+    return otherWords.contains(toLowerCaseView(word, buffer, sizeof buffer, longWord));
 }
 
-bool DawgLexicon::containsPrefix(const std::string& prefix) const {
+bool DawgLexicon::containsPrefix(std::string_view prefix) const {
     if (prefix.empty())
         return true;
-    std::string copy = prefix;
-    toLowerCaseInPlace(copy);
-    if (traceToLastEdge(copy))
+    if (traceToLastEdge(prefix))
         return true;
-    for (std::string word : otherWords) {
-        if (startsWith(word, copy))
+    char buffer[64];
+    std::string longPrefix;
+    std::string_view lower = toLowerCaseView(prefix, buffer, sizeof buffer, longPrefix);
+    for (const std::string& word : otherWords) {
+        if (word.compare(0, lower.length(), lower) == 0)
             return true;
-        if (copy < word)
+        if (lower < word)
             return false;
     }
     return false;
@@ -325,8 +350,8 @@ void DawgLexicon::readBinaryFile(const std::string& filename) {
  * If a path exists, return last edge; otherwise return NULL.
  */
 
-DawgLexicon::Edge* DawgLexicon::traceToLastEdge(const std::string& s) const {
-    if (!start) {
+DawgLexicon::Edge* DawgLexicon::traceToLastEdge(std::string_view s) const {
+    if (!start || s.empty()) {
         return NULL;
     }
     Edge* curEdge = findEdgeForChar(start, s[0]);
@@ -350,6 +375,22 @@ DawgLexicon& DawgLexicon::operator=(const DawgLexicon& src) {
     return *this;
 }
 
+DawgLexicon& DawgLexicon::operator=(DawgLexicon&& src) {
+    if (this != &src) {
+        if (edges != NULL) {
+            delete[] edges;
+        }
+        edges = src.edges;
+        start = src.start;
+        numEdges = src.numEdges;
+        numDawgWords = src.numDawgWords;
+        otherWords = std::move(src.otherWords);
+        src.edges = src.start = NULL;
+        src.numEdges = src.numDawgWords = 0;
+    }
+    return *this;
+}
+
 void DawgLexicon::iterator::advanceToNextWordInSet() {
     if (setIterator == setEnd) {
         currentSetWord = "";
@@ -421,3 +462,20 @@ static uint32_t my_ntohl(uint32_t arg) {
                       ((arg & 0x0000ff00) << 8) | ((arg & 0x000000ff) << 24);
     return result;
 }
+
+/*
+ * Returns a lowercase copy of str as a view into buffer, or into longStr
+ * if str does not fit in the buffer
+ */
+static std::string_view toLowerCaseView(std::string_view str, char* buffer, size_t bufferSize,
+                                        std::string& longStr) {
+    char* dst = buffer;
+    if (str.length() > bufferSize) {
+        longStr.resize(str.length());
+        dst = &longStr[0];
+    }
+    for (size_t i = 0; i < str.length(); i++) {
+        dst[i] = tolower((unsigned char)str[i]);
+    }
+    return std::string_view(dst, str.length());
+}
@@ -1,77 +1,228 @@
 #include "hashcode.h"
 #include <stdint.h>
 
+#include <chrono>
+#include <cstring>
+#include <random>
+
 const int HASH_SEED = 5381;               // Starting point for first cycle
 const int HASH_MULTIPLIER = 33;           // Multiplier for each cycle
 const int HASH_MASK = unsigned(-1) >> 1;  // All 1 bits except the sign
 
+/*
+ * Implementation notes: hash seed
+ * -------------------------------
+ * The seed combines std::random_device with the clock and the address
+ * of a local variable, so that a weak random_device still gives a
+ * different seed on each run.  It is held in a function-local static so
+ * that hash tables filled during static initialization see the same
+ * value as everything else.
+ */
+
+static uint64_t& seedCell() {
+    static uint64_t seed = [] {
+        std::random_device rd;
+        uint64_t seed = (uint64_t(rd()) << 32) ^ rd();
+        seed ^= uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+        seed ^= uint64_t(reinterpret_cast<uintptr_t>(&seed));
+        return seed;
+    }();
+    return seed;
+}
+
+uint64_t hashSeed() {
+    return seedCell();
+}
+
+void setHashSeed(uint64_t seed) {
+    seedCell() = seed;
+}
+
+/*
+ * Implementation notes: hashMix
+ * -----------------------------
+ * The integer mixer is the finalizer of the splitmix64 generator applied
+ * to the key plus the seed.  Each step is invertible, so distinct keys
+ * never collide in the full 64-bit result.
+ */
+
+uint64_t hashMix(uint64_t x) {
+    x += hashSeed();
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/*
+ * Implementation notes: hashBytes
+ * -------------------------------
+ * The byte hash follows the structure of wyhash.  Short inputs are read
+ * as at most two overlapping words, and longer inputs are consumed in
+ * 48-byte stripes by three independent lanes.  Each step multiplies two
+ * 64-bit words into a 128-bit product and folds the halves together.
+ */
+
+static const uint64_t SECRET[4] = {
+    0xA0761D6478BD642FULL, 0xE7037ED1A0B428DBULL,
+    0x8EBC6AF09C88C6E3ULL, 0x589965CC75374CC3ULL
+};
+
+static inline void multiply128(uint64_t& a, uint64_t& b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = __uint128_t(a) * b;
+    a = uint64_t(r);
+    b = uint64_t(r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t fold(uint64_t a, uint64_t b) {
+    multiply128(a, b);
+    return a ^ b;
+}
+
+static inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint64_t read3(const uint8_t* p, size_t k) {
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+uint64_t hashBytes(const void* data, size_t length) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t seed = hashSeed();
+    seed ^= fold(seed ^ SECRET[0], SECRET[1]);
+    uint64_t a, b;
+    if (length <= 16) {
+        if (length >= 4) {
+            size_t offset = (length >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + offset);
+            b = (read32(p + length - 4) << 32) | read32(p + length - 4 - offset);
+        } else if (length > 0) {
+            a = read3(p, length);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = length;
+        if (i > 48) {
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = fold(read64(p) ^ SECRET[1], read64(p + 8) ^ seed);
+                lane1 = fold(read64(p + 16) ^ SECRET[2], read64(p + 24) ^ lane1);
+                lane2 = fold(read64(p + 32) ^ SECRET[3], read64(p + 40) ^ lane2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (i > 16) {
+            seed = fold(read64(p) ^ SECRET[1], read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    a ^= SECRET[1];
+    b ^= seed;
+    multiply128(a, b);
+    return fold(a ^ SECRET[0] ^ length, b ^ SECRET[1]);
+}
+
+/*
+ * Implementation notes: hashCode64
+ * --------------------------------
+ * Floating-point keys are hashed by their bit patterns, after folding
+ * negative zero into positive zero so that keys that compare equal have
+ * equal hashes.
+ */
+
+uint64_t hashCode64(double key) {
+    if (key == 0)
+        key = 0;
+    uint64_t bits;
+    std::memcpy(&bits, &key, sizeof bits);
+    return hashMix(bits);
+}
+
+uint64_t hashCode64(float key) {
+    if (key == 0)
+        key = 0;
+    uint32_t bits;
+    std::memcpy(&bits, &key, sizeof bits);
+    return hashMix(bits);
+}
+
+uint64_t hashCode64(const char* str) {
+    return (str == nullptr) ? hashBytes("", 0) : hashBytes(str, std::strlen(str));
+}
+
+uint64_t hashCode64(const std::string& str) {
+    return hashBytes(str.data(), str.length());
+}
+
+uint64_t hashCode64(std::string_view str) {
+    return hashBytes(str.data(), str.length());
+}
+
 /*
  * Implementation notes: hashCode
  * ------------------------------
- * This function takes a string key and uses it to derive a hash code,
- * which is a nonnegative integer related to the key by a deterministic
- * function that distributes keys well across the space of integers.
- * The general method is called linear congruence, which is also used
- * in random-number generators.  The specific algorithm used here is
- * called djb2 after the initials of its inventor, Daniel J. Bernstein,
- * Professor of Mathematics at the University of Illinois at Chicago.
+ * Each of the int-valued hashCode functions returns the low-order bits
+ * of the corresponding 64-bit hash, masked to be nonnegative.
  */
 
 int hashCode(bool key) {
-    return (int)key;
+    return int(hashCode64(key) & HASH_MASK);
 }
 
 int hashCode(char key) {
-    return key;
+    return int(hashCode64(key) & HASH_MASK);
 }
 
 int hashCode(double key) {
-    char* byte = (char*)&key;
-    unsigned hash = HASH_SEED;
-    for (int i = 0; i < (int)sizeof(double); i++) {
-        hash = HASH_MULTIPLIER * hash + (int)*byte++;
-    }
-    return hash & HASH_MASK;
+    return int(hashCode64(key) & HASH_MASK);
 }
 
 int hashCode(float key) {
-    char* byte = (char*)&key;
-    unsigned hash = HASH_SEED;
-    for (int i = 0; i < (int)sizeof(float); i++) {
-        hash = HASH_MULTIPLIER * hash + (int)*byte++;
-    }
-    return hash & HASH_MASK;
+    return int(hashCode64(key) & HASH_MASK);
 }
 
 int hashCode(int key) {
-    return key & HASH_MASK;
+    return int(hashCode64(key) & HASH_MASK);
 }
 
 int hashCode(long key) {
-    return int(key) & HASH_MASK;
+    return int(hashCode64(key) & HASH_MASK);
 }
 
 int hashCode(const char* str) {
-    unsigned hash = HASH_SEED;
-    for (int i = 0; str && str[i] != 0; i++) {
-        hash = HASH_MULTIPLIER * hash + str[i];
-    }
-    return int(hash & HASH_MASK);
+    return int(hashCode64(str) & HASH_MASK);
 }
 
 int hashCode(const std::string& str) {
-    unsigned hash = HASH_SEED;
-    int n = str.length();
-    for (int i = 0; i < n; i++) {
-        hash = HASH_MULTIPLIER * hash + str[i];
-    }
-    return int(hash & HASH_MASK);
-}
-
-int hashCode(uintptr_t key) {
-    return hashCode(static_cast<long>(key));
+    return int(hashCode64(str) & HASH_MASK);
 }
 
 int hashCode(void* key) {
-    return hashCode(reinterpret_cast<uintptr_t>(key));
+    return int(hashCode64(key) & HASH_MASK);
 }
@@ -1,66 +0,0 @@
-/*
- * File: hashmap.cpp
- * -----------------
- * This file contains the hash functions that are used in conjunction
- * with the HashMap class.
- */
-
-/*************************************************************************/
-/* Stanford Portable Library                                             */
-/* Copyright (c) 2014 by Eric Roberts <eroberts@cs.stanford.edu>         */
-/*                                                                       */
-/* This program is free software: you can redistribute it and/or modify  */
-/* it under the terms of the GNU General Public License as published by  */
-/* the Free Software Foundation, either version 3 of the License, or     */
-/* (at your option) any later version.                                   */
-/*                                                                       */
-/* This program is distributed in the hope that it will be useful,       */
-/* but WITHOUT ANY WARRANTY; without even the implied warranty of        */
-/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
-/* GNU General Public License for more details.                          */
-/*                                                                       */
-/* You should have received a copy of the GNU General Public License     */
-/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
-/*************************************************************************/
-
-#include "hashmap.h"
-
-#include <iostream>
-#include <string>
-
-/*
- * Implementation notes: hashCode
- * ------------------------------
- * This function takes a string key and uses it to derive a hash code,
- * which is a nonnegative integer related to the key by a deterministic
- * function that distributes keys well across the space of integers.
- * The general method is called linear congruence, which is also used
- * in random-number generators.  The specific algorithm used here is
- * called djb2 after the initials of its inventor, Daniel J. Bernstein,
- * Professor of Mathematics at the University of Illinois at Chicago.
- */
-
-const int HASH_SEED = 5381;              /* Starting point for first cycle */
-const int HASH_MULTIPLIER = 33;          /* Multiplier for each cycle      */
-const int HASH_MASK = unsigned(-1) >> 1; /* All 1 bits except the sign     */
-
-int hashCode(const std::string& str) {
-    unsigned hash = HASH_SEED;
-    int n = str.length();
-    for (int i = 0; i < n; i++) {
-        hash = HASH_MULTIPLIER * hash + str[i];
-    }
-    return int(hash & HASH_MASK);
-}
-
-int hashCode(int key) {
-    return key & HASH_MASK;
-}
-
-int hashCode(char key) {
-    return key;
-}
-
-int hashCode(long key) {
-    return int(key) & HASH_MASK;
-}
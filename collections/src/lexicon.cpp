@@ -32,6 +32,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "compare.h"
 #include "dawglexicon.h"
@@ -59,6 +60,13 @@ Lexicon::Lexicon(const Lexicon& src) {
     deepCopy(src);
 }
 
+Lexicon::Lexicon(Lexicon&& src) : m_allWords(std::move(src.m_allWords)) {
+    m_root = src.m_root;
+    m_size = src.m_size;
+    src.m_root = NULL;
+    src.m_size = 0;
+}
+
 Lexicon::~Lexicon() {
     clear();
 }
@@ -97,26 +105,18 @@ void Lexicon::clear() {
     m_root = NULL;
 }
 
-bool Lexicon::contains(const std::string& word) const {
+bool Lexicon::contains(std::string_view word) const {
     if (word.empty()) {
         return false;
     }
-    std::string scrubbed = word;
-    if (!scrub(scrubbed)) {
-        return false;
-    }
-    return containsHelper(m_root, scrubbed, /* isPrefix */ false);
+    return containsHelper(m_root, word, /* isPrefix */ false);
 }
 
-bool Lexicon::containsPrefix(const std::string& prefix) const {
+bool Lexicon::containsPrefix(std::string_view prefix) const {
     if (prefix.empty()) {
         return true;
     }
-    std::string scrubbed = prefix;
-    if (!scrub(scrubbed)) {
-        return false;
-    }
-    return containsHelper(m_root, scrubbed, /* isPrefix */ true);
+    return containsHelper(m_root, prefix, /* isPrefix */ true);
 }
 
 bool Lexicon::equals(const Lexicon& lex2) const {
@@ -242,22 +242,30 @@ bool Lexicon::addHelper(TrieNode*& node, const std::string& word, const std::str
     }
 }
 
-// pre: word is scrubbed to contain only lowercase a-z letters
-bool Lexicon::containsHelper(TrieNode* node, const std::string& word, bool isPrefix) const {
+// word need not be scrubbed: each letter is folded to lowercase as the
+// trie is walked, and any other character ends the search, so the lookup
+// never copies the word
+bool Lexicon::containsHelper(TrieNode* node, std::string_view word, bool isPrefix) const {
+    for (char ch : word) {
+        if (node == NULL) {
+            // no pointer down to here, so prefix must not exist
+            return false;
+        }
+        ch = tolower((unsigned char)ch);
+        if (ch < 'a' || ch > 'z') {
+            return false;  // illegal string
+        }
+        node = node->child(ch);
+    }
     if (node == NULL) {
-        // base case: no pointer down to here, so prefix must not exist
         return false;
-    } else if (word.length() == 0) {
-        // base case: Found nodes all the way down.
-        // If we are looking for a prefix, this means this path IS a prefix,
-        // so we should return true.
-        // If we are looking for an exact word match rather than a prefix,
-        // we must check the isWord flag to see that this word was added
-        return (isPrefix ? true : node->isWord());
-    } else {
-        // recursive case: follow appropriate child pointer for one letter
-        return containsHelper(node->child(word[0]), word.substr(1), isPrefix);
     }
+    // Found nodes all the way down.
+    // If we are looking for a prefix, this means this path IS a prefix,
+    // so we should return true.
+    // If we are looking for an exact word match rather than a prefix,
+    // we must check the isWord flag to see that this word was added
+    return (isPrefix ? true : node->isWord());
 }
 
 // pre: word is scrubbed to contain only lowercase a-z letters
@@ -342,6 +350,18 @@ Lexicon& Lexicon::operator=(const Lexicon& src) {
     return *this;
 }
 
+Lexicon& Lexicon::operator=(Lexicon&& src) {
+    if (this != &src) {
+        clear();
+        m_root = src.m_root;
+        m_size = src.m_size;
+        m_allWords = std::move(src.m_allWords);
+        src.m_root = NULL;
+        src.m_size = 0;
+    }
+    return *this;
+}
+
 std::ostream& operator<<(std::ostream& out, const Lexicon& lex) {
     out << lex.m_allWords;
     return out;
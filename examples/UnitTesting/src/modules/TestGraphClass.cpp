@@ -22,11 +22,14 @@
 /* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
 /*************************************************************************/
 
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <string>
 
 #include "graph.h"
+#include "graphreader.h"
+#include "shortestpath.h"
 #include "strlib.h"
 #include "tokenscanner.h"
 #include "unittest.h"
@@ -99,22 +102,37 @@ static void createMyGraph(MyGraph& g);
 static void addArc(MyGraph& g, string start, string finish, double cost);
 static void testBasicMethods(MyGraph& g);
 static void testStringConversion(MyGraph& g);
+static void testNodeIds(MyGraph& g);
+static void testCompactGraph(MyGraph& g);
+static void testShortestPaths(MyGraph& g);
+static double zeroHeuristic(MyNode* node);
+static void testGraphReader(MyGraph& g);
 static void testDeletionMethods(MyGraph& g);
 static void deleteArcsWithCost(MyGraph& g, double cost);
 static void testStructureMatch(MyGraph& g1, MyGraph& g2);
 static string toString(Set<MyNode*> nodes);
 static string toString(Set<MyArc*> arcs);
+static string toString(MyGraph::NeighborView view);
+static string toString(Vector<MyArc*> path);
+template <typename ValueType>
+static string toString(GraphSpan<ValueType> span);
 
 void testGraphClass() {
     reportMessage("MyGraph g;");
     MyGraph g;
     createMyGraph(g);
     testBasicMethods(g);
+    testNodeIds(g);
     testStringConversion(g);
+    testCompactGraph(g);
+    testShortestPaths(g);
+    testGraphReader(g);
     testDeletionMethods(g);
     reportMessage("MyGraph gcopy = g;");
     MyGraph gcopy = g;
     trace(testStructureMatch(g, gcopy));
+    test(gcopy.getId("n3"), g.getId("n3"));
+    test(gcopy.getId("n5"), g.getId("n5"));
     reportResult("Graph class");
 }
 
@@ -198,7 +216,121 @@ static void testStringConversion(MyGraph& g) {
     testBasicMethods(g2);
 }
 
+static void testNodeIds(MyGraph& g) {
+    test(g.getId("n1"), 0);
+    test(g.getId("n4"), 3);
+    test(g.getId("n5"), -1);
+    test(g.getId(g.getNode("n2")), 1);
+    test(g.getNode(2)->name, "n3");
+    test(g.getNode(4) == nullptr, true);
+    test(g.idLimit(), 4);
+    test(g.getNeighborView("n1").size(), 3);
+    test(toString(g.getNeighborView("n1")), "{ n2, n3, n3 }");
+    test(toString(g.getNeighborView("n4")), "{ }");
+}
+
+static void testCompactGraph(MyGraph& g) {
+    typedef CompactGraph<MyNode, MyArc> MyCompactGraph;
+    declare(MyCompactGraph csr = g.freeze());
+    test(csr.size(), 4);
+    test(csr.arcCount(), 5);
+    test(csr.getId("n1"), 0);
+    test(csr.getId("n4"), 3);
+    test(csr.getId("n5"), -1);
+    test(csr.getId(g.getNode("n3")), 2);
+    test(csr.getNode(1)->name, "n2");
+    test(csr.degree(0), 3);
+    test(csr.degree(3), 0);
+    test(toString(csr.neighbors(0)), "{ 1, 2, 2 }");
+    test(toString(csr.costs(0)), "{ 1, 3, 4 }");
+    test(toString(csr.neighbors(1)), "{ 1 }");
+    test(toString(csr.neighbors(3)), "{ }");
+    test(csr.arcs(2)[0]->cost, 5);
+    test(csr.getOffsets().size(), 5);
+    test(csr.getOffsets()[2], 4);
+    test(csr.getTargets()[3], 1);
+    test(csr.getCosts()[4], 5);
+#ifndef SPL_UNCHECKED_INDEXING
+    checkError(csr.neighbors(4), "CompactGraph::neighbors: Node id 4 out of range");
+#endif
+    declare(MyCompactGraph empty);
+    test(empty.size(), 0);
+    test(empty.getOffsets().size(), 1);
+    declare(MyCompactGraph rev = csr.reversed());
+    test(toString(rev.neighbors(2)), "{ 0, 0 }");
+    test(toString(rev.neighbors(1)), "{ 0, 1 }");
+    test(rev.arcs(3)[0]->cost, 5);
+    test(csr.parallelBreadthFirstSearch(0).toString(), "{0, 1, 1, 2}");
+    test(csr.parallelBreadthFirstSearch(3).toString(), "{-1, -1, -1, 0}");
+    test(csr.parallelConnectedComponents().toString(), "{0, 0, 0, 0}");
+    declare(Vector<double> rank = csr.parallelPageRank());
+    test(rank[0] < rank[2], true);
+    test(rank[2] < rank[3], true);
+    test(fabs(rank[0] + rank[1] + rank[2] + rank[3] - 1) < 1e-12, true);
+}
+
+static void testShortestPaths(MyGraph& g) {
+    typedef ShortestPaths<MyNode, MyArc> MyShortestPaths;
+    MyNode* n1 = g.getNode("n1");
+    MyNode* n2 = g.getNode("n2");
+    MyNode* n4 = g.getNode("n4");
+    declare(MyShortestPaths paths(g));
+    test(toString(paths.findPath(n1, n4)), "{ n1->n3 (3), n3->n4 (5) }");
+    test(paths.getDistance(n4), 8);
+    test(toString(paths.findPath(n1, n4, zeroHeuristic)), "{ n1->n3 (3), n3->n4 (5) }");
+    test(toString(paths.findPathBidirectional(n1, n4)), "{ n1->n3 (3), n3->n4 (5) }");
+    test(paths.getDistance(n4), 8);
+    test(toString(paths.findPath(n4, n1)), "{ }");
+    test(paths.getDistance(n1) > 1e300, true);
+    test(toString(paths.findPathBidirectional(n2, n2)), "{ }");
+    test(paths.getDistance(n2), 0);
+    trace(paths.searchFrom(n1));
+    test(paths.getDistance(n2), 1);
+    test(toString(paths.getPath(n4)), "{ n1->n3 (3), n3->n4 (5) }");
+    trace(paths.searchFrom(n1, 4));
+    test(paths.getDistance(n4) > 1e300, true);
+    test(paths.getSettledCount(), 3);
+}
+
+static double zeroHeuristic(MyNode*) {
+    return 0;
+}
+
+static void testGraphReader(MyGraph& g) {
+    typedef GraphReader<MyNode, MyArc> MyGraphReader;
+    typedef CompactGraph<MyNode, MyArc> MyCompactGraph;
+    string text = "{n4, n3 -> n4 5, n1 -> n2 1, n2 -> n2 2, n1 -> n3 4, n1 -> n3 3}";
+    declare(MyGraphReader reader);
+    declare(istringstream iss(text));
+    declare(MyGraph g2);
+    trace(reader.read(iss, g2));
+    testBasicMethods(g2);
+    test(g2.getId("n1"), 0);
+    test(g2.getId("n4"), 3);
+    test(toString(g2.getArcSet()), toString(g.getArcSet()));
+    declare(istringstream iss2(text));
+    declare(MyCompactGraph csr = reader.readCompact(iss2));
+    test(csr.size(), 4);
+    test(csr.getNode(0)->name, "n1");
+    test(toString(csr.neighbors(0)), "{ 1, 2, 2 }");
+    test(toString(csr.costs(0)), "{ 1, 3, 4 }");
+    test(csr.arcs(2)[0]->finish == csr.getNode(3), true);
+    test(csr.reversed().getNode(2)->name, "n3");
+    declare(MyGraphReader edges(EDGE_LIST));
+    declare(istringstream iss3("# comment\nn1 n2 1\nn2 n1\n\nn5\n"));
+    trace(edges.read(iss3, g2));
+    test(toString(g2.getNodeSet()), "{ n1, n2, n5 }");
+    test(toString(g2.getArcSet()), "{ n1->n2, n2->n1 }");
+    test(g2.isConnected("n2", "n1"), true);
+    declare(istringstream iss4("{n1 -> }"));
+    checkError(reader.read(iss4, g2), "GraphReader: Missing node name on line 1");
+    test(g2.size(), 3);
+    declare(istringstream iss5("n1 n2 x"));
+    checkError(edges.read(iss5, g2), "GraphReader: Illegal cost x on line 1");
+}
+
 static void testDeletionMethods(MyGraph& g) {
+    typedef CompactGraph<MyNode, MyArc> MyCompactGraph;
     trace(g.removeNode("n2"));
     test(g.size(), 3);
     test(toString(g.getNodeSet()), "{ n1, n3, n4 }");
@@ -208,6 +340,31 @@ static void testDeletionMethods(MyGraph& g) {
     trace(deleteArcsWithCost(g, 4));
     test(toString(g.getArcSet()), "{ n1->n3, n3->n4 }");
     test(toString(g.getArcSet("n1")), "{ n1->n3 }");
+    test(g.isConnected("n1", "n3"), true);
+    test(g.getNode("n2") == nullptr, true);
+    test(g.getId("n2"), -1);
+    test(g.getNode(1) == nullptr, true);
+    test(g.idLimit(), 4);
+    declare(MyCompactGraph holes = g.freeze());
+    test(holes.size(), 3);
+    test(holes.idLimit(), 4);
+    test(holes.getNode(1) == nullptr, true);
+    test(holes.getId("n4"), g.getId("n4"));
+    test(holes.parallelBreadthFirstSearch(0).toString(), "{0, -1, 1, 2}");
+    test(holes.parallelConnectedComponents().toString(), "{0, -1, 0, 0}");
+    declare(Vector<double> rank = holes.parallelPageRank());
+    test(rank[1], 0);
+    test(fabs(rank[0] + rank[2] + rank[3] - 1) < 1e-12, true);
+    trace(g.addNode("n5"));
+    test(g.getId("n5"), 1);
+    trace(g.removeArc("n1", "n3"));
+    test(g.isConnected("n1", "n3"), false);
+    test(toString(g.getArcSet()), "{ n3->n4 }");
+    declare(MyCompactGraph csr = g.freeze());
+    test(csr.getId("n5"), 1);
+    test(csr.getId(g.getNode("n3")), g.getId("n3"));
+    test(csr.getNode(g.getId("n4"))->name, "n4");
+    test(toString(csr.neighbors(g.getId("n3"))), "{ 3 }");
 }
 
 static void deleteArcsWithCost(MyGraph& g, double cost) {
@@ -283,6 +440,43 @@ static string toString(Set<MyNode*> nodes) {
     return str;
 }
 
+template <typename ValueType>
+static string toString(GraphSpan<ValueType> span) {
+    ostringstream os;
+    os << "{";
+    for (int i = 0; i < span.size(); i++) {
+        if (i > 0)
+            os << ",";
+        os << " " << span[i];
+    }
+    os << " }";
+    return os.str();
+}
+
+static string toString(MyGraph::NeighborView view) {
+    string str = "{";
+    for (MyNode* node : view) {
+        if (str.length() > 1)
+            str += ",";
+        str += " " + node->name;
+    }
+    str += " }";
+
+    return str;
+}
+
+static string toString(Vector<MyArc*> path) {
+    string str = "{";
+    for (MyArc* arc : path) {
+        if (str.length() > 1)
+            str += ",";
+        str += " " + arc->start->name + "->" + arc->finish->name + " (" + realToString(arc->cost) + ")";
+    }
+    str += " }";
+
+    return str;
+}
+
 static string toString(Set<MyArc*> arcs) {
     string str = "{";
 
@@ -22,18 +22,25 @@
 /* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
 /*************************************************************************/
 
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <string>
 
 #include "grid.h"
+#include "parallelgrid.h"
 #include "strlib.h"
+#include "threadpool.h"
 #include "unittest.h"
 using namespace std;
 
 static void testGridCopy(Grid<double>& grid, Grid<double> gridByValue);
 static string gridSignature(Grid<double>& grid);
 static Grid<double> createIdentityMatrix(int n);
+static void testViews();
+static void testParallelOperations();
+static int lifeRule(const int (&window)[3][3]);
+static int crossSum(int center, int north, int south, int west, int east);
 
 class SumFunctor {
 public:
@@ -84,9 +91,93 @@ void testGridClass() {
     declare(istringstream ss("{{1, 2, 3}, {4, 5, 6}}"));
     trace(ss >> matrix);
     test(matrix.toString(), "{{1, 2, 3}, {4, 5, 6}}");
+    test(matrix.at_unchecked(1, 2), 6);
+    trace(matrix.at_unchecked(1, 0) = 9);
+    test(matrix[1][0], 9);
+    declare(const Grid<double>& constMatrix = matrix);
+    test(constMatrix[1][0], 9);
+#ifndef SPL_UNCHECKED_INDEXING
+    checkError(matrix[2][0], "Grid index values out of range");
+    checkError(matrix.set(0, 3, 1), "set: Grid indices out of bounds");
+#endif
+    testViews();
+    testParallelOperations();
     reportResult("Grid class");
 }
 
+/* Test data, row spans, subgrid views, and the bulk operations */
+
+static void testViews() {
+    declare(Grid<int> grid(3, 4));
+    for (int i = 0; i < 12; i++) {
+        grid.data()[i] = i;
+    }
+    test(grid[2][1], 9);
+    declare(GridSpan<int> row = grid.row(1));
+    test(row.size(), 4);
+    test(row[0], 4);
+    trace(for (int& x : row) x *= 10);
+    test(grid.toString(), "{{0, 1, 2, 3}, {40, 50, 60, 70}, {8, 9, 10, 11}}");
+    declare(GridView<int> corner = grid.subgrid(1, 2, 2, 2));
+    test(corner.numRows(), 2);
+    test(corner.stride(), 4);
+    test(corner[1][0], 10);
+    trace(corner.fill(-1));
+    test(grid.toString(), "{{0, 1, 2, 3}, {40, 50, -1, -1}, {8, 9, -1, -1}}");
+    trace(grid.subgrid(1, 1, 2, 3).copyFrom(grid.subgrid(0, 0, 2, 3)));
+    test(grid.toString(), "{{0, 1, 2, 3}, {40, 0, 1, 2}, {8, 40, 50, -1}}");
+    trace(grid.subgrid(0, 0, 2, 2).copyFrom(grid.subgrid(1, 1, 2, 2)));
+    test(grid.toString(), "{{0, 1, 2, 3}, {40, 50, 1, 2}, {8, 40, 50, -1}}");
+    declare(const Grid<int>& constGrid = grid);
+    declare(GridView<const int> whole = constGrid.subgrid(0, 0, 3, 4));
+    test(whole.row(2)[3], -1);
+    trace(grid.fill(7));
+    test(constGrid.row(0)[0], 7);
+    checkError(grid.subgrid(2, 2, 2, 2), "subgrid: Region is not inside the grid");
+    checkError(grid.row(3), "row: Grid row out of bounds");
+}
+
+/* Test the parallel operations and stencil sweeps on a multithreaded pool */
+
+static void testParallelOperations() {
+    declare(ThreadPool pool(4));
+    test(pool.size(), 4);
+    declare(Grid<int> life(300, 300));
+    trace(life[100][99] = life[100][100] = life[100][101] = 1);
+    trace(life[299][0] = life[299][1] = life[298][0] = 1);
+    declare(Grid<int> next);
+    trace(neighbors8(life, next, lifeRule, 0, pool));
+    test(next[99][100] + next[100][100] + next[101][100], 3);
+    test(next[100][99] + next[100][101], 0);
+    test(next[299][0] + next[299][1] + next[298][0] + next[298][1], 4);
+    declare(atomic<long> total(0));
+    trace(parallelMapAll(next, [&total](int x) { total += x; }, pool));
+    test(total == 7, true);
+    trace(parallelTransform(next, [](int x) { return x * 5; }, pool));
+    test(next[298][1], 5);
+    declare(Grid<int> sums);
+    trace(neighbors4(next, sums, crossSum, 1, pool));
+    test(sums[0][0], 2);
+    test(sums[100][100], 15);
+    test(sums[299][299], 2);
+    checkError(neighbors4(next, next, crossSum), "neighbors4: Destination must be a different grid");
+}
+
+static int lifeRule(const int (&window)[3][3]) {
+    int n = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            n += window[i][j];
+        }
+    }
+    n -= window[1][1];
+    return (n == 3 || (n == 2 && window[1][1] == 1)) ? 1 : 0;
+}
+
+static int crossSum(int center, int north, int south, int west, int east) {
+    return center + north + south + west + east;
+}
+
 /* Sample code from the Grid interface */
 
 static Grid<double> createIdentityMatrix(int n) {
@@ -79,6 +79,13 @@ static void testCharSet() {
     test(consonants.isSubsetOf(mySet), true);
     test(mySet == consonants, true);
     test(charString(highPointTiles * descenders), "jq");
+    test(charString(descenders * highPointTiles), "jq");
+    test(charString(vowels + lcletters), "abcdefghijklmnopqrstuvwxyz");
+    test(charString(lcletters - descenders - vowels), "bcdfhklmnrstvwxz");
+    test(lcletters.isSubsetOf(vowels), false);
+    trace(mySet = lcletters);
+    trace(mySet *= vowels);
+    test(mySet == vowels, true);
     testCommaOperator();
     testSetCopy(consonants, consonants);
     testSetCopy(empty, empty);
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #include "hashmap.h"
 #include "strlib.h"
@@ -35,6 +36,11 @@ using namespace std;
 
 static void testInsertionOperator(HashMap<string, string>& elements, string pattern);
 static void testExtractionOperator();
+static void testLargeMap();
+static void testIncrementalRehash();
+static void testMoveAndEmplace();
+static void testHashFunctions();
+static void testLookupKeys();
 static void testMapCopy(HashMap<string, string>& map, HashMap<string, string> mapByValue);
 static void markElement(string name, int& elementBitSet, string& str);
 
@@ -95,6 +101,11 @@ void testHashMapClass() {
     test(elements.toString(), "{" + pattern + "}");
     testInsertionOperator(elements, pattern);
     testExtractionOperator();
+    testLargeMap();
+    testIncrementalRehash();
+    testMoveAndEmplace();
+    testHashFunctions();
+    testLookupKeys();
     reportResult("HashMap class");
 }
 
@@ -177,3 +188,148 @@ static void testExtractionOperator() {
     test(map["two"], 2);
     test(map["three"], 3);
 }
+
+/* Test growth, tombstones, and reuse of the open-addressing table */
+
+static void testLargeMap() {
+    reportMessage("HashMap<int,int> squares;");
+    HashMap<int, int> squares;
+    for (int i = 0; i < 10000; i++) {
+        squares.put(i, i * i);
+    }
+    test(squares.size(), 10000);
+    test(squares.get(9999), 99980001);
+    for (int i = 0; i < 10000; i += 2) {
+        squares.remove(i);
+    }
+    test(squares.size(), 5000);
+    test(squares.containsKey(5000), false);
+    test(squares.containsKey(5001), true);
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 10000; i += 2) {
+            squares[i] = -i;
+        }
+        for (int i = 0; i < 10000; i += 2) {
+            squares.remove(i);
+        }
+    }
+    test(squares.size(), 5000);
+    declare(long total = 0);
+    for (int key : squares) {
+        total += key;
+    }
+    test(int(total), 25000000);
+    reportMessage("HashMap<int,int> copy = squares;");
+    HashMap<int, int> copy = squares;
+    test(copy.size(), 5000);
+    test(copy.get(4999), 4999 * 4999);
+    trace(squares.clear());
+    test(squares.size(), 0);
+    test(squares.containsKey(1), false);
+    test(copy.containsKey(1), true);
+    trace(copy.reserve(20000));
+    test(copy.size(), 5000);
+    test(copy.get(4999), 4999 * 4999);
+}
+
+/* Test lookups, removals, and copies while a rehash is in progress */
+
+static void testIncrementalRehash() {
+    reportMessage("HashMap<string,int> map;");
+    HashMap<string, int> map;
+    trace(map.setIncrementalRehash(true));
+    declare(bool allFound = true);
+    for (int i = 0; i < 5000; i++) {
+        map.put(integerToString(i), i);
+        if (!map.containsKey(integerToString(i / 2)))
+            allFound = false;
+    }
+    test(allFound, true);
+    test(map.size(), 5000);
+    for (int i = 0; i < 5000; i += 3) {
+        map.remove(integerToString(i));
+    }
+    test(map.size(), 3333);
+    test(map.containsKey("3"), false);
+    test(map.get("4"), 4);
+    reportMessage("HashMap<string,int> copy = map;");
+    HashMap<string, int> copy = map;
+    declare(int count = 0);
+    for (string key : copy) {
+        if (copy.get(key) == stringToInteger(key))
+            count++;
+    }
+    test(count, 3333);
+    trace(map.setIncrementalRehash(false));
+    test(map.size(), 3333);
+    test(map.get("4998"), 0);
+    test(map.get("4999"), 4999);
+}
+
+/* Test move operations and tryEmplace */
+
+static void testMoveAndEmplace() {
+    reportMessage("HashMap<string,string> map;");
+    HashMap<string, string> map;
+    test(map.tryEmplace("H", "Hydrogen"), true);
+    test(map.tryEmplace("He", 6, 'x'), true);
+    test(map.tryEmplace("H", "Helium"), false);
+    test(map["H"], "Hydrogen");
+    test(map["He"], "xxxxxx");
+    reportMessage("HashMap<string,string> moved = std::move(map);");
+    HashMap<string, string> moved = std::move(map);
+    test(moved.size(), 2);
+    test(moved.get("H"), "Hydrogen");
+    test(map.size(), 0);
+    test(map.containsKey("H"), false);
+    trace(map.put("Li", "Lithium"));
+    test(map.toString(), "{Li:Lithium}");
+    trace(map = std::move(moved));
+    test(map.size(), 2);
+    test(map.get("He"), "xxxxxx");
+    test(moved.isEmpty(), true);
+}
+
+/* Test the 64-bit hash functions and keys that rely on them */
+
+static void testHashFunctions() {
+    test(hashCode64(string("hydrogen")) == hashCode64("hydrogen"), true);
+    test(hashCode64(string("hydrogen")) == hashCode64(string("hydrogem")), false);
+    test(hashCode64(0.0) == hashCode64(-0.0), true);
+    test(hashCode64(1L) == hashCode64(2L), false);
+    test(hashCode64(make_pair(1, 2)) == hashCode64(make_pair(2, 1)), false);
+    test(hashCode64(make_tuple(1, string("a"))) == hashCode64(make_tuple(1, string("a"))), true);
+    test(hashCode(-1) >= 0, true);
+    string longKey(100, 'x');
+    declare(uint64_t hash = hashCode64(longKey));
+    trace(longKey[99] = 'y');
+    test(hashCode64(longKey) == hash, false);
+    reportMessage("HashMap<pair<int,int>,int> map;");
+    HashMap<pair<int, int>, int> map;
+    for (int i = 0; i < 100; i++) {
+        map.put(make_pair(i, i * i), i);
+    }
+    test(map.size(), 100);
+    test(map.get(make_pair(7, 49)), 7);
+    test(map.containsKey(make_pair(49, 7)), false);
+}
+
+/* Test lookups by string_view and C strings */
+
+static void testLookupKeys() {
+    reportMessage("HashMap<string,int> map;");
+    HashMap<string, int> map;
+    trace(map.put("H", 1));
+    trace(map.put("He", 2));
+    declare(string_view view = "Helium");
+    test(hashCode64(view.substr(0, 2)) == hashCode64(string("He")), true);
+    test(map.get(view.substr(0, 2)), 2);
+    test(map.containsKey(view.substr(0, 3)), false);
+    test(map.containsKey("H"), true);
+    trace(map[view.substr(0, 3)] = 3);
+    test(map.get("Hel"), 3);
+    test(map.size(), 3);
+    trace(map.remove(string_view("H")));
+    test(map.containsKey("H"), false);
+    test(map.size(), 2);
+}
@@ -24,6 +24,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 
 #include "filelib.h"
 #include "lexicon.h"
@@ -87,6 +88,10 @@ static void testSetLexicon() {
     test(lexicon.contains("three"), true);
     test(lexicon.contains("nine"), false);
     test(lexicon.containsPrefix("tw"), true);
+    test(lexicon.contains("ThReE"), true);
+    test(lexicon.contains(string_view("threefold").substr(0, 5)), true);
+    test(lexicon.contains("thr3e"), false);
+    test(lexicon.containsPrefix(string_view("SEV")), true);
     declare(Lexicon::iterator iter = lexicon.begin());
     test(iter == lexicon.begin(), true);
     test(iter == lexicon.end(), false);
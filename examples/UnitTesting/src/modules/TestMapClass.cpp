@@ -25,8 +25,11 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 
+#include "flatmap.h"
 #include "map.h"
+#include "set.h"
 #include "unittest.h"
 using namespace std;
 
@@ -35,6 +38,11 @@ using namespace std;
 static void testInsertionOperator(Map<string, string>& elements, string pattern);
 static void testExtractionOperator();
 static void testMapCopy(Map<string, string>& map, Map<string, string> mapByValue);
+static void testMoveAndEmplace();
+static void testLookupKeys();
+static void testNodeHandles();
+static void testRangeQueries();
+static void testFlatMap();
 
 class AppendKeyValueFunctor {
 public:
@@ -87,9 +95,37 @@ void testMapClass() {
     test(elements.toString(), "{Be:Beryllium, H:Hydrogen, He:Helium, Li:Lithium}");
     testInsertionOperator(elements, "Be:Beryllium, H:Hydrogen, He:Helium, Li:Lithium");
     testExtractionOperator();
+    testMoveAndEmplace();
+    testLookupKeys();
+    testNodeHandles();
+    testRangeQueries();
+    testFlatMap();
     reportResult("Map class");
 }
 
+/* Test move operations and tryEmplace */
+
+static void testMoveAndEmplace() {
+    reportMessage("Map<string,string> map;");
+    Map<string, string> map;
+    test(map.tryEmplace("H", "Hydrogen"), true);
+    test(map.tryEmplace("He", 6, 'x'), true);
+    test(map.tryEmplace("H", "Helium"), false);
+    test(map["H"], "Hydrogen");
+    test(map["He"], "xxxxxx");
+    trace(map.put("He", string("Helium")));
+    test(map["He"], "Helium");
+    reportMessage("Map<string,string> moved = std::move(map);");
+    Map<string, string> moved = std::move(map);
+    test(moved.size(), 2);
+    test(map.size(), 0);
+    trace(map.put("Li", "Lithium"));
+    test(map.toString(), "{Li:Lithium}");
+    trace(map = std::move(moved));
+    test(map.toString(), "{H:Hydrogen, He:Helium}");
+    test(moved.isEmpty(), true);
+}
+
 /* Test copy constructor and assignment operator */
 
 static void testMapCopy(Map<string, string>& map, Map<string, string> mapByValue) {
@@ -142,3 +178,133 @@ static void testExtractionOperator() {
     test(map["two"], 2);
     test(map["three"], 3);
 }
+
+/* Test lookups by string_view and C strings */
+
+static void testLookupKeys() {
+    reportMessage("Map<string,int> map;");
+    Map<string, int> map;
+    trace(map.put("H", 1));
+    trace(map.put("He", 2));
+    trace(map.put("Li", 3));
+    declare(string_view view = "Helium");
+    test(map.get(view.substr(0, 2)), 2);
+    test(map.containsKey(view.substr(0, 3)), false);
+    test(map.containsKey("Li"), true);
+    trace(map.remove(string_view("H")));
+    test(map.toString(), "{He:2, Li:3}");
+    trace(map.remove("Be"));
+    test(map.size(), 2);
+    reportMessage("Map<string,int> reversed(std::greater<string>());");
+    Map<string, int> reversed((std::greater<string>()));
+    trace(reversed.put("a", 1));
+    trace(reversed.put("b", 2));
+    test(reversed.get(string_view("b")), 2);
+    test(reversed.containsKey("c"), false);
+    test(reversed.toString(), "{b:2, a:1}");
+}
+
+/* Test moving nodes between maps with extract and insert */
+
+static void testNodeHandles() {
+    reportMessage("Map<string,int> src, dst;");
+    Map<string, int> src, dst;
+    trace(src.put("H", 1));
+    trace(src.put("He", 2));
+    trace(src.put("Li", 3));
+    trace(dst.put("He", 20));
+    typedef Map<string, int>::NodeHandle NodeHandle;
+    declare(NodeHandle nh = src.extract("H"));
+    test(nh.isEmpty(), false);
+    test(nh.key(), "H");
+    test(nh.value(), 1);
+    test(src.containsKey("H"), false);
+    test(dst.insert(std::move(nh)), true);
+    test(nh.isEmpty(), true);
+    test(src.extract("Be").isEmpty(), true);
+    trace(nh = src.extract("He"));
+    test(dst.insert(std::move(nh)), false);
+    test(nh.value(), 2);
+    trace(src.clear());
+    test(nh.key(), "He");
+    test(src.insert(std::move(nh)), true);
+    test(src.toString(), "{He:2}");
+    test(dst.toString(), "{H:1, He:20}");
+    reportMessage("Set<int> odd, even;");
+    Set<int> odd, even;
+    trace(odd += 1);
+    trace(odd += 2);
+    trace(odd += 3);
+    trace(even.insert(odd.extract(2)));
+    test(odd.toString(), "{1, 3}");
+    test(even.toString(), "{2}");
+}
+
+/* Test reverse iteration and the range queries */
+
+static void testRangeQueries() {
+    typedef Map<int, string>::iterator Iterator;
+    reportMessage("Map<int,string> map;");
+    Map<int, string> map;
+    trace(map.put(10, "ten"));
+    trace(map.put(20, "twenty"));
+    trace(map.put(30, "thirty"));
+    trace(map.put(40, "forty"));
+    declare(string keys);
+    for (Map<int, string>::reverse_iterator it = map.rbegin(); it != map.rend(); ++it) {
+        keys += to_string(*it) + " ";
+    }
+    test(keys, "40 30 20 10 ");
+    declare(Iterator it = map.end());
+    trace(--it);
+    test(*it, 40);
+    test(*map.lowerBound(20), 20);
+    test(*map.upperBound(20), 30);
+    test(*map.floor(25), 20);
+    test(*map.ceiling(25), 30);
+    test(map.floor(5) == map.end(), true);
+    test(map.lowerBound(45) == map.end(), true);
+    trace(keys = "");
+    for (it = map.lowerBound(15); it != map.upperBound(30); it++) {
+        keys += map[*it] + " ";
+    }
+    test(keys, "twenty thirty ");
+    trace(it = map.lowerBound(30));
+    trace(map.remove(20));
+    trace(map.put(35, "thirty-five"));
+    test(*--it, 10);
+}
+
+/* Test freezing a map into a FlatMap */
+
+static void testFlatMap() {
+    reportMessage("Map<string,int> map;");
+    Map<string, int> map;
+    trace(map.put("Li", 3));
+    trace(map.put("H", 1));
+    trace(map.put("He", 2));
+    reportMessage("FlatMap<string,int> flat(map);");
+    FlatMap<string, int> flat(map);
+    test(flat.size(), 3);
+    test(flat.toString(), "{H:1, He:2, Li:3}");
+    test(flat.get("He"), 2);
+    test(flat.get(string_view("Helium").substr(0, 2)), 2);
+    test(flat.containsKey("Be"), false);
+    test(*flat.lowerBound("Hf"), "Li");
+    test(*flat.floor("Hf"), "He");
+    test(flat.upperBound("Li") == flat.end(), true);
+    trace(flat.put("Be", 4));
+    trace(flat["H"] = 10);
+    trace(flat.remove("Li"));
+    test(flat.toString(), "{Be:4, H:10, He:2}");
+    test(*flat.rbegin(), "He");
+    reportMessage("Map<int,string> reversed(std::greater<int>());");
+    Map<int, string> reversed((std::greater<int>()));
+    trace(reversed.put(1, "one"));
+    trace(reversed.put(2, "two"));
+    reportMessage("FlatMap<int,string> frozen(std::move(reversed));");
+    FlatMap<int, string> frozen(std::move(reversed));
+    test(reversed.isEmpty(), true);
+    trace(frozen.put(3, "three"));
+    test(frozen.toString(), "{3:three, 2:two, 1:one}");
+}
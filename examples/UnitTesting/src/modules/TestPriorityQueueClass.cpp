@@ -27,10 +27,18 @@
 #include <string>
 
 #include "pqueue.h"
+#include "radixpqueue.h"
 #include "strlib.h"
 #include "unittest.h"
+#include "vector.h"
 using namespace std;
 
+/* Prototypes */
+
+static void testHandles();
+static void testBulkOperations();
+static void testRadixPriorityQueue();
+
 void testPriorityQueueClass() {
     declare(PriorityQueue<string> pq);
     test(pq.size(), 0);
@@ -54,5 +62,80 @@ void testPriorityQueueClass() {
     declare(istringstream ss("{3:30, 1:10, 2:20, 1:15}"));
     trace(ss >> intQueue);
     test(intQueue.toString(), "{1:10, 1:15, 2:20, 3:30}");
+    testHandles();
+    testBulkOperations();
+    testRadixPriorityQueue();
     reportResult("PriorityQueue class");
 }
+
+/* Test changing priorities and removing entries through handles */
+
+static void testHandles() {
+    typedef PriorityQueue<string>::Handle Handle;
+    declare(PriorityQueue<string> pq);
+    declare(Handle a = pq.enqueue("A", 5));
+    declare(Handle b = pq.enqueue("B", 3));
+    declare(Handle c = pq.enqueue("C", 4));
+    test(pq.back(), "A");
+    trace(pq.decreaseKey(a, 1));
+    test(pq.peek(), "A");
+    test(pq.back(), "C");
+    trace(pq.changePriority(b, 9));
+    test(pq.back(), "B");
+    test(pq.remove(c), "C");
+    test(pq.contains(c), false);
+    test(pq.contains(a), true);
+    test(pq.toString(), "{1:\"A\", 9:\"B\"}");
+    test(pq.dequeue(), "A");
+    test(pq.contains(a), false);
+    declare(Handle d = pq.enqueue("D", 9));
+    test(pq.contains(a), false);
+    trace(pq.changePriority(d, 9));
+    test(pq.dequeue(), "B");
+    test(pq.dequeue(), "D");
+}
+
+/* Test building a queue from a range and taking several entries at once */
+
+static void testBulkOperations() {
+    typedef pair<double, int> Entry;
+    reportMessage("Vector<pair<double,int>> entries = {{3, 30}, {1, 10}, {2, 20}, {1, 15}};");
+    Vector<Entry> entries = {Entry(3, 30), Entry(1, 10), Entry(2, 20), Entry(1, 15)};
+    declare(PriorityQueue<int> pq(entries.begin(), entries.end()));
+    test(pq.toString(), "{1:10, 1:15, 2:20, 3:30}");
+    test(pq.back(), 30);
+    trace(pq.enqueueAll(entries.begin(), entries.begin() + 2));
+    test(pq.size(), 6);
+    test(pq.dequeueTopK(3).toString(), "{10, 15, 10}");
+    test(pq.toString(), "{2:20, 3:30, 3:30}");
+    test(pq.dequeueTopK(0).isEmpty(), true);
+    test(pq.dequeueTopK(5).toString(), "{20, 30, 30}");
+    test(pq.isEmpty(), true);
+}
+
+/* Test the radix heap with monotone integer priorities */
+
+static void testRadixPriorityQueue() {
+    declare(RadixPriorityQueue<string> pq);
+    trace(pq.enqueue("C", 7));
+    trace(pq.enqueue("A", 2));
+    trace(pq.enqueue("D", 40));
+    trace(pq.enqueue("B", 2));
+    test(pq.peek(), "A");
+    test(pq.peekPriority() == 2, true);
+    test(pq.dequeue(), "A");
+    trace(pq.enqueue("E", 2));
+    trace(pq.enqueue("F", 5));
+    test(pq.toString(), "{2:\"B\", 2:\"E\", 5:\"F\", 7:\"C\", 40:\"D\"}");
+    test(pq.dequeue(), "B");
+    test(pq.dequeue(), "E");
+    test(pq.dequeue(), "F");
+    test(pq.size(), 2);
+    test(pq.dequeue(), "C");
+    test(pq.dequeue(), "D");
+    test(pq.isEmpty(), true);
+    declare(RadixPriorityQueue<int> intQueue);
+    declare(istringstream ss("{3:30, 1:10, 2:20, 1:15}"));
+    trace(ss >> intQueue);
+    test(intQueue.toString(), "{1:10, 1:15, 2:20, 3:30}");
+}
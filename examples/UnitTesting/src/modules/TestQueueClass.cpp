@@ -25,7 +25,9 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
+#include "concurrentqueue.h"
 #include "queue.h"
 #include "strlib.h"
 #include "unittest.h"
@@ -34,6 +36,9 @@ using namespace std;
 static string enqueueTest(Queue<int>& queue, int n);
 static string dequeueTest(Queue<int>& queue, int n);
 static void testQueueCopy(Queue<string>& queue, Queue<string> queueByValue);
+static void testWrapAndGrow();
+static void testConcurrentQueues();
+static string producerTest(int n);
 
 void testQueueClass() {
     declare(Queue<string> queue);
@@ -62,6 +67,8 @@ void testQueueClass() {
     test(intQueue.dequeue(), 2);
     test(intQueue.dequeue(), 3);
     test(intQueue.isEmpty(), true);
+    testWrapAndGrow();
+    testConcurrentQueues();
     reportResult("Queue class");
 }
 
@@ -101,3 +108,77 @@ static void testQueueCopy(Queue<string>& queue, Queue<string> queueByValue) {
     }
     test(elementsByValue == elementsCopy, true);
 }
+
+/* Test growth of a ring buffer whose elements wrap around its end */
+
+static void testWrapAndGrow() {
+    declare(Queue<int> queue);
+    declare(string result);
+    trace(for (int i = 0; i < 12; i++) queue.enqueue(i));
+    trace(for (int i = 0; i < 10; i++) queue.dequeue());
+    trace(for (int i = 12; i < 40; i++) queue.enqueue(i));
+    test(queue.size(), 30);
+    test(queue.peek(), 10);
+    trace(queue.reserve(100));
+    trace(for (int i = 40; i < 50; i++) queue.enqueue(i));
+    trace(while (!queue.isEmpty()) result += integerToString(queue.dequeue()) + " ");
+    test(result.substr(0, 12), "10 11 12 13 ");
+    test(result.substr(result.length() - 6), "48 49 ");
+    trace(queue.enqueue(1));
+    trace(queue.clear());
+    test(queue.isEmpty(), true);
+    trace(queue.enqueue(2));
+    test(queue.toString(), "{2}");
+}
+
+/* Test the lock-free queues */
+
+static void testConcurrentQueues() {
+    declare(SPSCQueue<string> spsc(3));
+    test(spsc.capacity(), 4);
+    test(spsc.tryEnqueue("A"), true);
+    trace(spsc.enqueue("B"));
+    declare(Vector<string> batch);
+    trace(batch += "C");
+    trace(batch += "D");
+    trace(batch += "E");
+    test(spsc.enqueueN(batch.begin(), batch.end()), 2);
+    test(spsc.size(), 4);
+    test(spsc.tryEnqueue("E"), false);
+    test(spsc.peek(), "A");
+    test(spsc.dequeue(), "A");
+    trace(batch.clear());
+    test(spsc.dequeueN(batch, 2), 2);
+    test(batch.toString(), "{\"B\", \"C\"}");
+    declare(string value);
+    test(spsc.tryDequeue(value), true);
+    test(value, "D");
+    test(spsc.tryDequeue(value), false);
+    declare(MPMCQueue<int> mpmc(8));
+    test(mpmc.tryEnqueue(1), true);
+    trace(mpmc.enqueue(2));
+    test(mpmc.size(), 2);
+    test(mpmc.dequeue(), 1);
+    test(mpmc.dequeue(), 2);
+    test(mpmc.isEmpty(), true);
+    reportMessage(producerTest(100000));
+}
+
+static string producerTest(int n) {
+    string callStr = "producerTest(" + integerToString(n) + ")";
+    SPSCQueue<int> queue(64);
+    std::thread producer([&queue, n] {
+        for (int i = 0; i < n; i++) {
+            queue.enqueue(i);
+        }
+    });
+    int mismatch = -1;
+    for (int i = 0; i < n; i++) {
+        if (queue.dequeue() != i && mismatch == -1)
+            mismatch = i;
+    }
+    producer.join();
+    if (mismatch != -1)
+        return callStr + " failed at index " + integerToString(mismatch);
+    return callStr + " succeeded";
+}
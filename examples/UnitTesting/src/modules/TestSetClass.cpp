@@ -22,12 +22,14 @@
 /* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
 /*************************************************************************/
 
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <string>
 
 #include "direction.h"
 #include "filelib.h"
+#include "flatset.h"
 #include "lexicon.h"
 #include "random.h"
 #include "set.h"
@@ -47,6 +49,8 @@ static void testLexiconSet();
 static void testSetIO();
 static void testInsertionOperator();
 static void testExtractionOperator();
+static void testBulkOperations();
+static void testFlatSet();
 static void testSetCopy(Set<char>& set, Set<char> setByValue);
 static string setSignature(Set<char>& set);
 
@@ -55,6 +59,8 @@ void testSetClass() {
     testLexiconSet();
     testInsertionOperator();
     testExtractionOperator();
+    testBulkOperations();
+    testFlatSet();
     reportResult("Set class");
 }
 
@@ -237,3 +243,90 @@ static string setSignature(Set<char>& set) {
     }
     return signature;
 }
+
+/* Test the range constructor and set algebra on sets of unequal size */
+
+static void testBulkOperations() {
+    reportMessage("Vector<int> values = {5, 3, 9, 3, 1};");
+    Vector<int> values = {5, 3, 9, 3, 1};
+    declare(Set<int> small(values.begin(), values.end()));
+    test(small.toString(), "{1, 3, 5, 9}");
+    trace(values.clear());
+    trace(for (int i = 0; i < 100; i += 2) values.add(i));
+    declare(Set<int> evens(values.begin(), values.end()));
+    test(evens.size(), 50);
+    test(evens.first(), 0);
+    test(*evens.rbegin(), 98);
+    test(small.isSubsetOf(evens), false);
+    test((small * evens).isEmpty(), true);
+    test((evens * small).isEmpty(), true);
+    trace(small += 4);
+    test((evens * small).toString(), "{4}");
+    test((small - evens).toString(), "{1, 3, 5, 9}");
+    test((evens - small).size(), 49);
+    test((evens + small).size(), 54);
+    declare(Set<int> mySet = evens);
+    trace(mySet -= small);
+    test(mySet.contains(4), false);
+    trace(mySet *= evens);
+    test(mySet.size(), 49);
+    trace(mySet += evens);
+    test(mySet == evens, true);
+    reportMessage("Set<int> down((greater<int>()));");
+    Set<int> down((greater<int>()));
+    trace(for (int i = 5; i < 15; i++) down.add(i));
+    trace(small.clear());
+    reportMessage("small += 3, 4, 5;");
+    small += 3, 4, 5;
+    trace(values.clear());
+    trace(for (int i = 0; i < 10; i++) values.add(i));
+    declare(Set<int> digits(values.begin(), values.end()));
+    test((digits * down).toString(), "{5, 6, 7, 8, 9}");
+    test((digits + down).toString(), "{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14}");
+    test((digits - down).toString(), "{0, 1, 2, 3, 4}");
+    test((down - digits).toString(), "{14, 13, 12, 11, 10}");
+    test(small.isSubsetOf(digits), true);
+    test(small.isSubsetOf(down), false);
+    trace(down.clear());
+    trace(down += 4);
+    trace(down += 8);
+    test(down.toString(), "{8, 4}");
+    test((evens * down).toString(), "{4, 8}");
+    test((evens - down).size(), 48);
+}
+
+static void testFlatSet() {
+    reportMessage("FlatSet<int> odds = {7, 3, 1, 5, 3};");
+    FlatSet<int> odds = {7, 3, 1, 5, 3};
+    test(odds.toString(), "{1, 3, 5, 7}");
+    reportMessage("Set<int> tree = {2, 3, 4, 5};");
+    Set<int> tree = {2, 3, 4, 5};
+    declare(FlatSet<int> flat(tree));
+    test(flat.contains(4), true);
+    test(flat.contains(6), false);
+    test((odds + flat).toString(), "{1, 2, 3, 4, 5, 7}");
+    test((odds * flat).toString(), "{3, 5}");
+    test((odds - flat).toString(), "{1, 7}");
+    test((odds * flat).isSubsetOf(odds), true);
+    test(odds.isSubsetOf(flat), false);
+    reportMessage("odds += 9, 11;");
+    odds += 9, 11;
+    trace(odds -= 1);
+    test(odds.first(), 3);
+    test(*odds.lowerBound(8), 9);
+    test(*odds.floor(8), 7);
+    test(*odds.rbegin(), 11);
+    trace(flat *= odds);
+    test(flat.toString(), "{3, 5}");
+    reportMessage("FlatSet<int> down((greater<int>()));");
+    FlatSet<int> down((greater<int>()));
+    reportMessage("down += 7, 6, 5, 4, 3;");
+    down += 7, 6, 5, 4, 3;
+    test(down.toString(), "{7, 6, 5, 4, 3}");
+    test((odds + down).toString(), "{3, 4, 5, 6, 7, 9, 11}");
+    test((odds * down).toString(), "{3, 5, 7}");
+    test((odds - down).toString(), "{9, 11}");
+    test((down - odds).toString(), "{6, 4}");
+    test((odds * down).isSubsetOf(down), true);
+    test(down.isSubsetOf(odds), false);
+}
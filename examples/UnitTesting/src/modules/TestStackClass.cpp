@@ -33,6 +33,8 @@ using namespace std;
 
 static void testStackCopy(Stack<int>& stack, Stack<int> stackByValue);
 
+typedef Stack<string, 2> SmallStringStack;
+
 void testStackClass() {
     declare(Stack<int> intStack);
     test(intStack.size(), 0);
@@ -54,6 +56,14 @@ void testStackClass() {
     test(intStack.pop(), 2);
     test(intStack.pop(), 1);
     test(intStack.isEmpty(), true);
+    declare(SmallStringStack smallStack);
+    trace(smallStack.push("a"));
+    trace(smallStack.push("b"));
+    trace(smallStack.push("c"));
+    test(smallStack.toString(), "{\"a\", \"b\", \"c\"}");
+    test(smallStack.pop(), "c");
+    trace(smallStack.clear());
+    test(smallStack.isEmpty(), true);
     reportResult("Stack class");
 }
 
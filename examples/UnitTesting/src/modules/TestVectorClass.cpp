@@ -28,6 +28,8 @@
 #include <string>
 
 #include "direction.h"
+#include "parallelvector.h"
+#include "smallvector.h"
 #include "unittest.h"
 #include "vector.h"
 using namespace std;
@@ -35,6 +37,11 @@ using namespace std;
 static void testInsertionOperator();
 static void testExtractionOperator();
 static void testVectorCopy(Vector<string>& vec, Vector<string> vecByValue);
+static void testMoveAndEmplace();
+static void testCapacity();
+static void testSmallVector();
+static void testRangeOperations();
+static bool isOdd(int n);
 static string vectorSignature(Vector<string>& vec);
 
 class AppendFunctor {
@@ -141,6 +148,10 @@ void testVectorClass() {
     test(digits.toString(), "{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}");
     testInsertionOperator();
     testExtractionOperator();
+    testMoveAndEmplace();
+    testCapacity();
+    testSmallVector();
+    testRangeOperations();
     reportResult("Vector class");
 }
 
@@ -154,6 +165,150 @@ static void testVectorCopy(Vector<string>& vec, Vector<string> vecByValue) {
     test(vectorSignature(vec) == vectorSignature(vecCopy), true);
 }
 
+/* Test move operations and in-place construction */
+
+static void testMoveAndEmplace() {
+    declare(Vector<string> v);
+    test(v.emplace(3, 'x'), "xxx");
+    test(v.emplace("abc"), "abc");
+    test(v.emplaceAt(1, "middle"), "middle");
+    trace(v.emplaceAt(0));
+    test(v.toString(), "{\"\", \"xxx\", \"middle\", \"abc\"}");
+    declare(Vector<string> moved = std::move(v));
+    test(moved.size(), 4);
+    test(v.size(), 0);
+    trace(v.add("again"));
+    test(v.toString(), "{\"again\"}");
+    trace(v = std::move(moved));
+    test(v.size(), 4);
+    test(moved.isEmpty(), true);
+    trace(v.remove(1));
+    test(v.toString(), "{\"\", \"middle\", \"abc\"}");
+    declare(Vector<int> ints);
+    for (int i = 0; i < 100; i++) {
+        ints.insert(0, i);
+    }
+    test(ints[0], 99);
+    test(ints[99], 0);
+}
+
+/* Test reserve, resize, shrinkToFit, and the growth factor */
+
+static void testCapacity() {
+    declare(Vector<string> v);
+    trace(v.reserve(1000));
+    test(v.size(), 0);
+    for (int i = 0; i < 1000; i++) {
+        v.add(integerToString(i));
+    }
+    test(v[999], "999");
+    trace(v.resize(3));
+    test(v.toString(), "{\"0\", \"1\", \"2\"}");
+    trace(v.shrinkToFit());
+    trace(v.resize(5, v[0]));
+    test(v.toString(), "{\"0\", \"1\", \"2\", \"0\", \"0\"}");
+    trace(v.resize(6));
+    test(v[5], "");
+    trace(v.setGrowthFactor(1.5));
+    for (int i = 0; i < 100; i++) {
+        v.insert(3, "x");
+    }
+    test(v.size(), 106);
+    test(v[2], "2");
+    test(v[102], "x");
+    test(v[103], "0");
+    checkError(v.setGrowthFactor(1.0), "Vector::setGrowthFactor: factor must be greater than 1");
+    checkError(v.resize(-1), "Vector::resize: size cannot be negative");
+    trace(v.clear());
+    trace(v.shrinkToFit());
+    test(v.isEmpty(), true);
+}
+
+/* Test SmallVector on both sides of its inline capacity */
+
+typedef SmallVector<string, 4> SmallStringVector;
+
+static void testSmallVector() {
+    declare(SmallStringVector v);
+    test(v.isInline(), true);
+    for (int i = 0; i < 4; i++) {
+        v.add(integerToString(i));
+    }
+    test(v.isInline(), true);
+    trace(v.insert(0, "x"));
+    test(v.isInline(), false);
+    test(v.toString(), "{\"x\", \"0\", \"1\", \"2\", \"3\"}");
+    trace(v.remove(0));
+    trace(v.remove(0));
+    trace(v.shrinkToFit());
+    test(v.isInline(), true);
+    test(vectorSignature(v), "1/2/3");
+    declare(SmallStringVector copy = v);
+    trace(copy.add("4"));
+    test(vectorSignature(copy), "1/2/3/4");
+    test(vectorSignature(v), "1/2/3");
+    declare(Vector<string> moved = std::move(v));
+    test(vectorSignature(moved), "1/2/3");
+    test(v.isEmpty(), true);
+    trace(moved.add("4"));
+    trace(moved.add("5"));
+    trace(v = std::move(moved));
+    test(v.isInline(), false);
+    test(vectorSignature(v), "1/2/3/4/5");
+    trace(v.clear());
+    trace(v.add("a"));
+    test(v.isInline(), true);
+}
+
+/* Test the range forms of insert and remove */
+
+static void testRangeOperations() {
+    declare(Vector<string> v);
+    declare(Vector<string> letters);
+    trace(letters += "a");
+    trace(letters += "b");
+    trace(letters += "c");
+    trace(v.appendAll(letters));
+    trace(v.insertRange(1, letters));
+    test(vectorSignature(v), "a/a/b/c/b/c");
+    trace(v.insertRange(0, v));
+    test(vectorSignature(v), "a/a/b/c/b/c/a/a/b/c/b/c");
+    trace(v.removeRange(2, 8));
+    test(vectorSignature(v), "a/a/b/c");
+    trace(v.removeRange(4, 0));
+    test(vectorSignature(v), "a/a/b/c");
+    trace(v.swapRemove(0));
+    test(vectorSignature(v), "c/a/b");
+    trace(v.appendAll(letters.begin(), letters.end()));
+    test(vectorSignature(v), "c/a/b/a/b/c");
+    checkError(v.removeRange(5, 2), "Vector::removeRange: index of 7 is outside of valid range [0..6]");
+    checkError(v.swapRemove(6), "Vector::swapRemove: index of 6 is outside of valid range [0..5]");
+    declare(Vector<int> ints);
+    for (int i = 0; i < 10; i++) {
+        ints.add(i);
+    }
+    test(ints.removeIf(isOdd), 5);
+    test(ints.toString(), "{0, 2, 4, 6, 8}");
+    declare(Vector<int> front = ints.subList(0, 2));
+    trace(ints.insertRange(2, front.begin(), front.end()));
+    test(ints.toString(), "{0, 2, 0, 2, 4, 6, 8}");
+    test(ints.data()[4], 4);
+    trace(ints.at_unchecked(0) = 1);
+    test(ints[0], 1);
+#ifndef SPL_UNCHECKED_INDEXING
+    checkError(ints[7], "Vector::operator []: index of 7 is outside of valid range [0..6]");
+#endif
+    declare(Vector<int> big(100000, 3));
+    trace(parallelTransform(big, [](int x) { return x * 2; }));
+    declare(long total = 0);
+    trace(big.mapAll([&total](int x) { total += x; }));
+    test(total == 600000, true);
+}
+
+static bool isOdd(int n) {
+    return n % 2 == 1;
+}
+
 static string vectorSignature(Vector<string>& vec) {
     string signature;
     for (int i = 0; i < vec.size(); i++) {
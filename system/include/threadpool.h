@@ -0,0 +1,128 @@
+/*
+ * File: threadpool.h
+ * ------------------
+ * This file exports the <code>ThreadPool</code> class, which runs
+ * loops over index ranges on a fixed set of worker threads.
+ */
+
+#ifndef _threadpool_h
+#define _threadpool_h
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Class: ThreadPool
+ * -----------------
+ * This class keeps a fixed number of threads ready to share the work of
+ * a loop.  The parallel collection operations, such as
+ * <code>parallelTransform</code> in <code>parallelgrid.h</code>, take
+ * the pool as an optional last argument and otherwise use the shared
+ * pool returned by <code>ThreadPool::getDefault</code>.  A client that
+ * wants to limit the number of threads creates its own pool and passes
+ * it in:
+ *
+ *<pre>
+ *    ThreadPool pool(4);
+ *    parallelTransform(grid, brighten, pool);
+ *</pre>
+ */
+
+class ThreadPool {
+public:
+    /*
+     * Constructor: ThreadPool
+     * Usage: ThreadPool pool;
+     *        ThreadPool pool(nThreads);
+     * ---------------------------------
+     * Creates a pool that runs loops on <code>nThreads</code> threads,
+     * counting the thread that starts each loop.  The default is the
+     * number of hardware threads.  A pool of size 1 runs every loop on
+     * the calling thread.
+     */
+
+    explicit ThreadPool(int nThreads = defaultSize());
+
+    /*
+     * Destructor: ~ThreadPool
+     * -----------------------
+     * Stops and joins the worker threads.
+     */
+
+    virtual ~ThreadPool();
+
+    /*
+     * Method: size
+     * Usage: int n = pool.size();
+     * ---------------------------
+     * Returns the number of threads that share each loop.
+     */
+
+    int size() const;
+
+    /*
+     * Method: parallelFor
+     * Usage: pool.parallelFor(n, grain, body);
+     * ----------------------------------------
+     * Divides the indices from 0 up to but not including <code>n</code>
+     * into consecutive chunks of <code>grain</code> indices and calls
+     * <code>body(start, end)</code> once for each chunk, on whichever
+     * thread of the pool is free.  The method returns when every chunk is
+     * done.  If any call to <code>body</code> throws an exception, the
+     * remaining chunks are skipped and the first exception is rethrown
+     * on the calling thread.  A call made from inside another
+     * <code>parallelFor</code> runs on the calling thread.
+     */
+
+    void parallelFor(int n, int grain, const std::function<void(int start, int end)>& body);
+
+    /*
+     * Method: getDefault
+     * Usage: ThreadPool& pool = ThreadPool::getDefault();
+     * ---------------------------------------------------
+     * Returns a pool of the default size shared by the whole program.  It
+     * is created the first time it is requested.
+     */
+
+    static ThreadPool& getDefault();
+
+    /*
+     * Method: defaultSize
+     * Usage: int n = ThreadPool::defaultSize();
+     * -----------------------------------------
+     * Returns the number of hardware threads, or 1 if it is unknown.
+     */
+
+    static int defaultSize();
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    struct Job;
+
+    std::vector<std::thread> workers;
+    std::mutex callLock;             /* Admits one loop at a time        */
+    std::mutex lock;                 /* Guards the fields below          */
+    std::condition_variable wakeup;  /* Signals a new job or shutdown    */
+    std::condition_variable done;    /* Signals that a worker finished   */
+    Job* job;                        /* The loop now running, if any     */
+    long generation;                 /* Number of loops started          */
+    int active;                      /* Workers still on the current job */
+    bool stopping;
+
+    void workerLoop();
+    static void runChunks(Job& job);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * File: threadpool.cpp
+ * --------------------
+ * This file implements the ThreadPool class.
+ */
+
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+/*
+ * Implementation notes: ThreadPool
+ * --------------------------------
+ * Each loop is described by a Job on the stack of the thread that calls
+ * parallelFor.  That thread publishes the job, wakes the workers, and
+ * then claims chunks alongside them.  Chunks are handed out by
+ * incrementing an atomic counter, so threads that finish early simply
+ * take more of them.  The caller waits until every worker has left the
+ * job before returning, which keeps the job alive for as long as any
+ * worker can see it.  The thread-local flag insideLoop makes nested
+ * calls run serially instead of waiting on the pool they are part of.
+ */
+
+struct ThreadPool::Job {
+    const std::function<void(int, int)>* body;
+    int n;
+    int grain;
+    int nChunks;
+    std::atomic<int> nextChunk;
+    std::atomic<bool> failed;
+    std::exception_ptr exception;
+    std::mutex exceptionLock;
+};
+
+static thread_local bool insideLoop = false;
+
+ThreadPool::ThreadPool(int nThreads) {
+    job = nullptr;
+    generation = 0;
+    active = 0;
+    stopping = false;
+    for (int i = 1; i < nThreads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const {
+    return int(workers.size()) + 1;
+}
+
+void ThreadPool::parallelFor(int n, int grain, const std::function<void(int start, int end)>& body) {
+    if (n <= 0)
+        return;
+    grain = std::max(grain, 1);
+    if (insideLoop || workers.empty() || n <= grain) {
+        body(0, n);
+        return;
+    }
+    std::lock_guard<std::mutex> serial(callLock);
+    Job current;
+    current.body = &body;
+    current.n = n;
+    current.grain = grain;
+    current.nChunks = (n - 1) / grain + 1;
+    current.nextChunk = 0;
+    current.failed = false;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        job = &current;
+        active = int(workers.size());
+        generation++;
+    }
+    wakeup.notify_all();
+    insideLoop = true;
+    runChunks(current);
+    insideLoop = false;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [this] { return active == 0; });
+        job = nullptr;
+    }
+    if (current.exception)
+        std::rethrow_exception(current.exception);
+}
+
+ThreadPool& ThreadPool::getDefault() {
+    static ThreadPool pool;
+    return pool;
+}
+
+int ThreadPool::defaultSize() {
+    return std::max(1, int(std::thread::hardware_concurrency()));
+}
+
+void ThreadPool::workerLoop() {
+    insideLoop = true;
+    long seen = 0;
+    while (true) {
+        Job* current;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wakeup.wait(guard, [this, seen] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            current = job;
+        }
+        runChunks(*current);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (--active == 0)
+                done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runChunks(Job& job) {
+    while (!job.failed) {
+        int chunk = job.nextChunk++;
+        if (chunk >= job.nChunks)
+            return;
+        int start = chunk * job.grain;
+        int end = std::min(job.n, start + job.grain);
+        try {
+            (*job.body)(start, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(job.exceptionLock);
+            if (!job.exception)
+                job.exception = std::current_exception();
+            job.failed = true;
+        }
+    }
+}